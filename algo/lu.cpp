@@ -0,0 +1,187 @@
+#include "lu.hpp"
+#include "algorithms.hpp"
+#include "timer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace matmul {
+namespace lu {
+
+static PhaseAccumulator panel_phase("LU panels");
+
+namespace {
+
+// Updates below this many multiply-adds stay in a direct loop: copying the
+// operands out and calling an engine (an MPI collective, possibly) costs more
+const double DIRECT_LIMIT = 64.0 * 64.0 * 64.0;
+
+struct Context {
+    Config config;   // Engine for the updates
+    int base;
+    Stats* stats;
+};
+
+// C[cr.., cc..] (m x n) -= A[ar.., ac..] (m x k) * B[br.., bc..] (k x n)
+void update(Context& ctx, Matrix& C, int cr, int cc, const Matrix& A, int ar, int ac,
+            const Matrix& B, int br, int bc, int m, int k, int n) {
+    if (m == 0 || n == 0 || k == 0) return;
+
+    if (static_cast<double>(m) * n * k < DIRECT_LIMIT) {
+        for (int i = 0; i < m; ++i) {
+            double* c = &C(cr + i, cc);
+            for (int p = 0; p < k; ++p) {
+                double a = A(ar + i, ac + p);
+                const double* b = &B(br + p, bc);
+                for (int j = 0; j < n; ++j) c[j] -= a * b[j];
+            }
+        }
+        return;
+    }
+
+    Matrix As = A.submatrix(ar, ac, ar + m, ac + k);
+    Matrix Bs = B.submatrix(br, bc, br + k, bc + n);
+    Config config = ctx.config;
+    if (config.algorithm == Algorithm::STRASSEN && !(m == k && k == n)) {
+        config.algorithm = Algorithm::NAIVE;  // Strassen takes square operands only
+    }
+
+    Timer timer;
+    timer.start();
+    Matrix P = multiply(As, Bs, config);
+    timer.stop();
+    if (ctx.stats) {
+        ctx.stats->gemm_seconds += timer.elapsed_seconds();
+        ctx.stats->gemm_flops += 2.0 * m * n * k;
+        ctx.stats->gemm_calls++;
+    }
+
+    for (int i = 0; i < m; ++i) {
+        double* c = &C(cr + i, cc);
+        const double* p = &P(i, 0);
+        for (int j = 0; j < n; ++j) c[j] -= p[j];
+    }
+}
+
+// Solve L X = B in place for the n x n unit lower triangle at L[lr.., lc..]
+// and the n x nrhs block at X[xr.., xc..]
+void trsm_lower_unit(Context& ctx, const Matrix& L, int lr, int lc, int n, Matrix& X, int xr, int xc,
+                     int nrhs) {
+    if (n <= ctx.base) {
+        for (int i = 1; i < n; ++i) {
+            double* x = &X(xr + i, xc);
+            for (int r = 0; r < i; ++r) {
+                double l = L(lr + i, lc + r);
+                const double* y = &X(xr + r, xc);
+                for (int j = 0; j < nrhs; ++j) x[j] -= l * y[j];
+            }
+        }
+        return;
+    }
+    int n1 = n / 2, n2 = n - n1;
+    trsm_lower_unit(ctx, L, lr, lc, n1, X, xr, xc, nrhs);
+    update(ctx, X, xr + n1, xc, L, lr + n1, lc, X, xr, xc, n2, n1, nrhs);
+    trsm_lower_unit(ctx, L, lr + n1, lc + n1, n2, X, xr + n1, xc, nrhs);
+}
+
+// Solve U X = B in place for the n x n upper triangle at U[ur.., uc..]
+void trsm_upper(Context& ctx, const Matrix& U, int ur, int uc, int n, Matrix& X, int xr, int xc,
+                int nrhs) {
+    if (n <= ctx.base) {
+        for (int i = n - 1; i >= 0; --i) {
+            double* x = &X(xr + i, xc);
+            for (int r = i + 1; r < n; ++r) {
+                double u = U(ur + i, uc + r);
+                const double* y = &X(xr + r, xc);
+                for (int j = 0; j < nrhs; ++j) x[j] -= u * y[j];
+            }
+            double d = U(ur + i, uc + i);
+            for (int j = 0; j < nrhs; ++j) x[j] /= d;
+        }
+        return;
+    }
+    int n1 = n / 2, n2 = n - n1;
+    trsm_upper(ctx, U, ur + n1, uc + n1, n2, X, xr + n1, xc, nrhs);
+    update(ctx, X, xr, xc, U, ur, uc + n1, X, xr + n1, xc, n1, n2, nrhs);
+    trsm_upper(ctx, U, ur, uc, n1, X, xr, xc, nrhs);
+}
+
+// Factor columns [j0, j0 + n) of rows [j0, N) of M. Row swaps are applied
+// across whole rows, so columns to the right see them before their update
+// and the finished L columns to the left stay consistent.
+void factor_columns(Context& ctx, Matrix& M, std::vector<int>& swaps, int j0, int n) {
+    int N = M.rows();
+
+    if (n <= ctx.base) {
+        ScopedTimer timed(panel_phase);
+        for (int j = j0; j < j0 + n; ++j) {
+            int p = j;
+            for (int i = j + 1; i < N; ++i) {
+                if (std::fabs(M(i, j)) > std::fabs(M(p, j))) p = i;
+            }
+            if (M(p, j) == 0.0) {
+                throw std::runtime_error("Matrix is singular (zero pivot in column " + std::to_string(j) + ")");
+            }
+            swaps[j] = p;
+            if (p != j) std::swap_ranges(&M(j, 0), &M(j, 0) + M.cols(), &M(p, 0));
+
+            double inv = 1.0 / M(j, j);
+            for (int i = j + 1; i < N; ++i) {
+                double l = M(i, j) *= inv;
+                double* row = &M(i, 0);
+                const double* pivot_row = &M(j, 0);
+                for (int c = j + 1; c < j0 + n; ++c) row[c] -= l * pivot_row[c];
+            }
+        }
+        return;
+    }
+
+    int n1 = n / 2, n2 = n - n1;
+    factor_columns(ctx, M, swaps, j0, n1);
+    // A12 = L11^-1 A12, then the Schur complement A22 -= A21 * A12
+    trsm_lower_unit(ctx, M, j0, j0, n1, M, j0, j0 + n1, n2);
+    update(ctx, M, j0 + n1, j0 + n1, M, j0 + n1, j0, M, j0, j0 + n1, N - j0 - n1, n1, n2);
+    factor_columns(ctx, M, swaps, j0 + n1, n2);
+}
+
+} // namespace
+
+Factorization factor(const Matrix& A, const Config& config, int base, Stats* stats) {
+    if (!A.is_square()) {
+        throw std::runtime_error("LU factorization needs a square matrix");
+    }
+    Context ctx{config, std::max(base, 1), stats};
+
+    Factorization f;
+    f.lu = A;
+    int N = A.rows();
+    std::vector<int> swaps(N);
+    factor_columns(ctx, f.lu, swaps, 0, N);
+
+    // Sequential swaps -> permutation: row i of P A is row pivots[i] of A
+    f.pivots.resize(N);
+    std::iota(f.pivots.begin(), f.pivots.end(), 0);
+    for (int j = 0; j < N; ++j) std::swap(f.pivots[j], f.pivots[swaps[j]]);
+    return f;
+}
+
+Matrix solve(const Factorization& f, const Matrix& B, const Config& config, Stats* stats) {
+    int N = f.lu.rows();
+    if (B.rows() != N) {
+        throw std::runtime_error("Right-hand side has the wrong number of rows");
+    }
+    Context ctx{config, 32, stats};
+
+    int nrhs = B.cols();
+    Matrix X = Matrix::uninitialized(N, nrhs);
+    for (int i = 0; i < N; ++i) {
+        std::copy(&B(f.pivots[i], 0), &B(f.pivots[i], 0) + nrhs, &X(i, 0));
+    }
+    trsm_lower_unit(ctx, f.lu, 0, 0, N, X, 0, 0, nrhs);
+    trsm_upper(ctx, f.lu, 0, 0, N, X, 0, 0, nrhs);
+    return X;
+}
+
+} // namespace lu
+} // namespace matmul
@@ -1,12 +1,20 @@
 #include "algorithms.hpp"
+#include "checkpoint.hpp"
+#include "comm.hpp"
+#include "overlap.hpp"
+#include "partition.hpp"
+#include "timer.hpp"
 #include <mpi.h>
 #include <omp.h>
+#include <algorithm>
+#include <iostream>
 #include <stdexcept>
 
 namespace matmul {
 namespace naive {
 
-Matrix hybrid(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads) {
+Matrix hybrid(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads,
+              const DistributedOptions& dist) {
     if (A.cols() != B.rows()) {
         throw std::runtime_error("Matrix dimensions incompatible for multiplication");
     }
@@ -17,85 +25,71 @@ Matrix hybrid(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    int m = A.rows();
+    int m = partition::global_rows(A, dist);
     int n = B.cols();
     int k = A.cols();
 
-    // Calculate rows per process
-    int rows_per_proc = m / size;
-    int remainder = m % size;
-    int local_rows = rows_per_proc + (rank < remainder ? 1 : 0);
-    int row_offset = rank * rows_per_proc + std::min(rank, remainder);
-
-    // Broadcast matrix B to all processes
-    Matrix B_local = B;
-
-    // Create local portion of A
-    Matrix A_local(local_rows, k);
-    for (int i = 0; i < local_rows; ++i) {
-        for (int j = 0; j < k; ++j) {
-            A_local(i, j) = A(row_offset + i, j);
+    // Split rows across processes (equal, or by measured per-rank speed)
+    partition::RowPartition part = partition::for_engine(m, opt, num_threads, dist);
+    int local_rows = part.local_rows(rank);
+    int row_offset = part.row_offset(rank);
+
+    // B is already replicated on every rank (broadcast by the caller)
+    const Matrix& B_local = B;
+
+    // Local portion of A: a view of this rank's rows, no copy
+    const ConstMatrixView A_local = partition::local_rows_of(A, part, rank, dist);
+
+    // Dedicated communication thread: tiles are exchanged while the other
+    // threads keep computing (C is assembled in place, no final gather)
+    if (dist.comm_thread) {
+        bool plain_comm = dist.checkpoint_dir.empty() && dist.precision == CommPrecision::FP64 &&
+                          dist.compression == CompressionMode::OFF;
+        if (overlap::available(dist) && plain_comm) {
+            int compute_threads = std::max(1, num_threads - 1);
+            int tile_rows = overlap::tile_rows_for(part, compute_threads, opt.block_size);
+
+            Matrix C(m, n);
+            Matrix C_stripe = Matrix::view(C.data() + static_cast<size_t>(row_offset) * n,
+                                           local_rows, n);
+            double compute_seconds = overlap::compute_and_allgather(
+                C, part, tile_rows, compute_threads,
+                [&](int row_begin, int row_end) {
+                    naive::sequential_rows(A_local, B_local, opt, C_stripe, row_begin, row_end);
+                }, dist);
+            partition::record(local_rows, compute_seconds, n, k, dist);
+            return C;
+        }
+        if (rank == 0) {
+            std::cerr << "Warning: --comm-thread needs MPI_THREAD_FUNNELED, more than one rank and "
+                      << "no checkpoint/compression/reduced precision; using the regular path\n";
         }
     }
 
-    // Compute local result with OpenMP parallelization
+    // Compute local result one tile of rows at a time (checkpointed if requested)
     Matrix C_local(local_rows, n);
-    C_local.zero();
-
-    if (opt.cache_friendly && opt.use_blocking) {
-        int block_size = opt.block_size;
-
-        #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (int ii = 0; ii < local_rows; ii += block_size) {
-            for (int jj = 0; jj < n; jj += block_size) {
-                for (int kk = 0; kk < k; kk += block_size) {
-                    int i_max = std::min(ii + block_size, local_rows);
-                    int j_max = std::min(jj + block_size, n);
-                    int k_max = std::min(kk + block_size, k);
-
-                    for (int i = ii; i < i_max; ++i) {
-                        for (int j = jj; j < j_max; ++j) {
-                            double sum = C_local(i, j);
-                            for (int kk_inner = kk; kk_inner < k_max; ++kk_inner) {
-                                sum += A_local(i, kk_inner) * B_local(kk_inner, j);
-                            }
-                            C_local(i, j) = sum;
-                        }
-                    }
-                }
-            }
-        }
-    } else {
-        #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (int i = 0; i < local_rows; ++i) {
-            for (int j = 0; j < n; ++j) {
-                double sum = 0.0;
-                for (int ki = 0; ki < k; ++ki) {
-                    sum += A_local(i, ki) * B_local(ki, j);
-                }
-                C_local(i, j) = sum;
-            }
-        }
-    }
+    Timer compute_timer;
+    compute_timer.start();
+    int computed_rows = checkpoint::compute_tiles(C_local, A_local, B_local, row_offset,
+                                                  opt.block_size, dist,
+                                                  [&](int row_begin, int row_end) {
+        naive::openmp_rows(A_local, B_local, opt, C_local, row_begin, row_end, num_threads);
+    });
+    compute_timer.stop();
+    partition::record(computed_rows, compute_timer.elapsed_seconds(), n, k, dist);
 
     // Gather results
     Matrix C(m, n);
     C.zero();
 
     // Prepare send counts and displacements
-    std::vector<int> sendcounts(size);
-    std::vector<int> displs(size);
-
-    for (int i = 0; i < size; ++i) {
-        int proc_rows = rows_per_proc + (i < remainder ? 1 : 0);
-        sendcounts[i] = proc_rows * n;
-        displs[i] = (i * rows_per_proc + std::min(i, remainder)) * n;
-    }
+    std::vector<int> sendcounts;
+    std::vector<int> displs;
+    part.counts(n, sendcounts, displs);
 
     // Gather all local results
-    MPI_Allgatherv(C_local.data(), local_rows * n, MPI_DOUBLE,
-                   C.data(), sendcounts.data(), displs.data(),
-                   MPI_DOUBLE, MPI_COMM_WORLD);
+    comm::allgatherv(C_local.data(), local_rows * n, C.data(), sendcounts, displs,
+                     MPI_COMM_WORLD, dist);
 
     return C;
 }
@@ -1,33 +1,44 @@
 #include "algorithms.hpp"
+#include "timer.hpp"
 #include <omp.h>
+#include <algorithm>
 #include <stdexcept>
 
 namespace matmul {
 namespace naive {
 
-Matrix openmp(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads) {
-    if (A.cols() != B.rows()) {
+static PhaseAccumulator kernel_phase("OMP kernel");
+
+void openmp_rows(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
+                 Matrix& C, int row_begin, int row_end, int num_threads) {
+    if (A.cols() != B.rows() || C.rows() != A.rows() || C.cols() != B.cols()) {
         throw std::runtime_error("Matrix dimensions incompatible for multiplication");
     }
+    ScopedTimer timed(kernel_phase);
 
     omp_set_num_threads(num_threads);
 
-    int m = A.rows();
+    if (opt.packed) {
+        packed_rows(A, B, opt, C, row_begin, row_end, num_threads);
+        return;
+    }
+
     int n = B.cols();
     int k = A.cols();
 
-    Matrix C(m, n);
-    C.zero();
-
     if (opt.cache_friendly && opt.use_blocking) {
+        // Blocks accumulate into C, so start from zero
+        std::fill(C.data() + static_cast<size_t>(row_begin) * n,
+                  C.data() + static_cast<size_t>(row_end) * n, 0.0);
+
         // Cache-friendly blocked implementation with OpenMP
         int block_size = opt.block_size;
 
         #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (int ii = 0; ii < m; ii += block_size) {
+        for (int ii = row_begin; ii < row_end; ii += block_size) {
             for (int jj = 0; jj < n; jj += block_size) {
                 for (int kk = 0; kk < k; kk += block_size) {
-                    int i_max = std::min(ii + block_size, m);
+                    int i_max = std::min(ii + block_size, row_end);
                     int j_max = std::min(jj + block_size, n);
                     int k_max = std::min(kk + block_size, k);
 
@@ -46,7 +57,7 @@ Matrix openmp(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
     } else {
         // Standard implementation with OpenMP parallelization
         #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (int i = 0; i < m; ++i) {
+        for (int i = row_begin; i < row_end; ++i) {
             for (int j = 0; j < n; ++j) {
                 double sum = 0.0;
                 for (int ki = 0; ki < k; ++ki) {
@@ -56,7 +67,15 @@ Matrix openmp(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
             }
         }
     }
+}
+
+Matrix openmp(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads) {
+    if (A.cols() != B.rows()) {
+        throw std::runtime_error("Matrix dimensions incompatible for multiplication");
+    }
 
+    Matrix C(A.rows(), B.cols());
+    openmp_rows(A, B, opt, C, 0, A.rows(), num_threads);
     return C;
 }
 
@@ -0,0 +1,203 @@
+#include "algorithms.hpp"
+#include <omp.h>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#if defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+namespace matmul {
+namespace naive {
+
+namespace {
+
+// Register tile (MR x NR accumulators) and cache blocks: an MC x K block of
+// A stays packed for a whole row block, a KC x NC panel of B fits in L2
+// next to the MC x NC tile of C being accumulated
+const int MR = 6;
+const int NR = 8;
+const int MC = 120;
+const int KC = 256;
+const int NC = 256;
+
+struct FreeDeleter {
+    void operator()(double* p) const { std::free(p); }
+};
+using Buffer = std::unique_ptr<double, FreeDeleter>;
+
+Buffer allocate(size_t count) {
+    void* p = std::aligned_alloc(64, (count * sizeof(double) + 63) / 64 * 64);
+    if (p == nullptr) throw std::bad_alloc();
+    return Buffer(static_cast<double*>(p));
+}
+
+inline void prefetch(const double* p) {
+    __builtin_prefetch(p, 0, 3);
+}
+
+// Rows [i0, i0 + mc) of A, all k columns, as MR-row micro-panels: element
+// (i, p) of micro-panel r is at dst[(r * k + p) * MR + i]. Rows past mc are
+// zero. With prefetch, the line `distance` lines ahead in each source row is
+// requested while the current line is copied.
+void pack_A(const Matrix& A, int i0, int mc, double* dst, int distance) {
+    int k = A.cols();
+    for (int r = 0; r < mc; r += MR) {
+        int rows = std::min(MR, mc - r);
+        double* panel = dst + static_cast<size_t>(r) * k;
+        for (int p = 0; p < k; ++p) {
+            if (distance > 0 && p % 8 == 0 && p + 8 * distance < k) {
+                for (int i = 0; i < rows; ++i) prefetch(&A(i0 + r + i, p + 8 * distance));
+            }
+            for (int i = 0; i < rows; ++i) panel[p * MR + i] = A(i0 + r + i, p);
+            for (int i = rows; i < MR; ++i) panel[p * MR + i] = 0.0;
+        }
+    }
+}
+
+// B[p0 .. p0 + kc, j0 .. j0 + nc) as NR-column micro-panels: element (p, j)
+// of micro-panel c is at dst[(c * kc + p) * NR + j]; columns past nc are
+// zero. With prefetch, row p + distance of B is requested while row p is
+// copied, which runs into the next panel's rows near the end.
+void pack_B(const Matrix& B, int p0, int kc, int j0, int nc, double* dst, int distance) {
+    int k = B.rows();
+    for (int p = 0; p < kc; ++p) {
+        if (distance > 0 && p0 + p + distance < k) {
+            const double* ahead = &B(p0 + p + distance, j0);
+            for (int j = 0; j < nc; j += 8) prefetch(ahead + j);
+        }
+        const double* row = &B(p0 + p, j0);
+        for (int c = 0; c < nc; c += NR) {
+            int cols = std::min(NR, nc - c);
+            double* out = dst + (static_cast<size_t>(c) * kc + static_cast<size_t>(p) * NR);
+            for (int j = 0; j < cols; ++j) out[j] = row[c + j];
+            for (int j = cols; j < NR; ++j) out[j] = 0.0;
+        }
+    }
+}
+
+// tile (MR x NR, row stride ldt) = (first ? 0 : tile) + a * b over kc steps
+inline void micro_kernel(int kc, const double* a, const double* b, double* tile, int ldt, bool first) {
+    double acc[MR][NR] = {};
+    for (int p = 0; p < kc; ++p) {
+        for (int i = 0; i < MR; ++i) {
+            double ai = a[p * MR + i];
+            #pragma omp simd
+            for (int j = 0; j < NR; ++j) acc[i][j] += ai * b[p * NR + j];
+        }
+    }
+    for (int i = 0; i < MR; ++i) {
+        double* t = tile + static_cast<size_t>(i) * ldt;
+        if (first) {
+            for (int j = 0; j < NR; ++j) t[j] = acc[i][j];
+        } else {
+            for (int j = 0; j < NR; ++j) t[j] += acc[i][j];
+        }
+    }
+}
+
+// Copy a finished row of a tile to C. Streaming stores write whole lines
+// without reading them first (no read-for-ownership) and keep C out of the
+// cache; the unaligned head and the tail use ordinary stores.
+void store_row(double* dst, const double* src, int count, bool streaming) {
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__)
+    if (streaming) {
+#if defined(__AVX512F__)
+        const int W = 8;
+#elif defined(__AVX__)
+        const int W = 4;
+#else
+        const int W = 2;
+#endif
+        int j = 0;
+        while (j < count && reinterpret_cast<uintptr_t>(dst + j) % (W * sizeof(double)) != 0) {
+            dst[j] = src[j];
+            ++j;
+        }
+        for (; j + W <= count; j += W) {
+#if defined(__AVX512F__)
+            _mm512_stream_pd(dst + j, _mm512_loadu_pd(src + j));
+#elif defined(__AVX__)
+            _mm256_stream_pd(dst + j, _mm256_loadu_pd(src + j));
+#else
+            _mm_stream_pd(dst + j, _mm_loadu_pd(src + j));
+#endif
+        }
+        for (; j < count; ++j) dst[j] = src[j];
+        return;
+    }
+#else
+    (void)streaming;
+#endif
+    std::copy(src, src + count, dst);
+}
+
+// C rows [i0, i0 + mc): every MC x NC tile is accumulated over all of k in
+// a private buffer and written to C exactly once
+void row_block(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, Matrix& C,
+               int i0, int mc, double* a_pack, double* b_pack, double* tile) {
+    int k = A.cols();
+    int n = B.cols();
+    int distance = opt.prefetch_distance;
+    const int ldt = NC;
+
+    pack_A(A, i0, mc, a_pack, distance);
+
+    for (int j0 = 0; j0 < n; j0 += NC) {
+        int nc = std::min(NC, n - j0);
+        for (int p0 = 0; p0 < k; p0 += KC) {
+            int kc = std::min(KC, k - p0);
+            pack_B(B, p0, kc, j0, nc, b_pack, distance);
+            for (int r = 0; r < mc; r += MR) {
+                const double* a = a_pack + static_cast<size_t>(r) * k + static_cast<size_t>(p0) * MR;
+                for (int c = 0; c < nc; c += NR) {
+                    micro_kernel(kc, a, b_pack + static_cast<size_t>(c) * kc,
+                                 tile + static_cast<size_t>(r) * ldt + c, ldt, p0 == 0);
+                }
+            }
+        }
+        for (int i = 0; i < mc; ++i) {
+            store_row(&C(i0 + i, j0), tile + static_cast<size_t>(i) * ldt, nc, opt.streaming_stores);
+        }
+    }
+}
+
+} // namespace
+
+void packed_rows(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
+                 Matrix& C, int row_begin, int row_end, int num_threads) {
+    int k = A.cols();
+    if (row_end <= row_begin || B.cols() == 0) return;
+    if (k == 0) {
+        std::fill(C.data() + static_cast<size_t>(row_begin) * C.cols(),
+                  C.data() + static_cast<size_t>(row_end) * C.cols(), 0.0);
+        return;
+    }
+
+    int mc_pad = (MC + MR - 1) / MR * MR;
+    int blocks = (row_end - row_begin + MC - 1) / MC;
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        Buffer a_pack = allocate(static_cast<size_t>(mc_pad) * k);
+        Buffer b_pack = allocate(static_cast<size_t>(KC) * NC);
+        Buffer tile = allocate(static_cast<size_t>(mc_pad) * NC);
+
+        #pragma omp for schedule(dynamic, 1) nowait
+        for (int b = 0; b < blocks; ++b) {
+            int i0 = row_begin + b * MC;
+            int mc = std::min(MC, row_end - i0);
+            row_block(A, B, opt, C, i0, mc, a_pack.get(), b_pack.get(), tile.get());
+        }
+
+#if defined(__SSE2__)
+        // Streaming stores are weakly ordered: drain each thread's before the join
+        if (opt.streaming_stores) _mm_sfence();
+#endif
+    }
+}
+
+} // namespace naive
+} // namespace matmul
@@ -1,30 +1,41 @@
 #include "algorithms.hpp"
+#include "timer.hpp"
+#include <algorithm>
 #include <stdexcept>
 
 namespace matmul {
 namespace naive {
 
-Matrix sequential(const Matrix& A, const Matrix& B, const OptimizationOptions& opt) {
-    if (A.cols() != B.rows()) {
+static PhaseAccumulator kernel_phase("Naive kernel");
+
+void sequential_rows(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
+                     Matrix& C, int row_begin, int row_end) {
+    if (A.cols() != B.rows() || C.rows() != A.rows() || C.cols() != B.cols()) {
         throw std::runtime_error("Matrix dimensions incompatible for multiplication");
     }
+    ScopedTimer timed(kernel_phase);
+
+    if (opt.packed) {
+        packed_rows(A, B, opt, C, row_begin, row_end, 1);
+        return;
+    }
 
-    int m = A.rows();
     int n = B.cols();
     int k = A.cols();
 
-    Matrix C(m, n);
-    C.zero();
-
     if (opt.cache_friendly && opt.use_blocking) {
+        // Blocks accumulate into C, so start from zero
+        std::fill(C.data() + static_cast<size_t>(row_begin) * n,
+                  C.data() + static_cast<size_t>(row_end) * n, 0.0);
+
         // Cache-friendly blocked implementation
         int block_size = opt.block_size;
 
-        for (int ii = 0; ii < m; ii += block_size) {
+        for (int ii = row_begin; ii < row_end; ii += block_size) {
             for (int jj = 0; jj < n; jj += block_size) {
                 for (int kk = 0; kk < k; kk += block_size) {
                     // Compute block
-                    int i_max = std::min(ii + block_size, m);
+                    int i_max = std::min(ii + block_size, row_end);
                     int j_max = std::min(jj + block_size, n);
                     int k_max = std::min(kk + block_size, k);
 
@@ -42,7 +53,7 @@ Matrix sequential(const Matrix& A, const Matrix& B, const OptimizationOptions& o
         }
     } else {
         // Standard ijk order
-        for (int i = 0; i < m; ++i) {
+        for (int i = row_begin; i < row_end; ++i) {
             for (int j = 0; j < n; ++j) {
                 double sum = 0.0;
                 for (int ki = 0; ki < k; ++ki) {
@@ -52,7 +63,15 @@ Matrix sequential(const Matrix& A, const Matrix& B, const OptimizationOptions& o
             }
         }
     }
+}
+
+Matrix sequential(const Matrix& A, const Matrix& B, const OptimizationOptions& opt) {
+    if (A.cols() != B.rows()) {
+        throw std::runtime_error("Matrix dimensions incompatible for multiplication");
+    }
 
+    Matrix C(A.rows(), B.cols());
+    sequential_rows(A, B, opt, C, 0, A.rows());
     return C;
 }
 
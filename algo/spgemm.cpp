@@ -0,0 +1,221 @@
+#include "algorithms.hpp"
+#include "timer.hpp"
+#include <omp.h>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace matmul {
+namespace spgemm {
+
+// Rows with at least cols / DENSE_FRACTION products use the dense accumulator;
+// below that, clearing and scanning a cols-long array costs more than hashing
+static const int DENSE_FRACTION = 16;
+
+namespace {
+
+// Open-addressing table keyed by column (linear probing), sized per row to
+// twice its product count so probes stay short
+class HashAccumulator {
+public:
+    void reset(int64_t products) {
+        size_t size = 16;
+        while (size < static_cast<size_t>(2 * products)) size <<= 1;
+        if (keys_.size() < size) {
+            keys_.resize(size);
+            values_.resize(size);
+        }
+        mask_ = size - 1;
+        std::fill(keys_.begin(), keys_.begin() + size, -1);
+        used_.clear();
+    }
+
+    void add(int col, double value) {
+        size_t slot = (static_cast<size_t>(col) * 2654435761u) & mask_;
+        while (keys_[slot] != col) {
+            if (keys_[slot] == -1) {
+                keys_[slot] = col;
+                values_[slot] = 0.0;
+                used_.push_back(slot);
+                break;
+            }
+            slot = (slot + 1) & mask_;
+        }
+        values_[slot] += value;
+    }
+
+    // Write the row in ascending column order
+    void emit(int* cols, double* values) {
+        entries_.clear();
+        for (size_t slot : used_) entries_.emplace_back(keys_[slot], values_[slot]);
+        std::sort(entries_.begin(), entries_.end());
+        for (size_t e = 0; e < entries_.size(); ++e) {
+            cols[e] = entries_[e].first;
+            values[e] = entries_[e].second;
+        }
+    }
+
+private:
+    std::vector<int> keys_;
+    std::vector<double> values_;
+    std::vector<size_t> used_;
+    std::vector<std::pair<int, double>> entries_;
+    size_t mask_ = 0;
+};
+
+// Dense sparse accumulator (SPA): one slot per column of B, with a marker
+// recording which row last touched it, so it is never cleared between rows
+class DenseAccumulator {
+public:
+    void reset(int cols, int row) {
+        if (static_cast<int>(marker_.size()) < cols) {
+            marker_.assign(cols, -1);
+            values_.resize(cols);
+        }
+        row_ = row;
+        touched_.clear();
+    }
+
+    void add(int col, double value) {
+        if (marker_[col] != row_) {
+            marker_[col] = row_;
+            values_[col] = value;
+            touched_.push_back(col);
+        } else {
+            values_[col] += value;
+        }
+    }
+
+    void emit(int* cols, double* values) {
+        std::sort(touched_.begin(), touched_.end());
+        for (size_t e = 0; e < touched_.size(); ++e) {
+            cols[e] = touched_[e];
+            values[e] = values_[touched_[e]];
+        }
+    }
+
+private:
+    std::vector<int> marker_;
+    std::vector<double> values_;
+    std::vector<int> touched_;
+    int row_ = -1;
+};
+
+// Number of distinct columns in row i of A * B. marker holds, per column of
+// B, the last row that touched it, so only column indices are read and the
+// array is never cleared between rows.
+int64_t count_row(const CsrMatrix& A, const CsrMatrix& B, int i, std::vector<int>& marker) {
+    int64_t count = 0;
+    for (int64_t p = A.row_ptr[i]; p < A.row_ptr[i + 1]; ++p) {
+        int k = A.col_idx[p];
+        for (int64_t q = B.row_ptr[k]; q < B.row_ptr[k + 1]; ++q) {
+            int col = B.col_idx[q];
+            if (marker[col] != i) {
+                marker[col] = i;
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+// Feed row i of A * B into acc
+template <typename Accumulator>
+void accumulate_row(const CsrMatrix& A, const CsrMatrix& B, int i, Accumulator& acc) {
+    for (int64_t p = A.row_ptr[i]; p < A.row_ptr[i + 1]; ++p) {
+        int k = A.col_idx[p];
+        double a = A.values[p];
+        for (int64_t q = B.row_ptr[k]; q < B.row_ptr[k + 1]; ++q) {
+            acc.add(B.col_idx[q], a * B.values[q]);
+        }
+    }
+}
+
+} // namespace
+
+CsrMatrix multiply(const CsrMatrix& A, const CsrMatrix& B, int num_threads, Stats* stats) {
+    if (A.cols != B.rows) {
+        throw std::runtime_error("Matrix dimensions incompatible for multiplication");
+    }
+
+    int m = A.rows;
+    CsrMatrix C(m, B.cols);
+    std::vector<int64_t> products(m);
+    int64_t dense_threshold = std::max<int64_t>(B.cols / DENSE_FRACTION, 1);
+    int hash_rows = 0;
+    int dense_rows = 0;
+    int64_t flops = 0;
+
+    Timer timer;
+    timer.start();
+
+    // Symbolic: nonzeros per row of C from the column structure alone. The
+    // number of products (an upper bound) picks the numeric accumulator.
+    #pragma omp parallel num_threads(num_threads) reduction(+:hash_rows, dense_rows, flops)
+    {
+        std::vector<int> marker(B.cols, -1);
+
+        #pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < m; ++i) {
+            int64_t count = 0;
+            for (int64_t p = A.row_ptr[i]; p < A.row_ptr[i + 1]; ++p) {
+                int k = A.col_idx[p];
+                count += B.row_ptr[k + 1] - B.row_ptr[k];
+            }
+            products[i] = count;
+            flops += count;
+            C.row_ptr[i + 1] = count_row(A, B, i, marker);
+            if (count >= dense_threshold) {
+                dense_rows++;
+            } else {
+                hash_rows++;
+            }
+        }
+    }
+
+    for (int i = 0; i < m; ++i) {
+        C.row_ptr[i + 1] += C.row_ptr[i];
+    }
+    C.col_idx.resize(C.nnz());
+    C.values.resize(C.nnz());
+
+    timer.stop();
+    double symbolic_seconds = timer.elapsed_seconds();
+    timer.start();
+
+    // Numeric: the same accumulation, written straight into C's row
+    #pragma omp parallel num_threads(num_threads)
+    {
+        HashAccumulator hash;
+        DenseAccumulator dense;
+
+        #pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < m; ++i) {
+            int* cols = C.col_idx.data() + C.row_ptr[i];
+            double* values = C.values.data() + C.row_ptr[i];
+            if (products[i] >= dense_threshold) {
+                dense.reset(B.cols, i);
+                accumulate_row(A, B, i, dense);
+                dense.emit(cols, values);
+            } else {
+                hash.reset(products[i]);
+                accumulate_row(A, B, i, hash);
+                hash.emit(cols, values);
+            }
+        }
+    }
+
+    timer.stop();
+
+    if (stats) {
+        stats->symbolic_seconds = symbolic_seconds;
+        stats->numeric_seconds = timer.elapsed_seconds();
+        stats->flops = flops;
+        stats->hash_rows = hash_rows;
+        stats->dense_rows = dense_rows;
+    }
+    return C;
+}
+
+} // namespace spgemm
+} // namespace matmul
@@ -1,4 +1,8 @@
 #include "algorithms.hpp"
+#include "checkpoint.hpp"
+#include "comm.hpp"
+#include "partition.hpp"
+#include "timer.hpp"
 #include <mpi.h>
 #include <omp.h>
 #include <stdexcept>
@@ -6,8 +10,9 @@
 namespace matmul {
 namespace strassen {
 
-Matrix hybrid(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads) {
-    if (!A.is_square() || !B.is_square() || A.size() != B.size()) {
+Matrix hybrid(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads,
+              const DistributedOptions& dist) {
+    if (!B.is_square() || A.cols() != B.rows() || partition::global_rows(A, dist) != B.rows()) {
         throw std::runtime_error("Strassen algorithm requires square matrices of same size");
     }
 
@@ -17,52 +22,49 @@ Matrix hybrid(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    int n = A.rows();
+    int n = B.rows();
 
     // Distribute rows of matrix A and use OpenMP Strassen on each partition
-    int rows_per_proc = n / size;
-    int remainder = n % size;
-    int local_rows = rows_per_proc + (rank < remainder ? 1 : 0);
-    int row_offset = rank * rows_per_proc + std::min(rank, remainder);
+    partition::RowPartition part = partition::for_engine(n, opt, num_threads, dist);
+    int local_rows = part.local_rows(rank);
+    int row_offset = part.row_offset(rank);
 
-    // Broadcast matrix B to all processes
-    Matrix B_local = B;
+    // B is already replicated on every rank (broadcast by the caller)
+    const Matrix& B_local = B;
 
-    // Create local portion of A
-    Matrix A_local(local_rows, n);
-    for (int i = 0; i < local_rows; ++i) {
-        for (int j = 0; j < n; ++j) {
-            A_local(i, j) = A(row_offset + i, j);
-        }
-    }
+    // Local portion of A: a view of this rank's rows, no copy
+    const ConstMatrixView A_local = partition::local_rows_of(A, part, rank, dist);
 
-    // For the local computation, use OpenMP-enabled algorithm
+    // For the local computation, if the local matrix is square enough,
+    // use Strassen (one checkpoint tile), otherwise naive tile by tile
     Matrix C_local(local_rows, n);
-
-    if (local_rows == n) {
-        // Full matrix, use Strassen with OpenMP
-        C_local = openmp(A_local, B_local, opt, num_threads);
-    } else {
-        // Partial rows, use naive multiplication with OpenMP
-        C_local = naive::openmp(A_local, B_local, opt, num_threads);
-    }
+    bool use_strassen = (local_rows == n);
+    int tile_rows = use_strassen ? local_rows : opt.block_size;
+
+    Timer compute_timer;
+    compute_timer.start();
+    int computed_rows = checkpoint::compute_tiles(C_local, A_local, B_local, row_offset,
+                                                  tile_rows, dist,
+                                                  [&](int row_begin, int row_end) {
+        if (use_strassen) {
+            C_local = openmp(A_local, B_local, opt, num_threads);
+        } else {
+            naive::openmp_rows(A_local, B_local, opt, C_local, row_begin, row_end, num_threads);
+        }
+    });
+    compute_timer.stop();
+    partition::record(computed_rows, compute_timer.elapsed_seconds(), n, n, dist);
 
     // Gather results
     Matrix C(n, n);
     C.zero();
 
-    std::vector<int> sendcounts(size);
-    std::vector<int> displs(size);
-
-    for (int i = 0; i < size; ++i) {
-        int proc_rows = rows_per_proc + (i < remainder ? 1 : 0);
-        sendcounts[i] = proc_rows * n;
-        displs[i] = (i * rows_per_proc + std::min(i, remainder)) * n;
-    }
+    std::vector<int> sendcounts;
+    std::vector<int> displs;
+    part.counts(n, sendcounts, displs);
 
-    MPI_Allgatherv(C_local.data(), local_rows * n, MPI_DOUBLE,
-                   C.data(), sendcounts.data(), displs.data(),
-                   MPI_DOUBLE, MPI_COMM_WORLD);
+    comm::allgatherv(C_local.data(), local_rows * n, C.data(), sendcounts, displs,
+                     MPI_COMM_WORLD, dist);
 
     return C;
 }
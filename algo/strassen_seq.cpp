@@ -72,8 +72,8 @@ static Matrix strassen_recursive(const Matrix& A, const Matrix& B, const Optimiz
     Matrix C21 = M2 + M4;
     Matrix C22 = M1 - M2 + M3 + M6;
 
-    // Combine quadrants into result matrix
-    Matrix C(n, n);
+    // Combine quadrants into result matrix (every element is set)
+    Matrix C = Matrix::uninitialized(n, n);
     C.set_submatrix(0, 0, C11);
     C.set_submatrix(0, half, C12);
     C.set_submatrix(half, 0, C21);
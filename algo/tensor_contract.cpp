@@ -0,0 +1,379 @@
+#include "tensor.hpp"
+#include "algorithms.hpp"
+#include "timer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <sstream>
+#include <stdexcept>
+
+namespace matmul {
+namespace tensor {
+
+static PhaseAccumulator permute_phase("Tensor permute");
+static PhaseAccumulator gemm_phase("Tensor GEMM");
+
+namespace {
+
+struct Spec {
+    std::string a, b, out;
+};
+
+Spec parse_spec(const std::string& text) {
+    std::string s;
+    for (char c : text) {
+        if (!std::isspace(static_cast<unsigned char>(c))) s += c;
+    }
+    size_t comma = s.find(',');
+    size_t arrow = s.find("->");
+    if (comma == std::string::npos || arrow == std::string::npos || comma > arrow) {
+        throw std::runtime_error("Contraction spec must look like \"ab,bc->ac\": " + text);
+    }
+
+    Spec spec{s.substr(0, comma), s.substr(comma + 1, arrow - comma - 1), s.substr(arrow + 2)};
+    for (const std::string* term : {&spec.a, &spec.b, &spec.out}) {
+        for (size_t i = 0; i < term->size(); ++i) {
+            char c = (*term)[i];
+            if (!std::isalpha(static_cast<unsigned char>(c))) {
+                throw std::runtime_error("Contraction indices must be letters: " + text);
+            }
+            if (term->find(c, i + 1) != std::string::npos) {
+                throw std::runtime_error(std::string("Index '") + c + "' repeats within a term: " + text);
+            }
+        }
+    }
+    for (char c : spec.out) {
+        if (spec.a.find(c) == std::string::npos && spec.b.find(c) == std::string::npos) {
+            throw std::runtime_error(std::string("Output index '") + c + "' is in neither operand");
+        }
+    }
+    for (char c : spec.a + spec.b) {
+        bool in_a = spec.a.find(c) != std::string::npos;
+        bool in_b = spec.b.find(c) != std::string::npos;
+        bool in_out = spec.out.find(c) != std::string::npos;
+        if (!in_out && !(in_a && in_b)) {
+            throw std::runtime_error(std::string("Index '") + c + "' is summed within one operand only");
+        }
+    }
+    return spec;
+}
+
+bool has(const std::string& term, char c) {
+    return term.find(c) != std::string::npos;
+}
+
+// Extent and stride of every index letter of a row-major tensor
+struct Layout {
+    std::string term;
+    std::vector<int> extents;
+    std::vector<int64_t> strides;
+
+    Layout(const std::string& term, const std::vector<int>& shape) : term(term), extents(shape) {
+        strides.assign(shape.size(), 1);
+        for (int d = static_cast<int>(shape.size()) - 2; d >= 0; --d) {
+            strides[d] = strides[d + 1] * shape[d + 1];
+        }
+    }
+
+    int extent(char c) const { return extents[term.find(c)]; }
+    int64_t stride(char c) const { return strides[term.find(c)]; }
+
+    // Stride of the group as a single fused index: -1 when its letters do not
+    // form one row-major run, 0 when it is empty. Extent-1 letters fit anywhere.
+    int64_t fused_stride(const std::string& group) const {
+        int64_t inner = 0;      // Stride of the innermost letter
+        int64_t expected = -1;  // Stride the next letter out must have
+        for (int g = static_cast<int>(group.size()) - 1; g >= 0; --g) {
+            char c = group[g];
+            if (extent(c) == 1) continue;
+            if (expected >= 0 && stride(c) != expected) return -1;
+            if (expected < 0) inner = stride(c);
+            expected = stride(c) * extent(c);
+        }
+        return inner;
+    }
+
+    // perm for permute() that reorders this tensor to `order`
+    std::vector<int> perm_to(const std::string& order) const {
+        std::vector<int> perm(order.size());
+        for (size_t d = 0; d < order.size(); ++d) perm[d] = static_cast<int>(term.find(order[d]));
+        return perm;
+    }
+};
+
+bool is_identity(const std::vector<int>& perm) {
+    for (size_t d = 0; d < perm.size(); ++d) {
+        if (perm[d] != static_cast<int>(d)) return false;
+    }
+    return true;
+}
+
+// Offsets of batch entry b along the batch letters of one tensor
+int64_t batch_offset(const Layout& layout, const std::string& batch, const std::vector<int>& extents,
+                     int64_t b) {
+    int64_t offset = 0;
+    for (int d = static_cast<int>(batch.size()) - 1; d >= 0; --d) {
+        offset += (b % extents[d]) * layout.stride(batch[d]);
+        b /= extents[d];
+    }
+    return offset;
+}
+
+int checked_int(int64_t value) {
+    if (value > INT_MAX) {
+        throw std::runtime_error("Contraction dimension exceeds the GEMM engines' int range");
+    }
+    return static_cast<int>(value);
+}
+
+// C = A * B for one slice, through the configured engine when all three
+// slices are contiguous and through OpenBLAS with leading dimensions otherwise
+void slice_gemm(int m, int k, int n, const double* A, int lda, const double* B, int ldb, double* C,
+                int ldc, const Config& config) {
+    if (m == 0 || n == 0) return;
+    if (k == 0) {
+        for (int i = 0; i < m; ++i) {
+            std::fill(C + static_cast<size_t>(i) * ldc, C + static_cast<size_t>(i) * ldc + n, 0.0);
+        }
+        return;
+    }
+    if (lda == k && ldb == n && ldc == n) {
+        const ConstMatrixView Av(A, m, k);
+        const ConstMatrixView Bv(B, k, n);
+        Matrix Cv = Matrix::view(C, m, n);
+        if (config.algorithm == Algorithm::STRASSEN && !(m == k && k == n)) {
+            Config naive = config;
+            naive.algorithm = Algorithm::NAIVE;  // Strassen takes square operands only
+            multiply_into(Av, Bv, naive, Cv);
+        } else {
+            multiply_into(Av, Bv, config, Cv);
+        }
+        return;
+    }
+    openblas::gemm(m, k, n, A, lda, B, ldb, C, ldc);
+}
+
+} // namespace
+
+std::string Plan::describe() const {
+    std::ostringstream out;
+    auto group = [&out](const char* name, const std::string& letters, int64_t size) {
+        out << name << " [" << letters << "] " << size;
+    };
+    group("batch", batch, batch_size);
+    out << ", ";
+    group("m", m, m_size);
+    out << ", ";
+    group("n", n, n_size);
+    out << ", ";
+    group("k", k, k_size);
+    if (batched) {
+        out << "; GEMM on strided slices, no copies";
+    } else {
+        std::string moved;
+        if (permute_a) moved += " A";
+        if (permute_b) moved += " B";
+        if (permute_c) moved += " C";
+        out << "; TTGT, permuting" << (moved.empty() ? " nothing" : moved);
+    }
+    return out.str();
+}
+
+Tensor contract(const std::string& spec_text, const Tensor& A, const Tensor& B, const Config& config,
+                Strategy strategy, Stats* stats) {
+    Spec spec = parse_spec(spec_text);
+    if (A.rank() != static_cast<int>(spec.a.size()) || B.rank() != static_cast<int>(spec.b.size())) {
+        throw std::runtime_error("Operand ranks do not match the contraction spec " + spec_text);
+    }
+    Layout la(spec.a, A.shape());
+    Layout lb(spec.b, B.shape());
+    for (char c : spec.a) {
+        if (has(spec.b, c) && la.extent(c) != lb.extent(c)) {
+            throw std::runtime_error(std::string("Index '") + c + "' has different extents in A and B");
+        }
+    }
+
+    // Group the letters; m and k keep A's order, n B's, batch the output's
+    Plan plan;
+    for (char c : spec.out) {
+        if (has(spec.a, c) && has(spec.b, c)) plan.batch += c;
+    }
+    for (char c : spec.a) {
+        if (has(spec.out, c) && !has(spec.b, c)) plan.m += c;
+        if (!has(spec.out, c)) plan.k += c;
+    }
+    for (char c : spec.b) {
+        if (has(spec.out, c) && !has(spec.a, c)) plan.n += c;
+    }
+    std::vector<int> batch_extents;
+    for (char c : plan.batch) {
+        batch_extents.push_back(la.extent(c));
+        plan.batch_size *= la.extent(c);
+    }
+    for (char c : plan.m) plan.m_size *= la.extent(c);
+    for (char c : plan.k) plan.k_size *= la.extent(c);
+    for (char c : plan.n) plan.n_size *= lb.extent(c);
+
+    std::vector<int> out_shape;
+    for (char c : spec.out) out_shape.push_back(has(spec.a, c) ? la.extent(c) : lb.extent(c));
+    Layout lc(spec.out, out_shape);
+
+    int m = checked_int(plan.m_size);
+    int n = checked_int(plan.n_size);
+    int k = checked_int(plan.k_size);
+
+    Config local = config;
+    if (local.mode == ExecutionMode::MPI) local.mode = ExecutionMode::SEQUENTIAL;
+    if (local.mode == ExecutionMode::HYBRID) local.mode = ExecutionMode::OPENMP;
+    bool parallel = local.mode == ExecutionMode::OPENMP;
+    int threads = parallel ? local.num_threads : 1;
+
+    // Batched: each operand's m/k/n groups must already be fused runs with
+    // the inner one contiguous, i.e. every slice is a row-major matrix
+    int64_t lda = la.fused_stride(plan.m), a_inner = la.fused_stride(plan.k);
+    int64_t ldb = lb.fused_stride(plan.k), b_inner = lb.fused_stride(plan.n);
+    int64_t ldc = lc.fused_stride(plan.m), c_inner = lc.fused_stride(plan.n);
+    auto unit = [](int64_t stride) { return stride == 0 || stride == 1; };
+    bool strided_ok = lda >= 0 && ldb >= 0 && ldc >= 0 && unit(a_inner) && unit(b_inner) && unit(c_inner);
+    if (strategy == Strategy::BATCHED && !strided_ok) {
+        throw std::runtime_error("Operand layouts do not allow batched GEMM without permutations for " +
+                                 spec_text);
+    }
+    plan.batched = strided_ok && strategy != Strategy::TTGT;
+
+    Tensor C(out_shape);
+    Timer timer;
+
+    if (plan.batched) {
+        // An empty group leaves its leading dimension free
+        if (lda == 0) lda = std::max(k, 1);
+        if (ldb == 0) ldb = std::max(n, 1);
+        if (ldc == 0) ldc = std::max(n, 1);
+        ScopedTimer timed(gemm_phase);
+        timer.start();
+        for (int64_t b = 0; b < plan.batch_size; ++b) {
+            slice_gemm(m, k, n, A.data() + batch_offset(la, plan.batch, batch_extents, b), checked_int(lda),
+                       B.data() + batch_offset(lb, plan.batch, batch_extents, b), checked_int(ldb),
+                       C.data() + batch_offset(lc, plan.batch, batch_extents, b), checked_int(ldc), local);
+        }
+        timer.stop();
+        if (stats) {
+            stats->plan = plan;
+            stats->permute_seconds = 0.0;
+            stats->gemm_seconds = timer.elapsed_seconds();
+        }
+        return C;
+    }
+
+    // TTGT: A -> [batch, m, k], B -> [batch, k, n], C from [batch, m, n]
+    std::vector<int> perm_a = la.perm_to(plan.batch + plan.m + plan.k);
+    std::vector<int> perm_b = lb.perm_to(plan.batch + plan.k + plan.n);
+    std::string canonical_c = plan.batch + plan.m + plan.n;
+    std::vector<int> perm_c(spec.out.size());
+    for (size_t d = 0; d < spec.out.size(); ++d) {
+        perm_c[d] = static_cast<int>(canonical_c.find(spec.out[d]));
+    }
+    plan.permute_a = !is_identity(perm_a);
+    plan.permute_b = !is_identity(perm_b);
+    plan.permute_c = !is_identity(perm_c);
+
+    double permute_seconds = 0.0;
+    Tensor A_moved, B_moved;
+    {
+        ScopedTimer timed(permute_phase);
+        timer.start();
+        if (plan.permute_a) A_moved = permute(A, perm_a, threads);
+        if (plan.permute_b) B_moved = permute(B, perm_b, threads);
+        timer.stop();
+        permute_seconds += timer.elapsed_seconds();
+    }
+    const Tensor& Ac = plan.permute_a ? A_moved : A;
+    const Tensor& Bc = plan.permute_b ? B_moved : B;
+
+    std::vector<int> canonical_shape;
+    for (char c : canonical_c) canonical_shape.push_back(lc.extent(c));
+    Tensor C_canonical = plan.permute_c ? Tensor(canonical_shape) : Tensor();
+    Tensor& Cc = plan.permute_c ? C_canonical : C;
+
+    {
+        ScopedTimer timed(gemm_phase);
+        timer.start();
+        size_t a_slice = static_cast<size_t>(m) * k, b_slice = static_cast<size_t>(k) * n,
+               c_slice = static_cast<size_t>(m) * n;
+        for (int64_t b = 0; b < plan.batch_size; ++b) {
+            slice_gemm(m, k, n, Ac.data() + b * a_slice, k, Bc.data() + b * b_slice, n,
+                       Cc.data() + b * c_slice, n, local);
+        }
+        timer.stop();
+    }
+    double gemm_seconds = timer.elapsed_seconds();
+
+    if (plan.permute_c) {
+        ScopedTimer timed(permute_phase);
+        timer.start();
+        C = permute(C_canonical, perm_c, threads);
+        timer.stop();
+        permute_seconds += timer.elapsed_seconds();
+    }
+
+    if (stats) {
+        stats->plan = plan;
+        stats->permute_seconds = permute_seconds;
+        stats->gemm_seconds = gemm_seconds;
+    }
+    return C;
+}
+
+Tensor contract_reference(const std::string& spec_text, const Tensor& A, const Tensor& B) {
+    Spec spec = parse_spec(spec_text);
+    if (A.rank() != static_cast<int>(spec.a.size()) || B.rank() != static_cast<int>(spec.b.size())) {
+        throw std::runtime_error("Operand ranks do not match the contraction spec " + spec_text);
+    }
+    Layout la(spec.a, A.shape());
+    Layout lb(spec.b, B.shape());
+
+    // Every letter once: the output's, then the summed ones
+    std::string letters = spec.out;
+    for (char c : spec.a) {
+        if (!has(spec.out, c)) letters += c;
+    }
+    std::vector<int> extents;
+    std::vector<int64_t> a_stride, b_stride;
+    for (char c : letters) {
+        extents.push_back(has(spec.a, c) ? la.extent(c) : lb.extent(c));
+        a_stride.push_back(has(spec.a, c) ? la.stride(c) : 0);
+        b_stride.push_back(has(spec.b, c) ? lb.stride(c) : 0);
+    }
+
+    std::vector<int> out_shape(extents.begin(), extents.begin() + spec.out.size());
+    Tensor C(out_shape);
+    int64_t summed = 1;
+    for (size_t d = spec.out.size(); d < letters.size(); ++d) summed *= extents[d];
+
+    std::vector<int> index(letters.size(), 0);
+    for (size_t e = 0; e < C.count(); ++e) {
+        double sum = 0.0;
+        for (int64_t s = 0; s < summed; ++s) {
+            int64_t ao = 0, bo = 0;
+            for (size_t d = 0; d < letters.size(); ++d) {
+                ao += index[d] * a_stride[d];
+                bo += index[d] * b_stride[d];
+            }
+            sum += A.data()[ao] * B.data()[bo];
+            // Next summed index (odometer over the trailing letters)
+            for (int d = static_cast<int>(letters.size()) - 1; d >= static_cast<int>(spec.out.size()); --d) {
+                if (++index[d] < extents[d]) break;
+                index[d] = 0;
+            }
+        }
+        C.data()[e] = sum;
+        for (int d = static_cast<int>(spec.out.size()) - 1; d >= 0; --d) {
+            if (++index[d] < extents[d]) break;
+            index[d] = 0;
+        }
+    }
+    return C;
+}
+
+} // namespace tensor
+} // namespace matmul
@@ -0,0 +1,167 @@
+#include "algorithms.hpp"
+#include "winograd.hpp"
+#include "timer.hpp"
+#include <omp.h>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace matmul {
+namespace winograd {
+
+static PhaseAccumulator factor_phase("Row/col factors");
+static PhaseAccumulator kernel_phase("Winograd kernel");
+
+namespace {
+
+// Tile of C updated from one panel of B: ROW_BLOCK x COL_BLOCK entries of C
+// against 2 * PAIR_BLOCK rows of COL_BLOCK columns of B (256 KB for doubles)
+const int ROW_BLOCK = 64;
+const int COL_BLOCK = 256;
+const int PAIR_BLOCK = 64;
+
+// sum_j a[2j] * a[2j+1]; the reduction is only reordered for arithmetic types
+template <typename T>
+T pair_products(const T* a, int pairs) {
+    T sum = T();
+    if constexpr (std::is_arithmetic<T>::value) {
+        #pragma omp simd reduction(+:sum)
+        for (int j = 0; j < pairs; ++j) {
+            sum += a[2 * j] * a[2 * j + 1];
+        }
+    } else {
+        for (int j = 0; j < pairs; ++j) {
+            sum += a[2 * j] * a[2 * j + 1];
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+template <typename T>
+void multiply(int m, int k, int n, const T* A, const T* B, T* C, int num_threads) {
+    int pairs = k / 2;
+    std::vector<T> row_factor(m);
+    std::vector<T> col_factor(n);
+
+    {
+        ScopedTimer timed(factor_phase);
+
+        #pragma omp parallel num_threads(num_threads)
+        {
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < m; ++i) {
+                row_factor[i] = pair_products(A + static_cast<size_t>(i) * k, pairs);
+            }
+
+            // Column factors a strip at a time, so every update is a
+            // contiguous (vectorized) row segment of B
+            #pragma omp for schedule(static)
+            for (int cb = 0; cb < n; cb += COL_BLOCK) {
+                int c_max = std::min(cb + COL_BLOCK, n);
+                T* f = col_factor.data();
+                for (int c = cb; c < c_max; ++c) f[c] = T();
+                for (int j = 0; j < pairs; ++j) {
+                    const T* b0 = B + static_cast<size_t>(2 * j) * n;
+                    const T* b1 = b0 + n;
+                    #pragma omp simd
+                    for (int c = cb; c < c_max; ++c) {
+                        f[c] += b0[c] * b1[c];
+                    }
+                }
+            }
+        }
+    }
+
+    ScopedTimer timed(kernel_phase);
+
+    // Each tile of C starts at -(r_i + c_c) and takes one product per pair
+    // of k. The innermost loop runs along a row of C and B, with the two
+    // entries of A broadcast.
+    #pragma omp parallel for collapse(2) schedule(dynamic) num_threads(num_threads)
+    for (int ib = 0; ib < m; ib += ROW_BLOCK) {
+        for (int cb = 0; cb < n; cb += COL_BLOCK) {
+            int i_max = std::min(ib + ROW_BLOCK, m);
+            int c_max = std::min(cb + COL_BLOCK, n);
+            const T* f = col_factor.data();
+
+            for (int i = ib; i < i_max; ++i) {
+                T* c_row = C + static_cast<size_t>(i) * n;
+                T r = row_factor[i];
+                for (int c = cb; c < c_max; ++c) c_row[c] = T() - (r + f[c]);
+            }
+
+            for (int jb = 0; jb < pairs; jb += PAIR_BLOCK) {
+                int j_max = std::min(jb + PAIR_BLOCK, pairs);
+                for (int i = ib; i < i_max; ++i) {
+                    const T* a = A + static_cast<size_t>(i) * k;
+                    T* c_row = C + static_cast<size_t>(i) * n;
+                    for (int j = jb; j < j_max; ++j) {
+                        T a0 = a[2 * j];
+                        T a1 = a[2 * j + 1];
+                        const T* b0 = B + static_cast<size_t>(2 * j) * n;
+                        const T* b1 = b0 + n;
+                        #pragma omp simd
+                        for (int c = cb; c < c_max; ++c) {
+                            c_row[c] += (a0 + b1[c]) * (a1 + b0[c]);
+                        }
+                    }
+                }
+            }
+
+            // Odd k: the last column of A is multiplied out directly
+            if (k % 2 != 0) {
+                const T* b_last = B + static_cast<size_t>(k - 1) * n;
+                for (int i = ib; i < i_max; ++i) {
+                    T a_last = A[static_cast<size_t>(i) * k + k - 1];
+                    T* c_row = C + static_cast<size_t>(i) * n;
+                    #pragma omp simd
+                    for (int c = cb; c < c_max; ++c) {
+                        c_row[c] += a_last * b_last[c];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// The row/column factors and the pair sums can overflow int64 even when
+// every C[i][c] fits, so signed entries are computed modulo 2^64 as uint64_t
+// (the identity holds in any commutative ring) and read back two's-complement
+template <>
+void multiply<int64_t>(int m, int k, int n, const int64_t* A, const int64_t* B, int64_t* C,
+                       int num_threads) {
+    multiply<uint64_t>(m, k, n, reinterpret_cast<const uint64_t*>(A),
+                       reinterpret_cast<const uint64_t*>(B), reinterpret_cast<uint64_t*>(C),
+                       num_threads);
+}
+
+template void multiply<double>(int, int, int, const double*, const double*, double*, int);
+template void multiply<uint64_t>(int, int, int, const uint64_t*, const uint64_t*, uint64_t*, int);
+template void multiply<Modular>(int, int, int, const Modular*, const Modular*, Modular*, int);
+
+int64_t multiplications(int m, int k, int n) {
+    int64_t pairs = k / 2;
+    int64_t count = static_cast<int64_t>(m) * n * pairs + (static_cast<int64_t>(m) + n) * pairs;
+    if (k % 2 != 0) count += static_cast<int64_t>(m) * n;
+    return count;
+}
+
+Matrix sequential(const Matrix& A, const Matrix& B) {
+    return openmp(A, B, 1);
+}
+
+Matrix openmp(const Matrix& A, const Matrix& B, int num_threads) {
+    if (A.cols() != B.rows()) {
+        throw std::runtime_error("Matrix dimensions incompatible for multiplication");
+    }
+
+    Matrix C = Matrix::uninitialized(A.rows(), B.cols());
+    multiply(A.rows(), A.cols(), B.cols(), A.data(), B.data(), C.data(), num_threads);
+    return C;
+}
+
+} // namespace winograd
+} // namespace matmul
@@ -0,0 +1,134 @@
+# Driver for the pgo-* targets. Invoked in script mode (cmake -P) with:
+#   STEP        instrument | train | optimize | report
+#   SOURCE_DIR  project source tree
+#   PGO_DIR     working directory for the nested build trees and the report
+#   GENERATOR, CXX_COMPILER, MPIEXEC, MPIEXEC_NUMPROC_FLAG, MPIEXEC_PREFLAGS
+
+include(${SOURCE_DIR}/cmake/PgoWorkload.cmake)
+
+set(PROFILED_DIR ${PGO_DIR}/profiled)
+set(RELEASE_DIR ${PGO_DIR}/release)
+set(REPORT_FILE ${PGO_DIR}/pgo_report.md)
+
+# Configure and build one nested tree
+function(pgo_build dir phase)
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} -S ${SOURCE_DIR} -B ${dir} -G ${GENERATOR}
+                -DCMAKE_BUILD_TYPE=Release
+                -DCMAKE_CXX_COMPILER=${CXX_COMPILER}
+                -DMATMUL_PGO_PHASE=${phase}
+        RESULT_VARIABLE rc)
+    if(NOT rc EQUAL 0)
+        message(FATAL_ERROR "Configuring ${dir} failed")
+    endif()
+    execute_process(COMMAND ${CMAKE_COMMAND} --build ${dir} --target matmul
+                    RESULT_VARIABLE rc)
+    if(NOT rc EQUAL 0)
+        message(FATAL_ERROR "Building ${dir} failed")
+    endif()
+endfunction()
+
+# Run one workload entry; sets <out_var> to the reported execution time
+function(pgo_run exe entry out_var)
+    string(FIND "${entry}" "|" sep)
+    string(SUBSTRING "${entry}" 0 ${sep} ranks)
+    math(EXPR args_begin "${sep} + 1")
+    string(SUBSTRING "${entry}" ${args_begin} -1 args)
+    separate_arguments(args UNIX_COMMAND "${args}")
+    separate_arguments(preflags UNIX_COMMAND "${MPIEXEC_PREFLAGS}")
+
+    if(ranks GREATER 0)
+        if(NOT MPIEXEC)
+            message(FATAL_ERROR "mpiexec not found; cannot run '${entry}'")
+        endif()
+        set(cmd ${MPIEXEC} ${MPIEXEC_NUMPROC_FLAG} ${ranks} ${preflags} ${exe} ${args})
+    else()
+        set(cmd ${exe} ${args})
+    endif()
+
+    execute_process(COMMAND ${cmd} RESULT_VARIABLE rc OUTPUT_VARIABLE out ERROR_VARIABLE err)
+    if(NOT rc EQUAL 0)
+        message(FATAL_ERROR "Workload '${entry}' failed:\n${out}\n${err}")
+    endif()
+    string(REGEX MATCH "Execution Time: +([0-9.]+)" _ "${out}")
+    set(${out_var} "${CMAKE_MATCH_1}" PARENT_SCOPE)
+endfunction()
+
+if(STEP STREQUAL "instrument")
+    # Stale profiles from an earlier training run would be merged into the new one
+    file(GLOB_RECURSE stale_profiles ${PROFILED_DIR}/*.gcda)
+    if(stale_profiles)
+        file(REMOVE ${stale_profiles})
+    endif()
+    pgo_build(${PROFILED_DIR} generate)
+
+elseif(STEP STREQUAL "train")
+    foreach(entry IN LISTS PGO_TRAINING_RUNS)
+        message(STATUS "[train] ${entry}")
+        pgo_run(${PROFILED_DIR}/matmul "${entry}" t)
+    endforeach()
+    file(GLOB_RECURSE profiles ${PROFILED_DIR}/*.gcda)
+    list(LENGTH profiles num_profiles)
+    if(num_profiles EQUAL 0)
+        message(FATAL_ERROR "Training produced no .gcda profiles")
+    endif()
+    message(STATUS "Collected ${num_profiles} profile files")
+
+elseif(STEP STREQUAL "optimize")
+    pgo_build(${PROFILED_DIR} use)
+
+elseif(STEP STREQUAL "report")
+    pgo_build(${RELEASE_DIR} "")
+
+    set(report "# PGO + LTO report\n\n")
+    string(APPEND report "Best of ${PGO_REPORT_REPEAT} runs, execution time in seconds.\n\n")
+    string(APPEND report "| Ranks | Arguments | Release | PGO+LTO | Speedup |\n")
+    string(APPEND report "|------:|-----------|--------:|--------:|--------:|\n")
+
+    foreach(entry IN LISTS PGO_REPORT_RUNS)
+        message(STATUS "[report] ${entry}")
+        foreach(variant release profiled)
+            set(best "")
+            foreach(rep RANGE 1 ${PGO_REPORT_REPEAT})
+                if(variant STREQUAL "release")
+                    pgo_run(${RELEASE_DIR}/matmul "${entry}" t)
+                else()
+                    pgo_run(${PROFILED_DIR}/matmul "${entry}" t)
+                endif()
+                if(best STREQUAL "" OR t LESS best)
+                    set(best ${t})
+                endif()
+            endforeach()
+            set(best_${variant} ${best})
+        endforeach()
+
+        # CMake math is integer-only; compute the speedup in basis points
+        string(REPLACE "." "" rel_num "${best_release}")
+        string(REPLACE "." "" pgo_num "${best_profiled}")
+        string(REGEX REPLACE "^0+([0-9])" "\\1" rel_num "${rel_num}")
+        string(REGEX REPLACE "^0+([0-9])" "\\1" pgo_num "${pgo_num}")
+        if(pgo_num GREATER 0)
+            math(EXPR speedup_bp "${rel_num} * 100 / ${pgo_num}")
+            math(EXPR speedup_int "${speedup_bp} / 100")
+            math(EXPR speedup_frac "${speedup_bp} % 100")
+            if(speedup_frac LESS 10)
+                set(speedup_frac "0${speedup_frac}")
+            endif()
+            set(speedup "${speedup_int}.${speedup_frac}x")
+        else()
+            set(speedup "n/a")
+        endif()
+
+        string(FIND "${entry}" "|" sep)
+        string(SUBSTRING "${entry}" 0 ${sep} ranks)
+        math(EXPR args_begin "${sep} + 1")
+        string(SUBSTRING "${entry}" ${args_begin} -1 args)
+        string(APPEND report "| ${ranks} | `${args}` | ${best_release} | ${best_profiled} | ${speedup} |\n")
+    endforeach()
+
+    file(WRITE ${REPORT_FILE} "${report}")
+    message(STATUS "PGO report written to ${REPORT_FILE}\n\n${report}")
+
+else()
+    message(FATAL_ERROR "Unknown PGO step '${STEP}'")
+endif()
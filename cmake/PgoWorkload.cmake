@@ -0,0 +1,41 @@
+# PGO training / comparison workload for matmul.
+#
+# Each entry is "<ranks>|<matmul arguments>". Entries with ranks > 0 are
+# launched through mpiexec with that many processes; ranks == 0 runs the
+# binary directly. Random inputs only, so the workload needs no data files
+# and runs fully offline.
+
+set(PGO_TRAINING_RUNS
+    # Naive engines: plain and blocked kernels, square and odd sizes
+    "0|-a naive -m seq -s 192"
+    "0|-a naive -m seq -s 257 -o"
+    "0|-a naive -m omp -t 2 -s 256"
+    "0|-a naive -m omp -t 2 -s 320 -b 32"
+    # Strassen engines: power-of-two and padded recursion
+    "0|-a strassen -m seq -s 256"
+    "0|-a strassen -m seq -s 129 -o"
+    "0|-a strassen -m omp -t 2 -s 256 -o"
+    # Reference path and the comparison code behind --validate/--verify
+    "0|-a openblas -m seq -s 256"
+    "0|-a naive -m seq -s 128 -o --validate"
+    "0|-m omp -t 2 -s 128 --verify"
+    # Small local MPI runs
+    "2|-a naive -m mpi -s 256 -o"
+    "2|-a naive -m hybrid -t 2 -s 256"
+    "2|-a strassen -m mpi -s 192"
+    "2|-a strassen -m hybrid -t 2 -s 192 -o"
+)
+
+# Subset timed by pgo-report; larger sizes so run-to-run noise stays small
+set(PGO_REPORT_RUNS
+    "0|-a naive -m seq -s 512"
+    "0|-a naive -m seq -s 768 -o"
+    "0|-a naive -m omp -t 2 -s 768 -o"
+    "0|-a strassen -m seq -s 512 -o"
+    "0|-a strassen -m omp -t 2 -s 512"
+    "2|-a naive -m mpi -s 768 -o"
+    "2|-a strassen -m hybrid -t 2 -s 512 -o"
+)
+
+# Repetitions per report entry; the best time is kept
+set(PGO_REPORT_REPEAT 3)
@@ -3,31 +3,100 @@
 
 #include "matrix.hpp"
 #include "config.hpp"
+#include "sparse.hpp"
+#include <functional>
 
 namespace matmul {
 
 // Algorithm dispatcher - calls the appropriate implementation based on config
 Matrix multiply(const Matrix& A, const Matrix& B, const Config& config);
 
+// Dispatcher writing into caller-provided storage C (already sized, may be a view)
+// Naive Sequential/OpenMP and OpenBLAS compute in place; the other engines
+// compute into a temporary and copy it
+void multiply_into(const Matrix& A, const Matrix& B, const Config& config, Matrix& C);
+
 // Naive algorithm implementations
 namespace naive {
     Matrix sequential(const Matrix& A, const Matrix& B, const OptimizationOptions& opt);
     Matrix openmp(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads);
-    Matrix mpi(const Matrix& A, const Matrix& B, const OptimizationOptions& opt);
-    Matrix hybrid(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads);
+    Matrix mpi(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
+               const DistributedOptions& dist = DistributedOptions());
+    Matrix hybrid(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads,
+                  const DistributedOptions& dist = DistributedOptions());
+
+    // In-place kernels: overwrite rows [row_begin, row_end) of C with those of A * B
+    void sequential_rows(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
+                         Matrix& C, int row_begin, int row_end);
+    void openmp_rows(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
+                     Matrix& C, int row_begin, int row_end, int num_threads);
+
+    // Packed kernel behind both when opt.packed is set: A row blocks and B
+    // panels are packed into micro-panels and each C tile is accumulated in
+    // a buffer, then written once (with streaming stores if requested)
+    void packed_rows(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
+                     Matrix& C, int row_begin, int row_end, int num_threads);
+
+    // --writeback-bench: the packed kernel with and without streaming stores
+    // and prefetch at sizes doubling up to --size
+    void run_writeback_benchmark(const Config& config);
 }
 
 // Strassen algorithm implementations
 namespace strassen {
     Matrix sequential(const Matrix& A, const Matrix& B, const OptimizationOptions& opt);
     Matrix openmp(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads);
-    Matrix mpi(const Matrix& A, const Matrix& B, const OptimizationOptions& opt);
-    Matrix hybrid(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads);
+    Matrix mpi(const Matrix& A, const Matrix& B, const OptimizationOptions& opt,
+               const DistributedOptions& dist = DistributedOptions());
+    Matrix hybrid(const Matrix& A, const Matrix& B, const OptimizationOptions& opt, int num_threads,
+                  const DistributedOptions& dist = DistributedOptions());
 }
 
 // OpenBLAS implementation
 namespace openblas {
     Matrix multiply(const Matrix& A, const Matrix& B);
+
+    // C = A * B on raw row-major blocks (m x k times k x n, leading dimensions given)
+    void gemm(int m, int k, int n, const double* A, int lda, const double* B, int ldb,
+              double* C, int ldc);
+}
+
+// Winograd's inner-product scheme (winograd.hpp): half the multiplications
+// of the naive kernel, for as many extra additions
+namespace winograd {
+    Matrix sequential(const Matrix& A, const Matrix& B);
+    Matrix openmp(const Matrix& A, const Matrix& B, int num_threads);
+}
+
+// Sparse x sparse (Gustavson, row by row) in two passes: a symbolic pass
+// counts the nonzeros of each C row from column indices alone so C is
+// allocated exactly once, then a numeric pass fills it. Each row is accumulated in a hash table, or in a
+// dense array when its product count is a large share of B's columns.
+namespace spgemm {
+    struct Stats {
+        double symbolic_seconds = 0.0;
+        double numeric_seconds = 0.0;
+        int64_t flops = 0;      // Multiply-adds (products a_ik * b_kj)
+        int hash_rows = 0;      // Rows accumulated in a hash table
+        int dense_rows = 0;     // Rows accumulated in a dense array
+    };
+
+    CsrMatrix multiply(const CsrMatrix& A, const CsrMatrix& B, int num_threads,
+                       Stats* stats = nullptr);
+}
+
+// Block-sparse x block-sparse: Gustavson over blocks, with a dense
+// block x block kernel for each pair of nonzero blocks. Block rows go to
+// OpenMP threads largest-work first.
+namespace bsr {
+    struct Stats {
+        double symbolic_seconds = 0.0;
+        double numeric_seconds = 0.0;
+        int64_t block_products = 0;   // Dense block multiplies performed
+    };
+
+    BsrMatrix multiply(const BsrMatrix& A, const BsrMatrix& B, int num_threads,
+                       Stats* stats = nullptr);
 }
 
 } // namespace matmul
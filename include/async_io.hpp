@@ -0,0 +1,64 @@
+#ifndef ASYNC_IO_HPP
+#define ASYNC_IO_HPP
+
+#include "matrix.hpp"
+#include "config.hpp"
+#include <cstdint>
+#include <string>
+
+namespace matmul {
+
+enum class AsyncBackend {
+    AUTO,        // io_uring, or the thread pool where the kernel refuses it
+    IO_URING,
+    THREADS      // pread() from a pool of threads
+};
+
+struct AsyncReadOptions {
+    AsyncBackend backend = AsyncBackend::AUTO;
+    bool direct = true;              // O_DIRECT: bypass the page cache
+    int queue_depth = 32;            // Reads in flight (threads for the pool)
+    size_t chunk_bytes = 1 << 20;    // Bytes per read
+};
+
+struct AsyncReadStats {
+    AsyncBackend backend = AsyncBackend::AUTO;  // Backend that actually ran
+    bool direct = false;             // O_DIRECT was in effect
+    uint64_t chunks = 0;
+    uint64_t bounced = 0;            // Chunks staged through an aligned buffer
+    double seconds = 0.0;
+};
+
+// Asynchronous loader for binary matrix files (MATMULB1). The data section
+// is split into chunks that are read with many requests in flight and land
+// in Matrix storage. Under O_DIRECT the storage is allocated at the device's
+// memory alignment (offset like the data section), so every chunk is read in
+// place except the one holding the header and the tail, which go through a
+// per-request aligned buffer and one copy. Falls back to buffered reads
+// when the file system rejects O_DIRECT.
+class AsyncIO {
+public:
+    // Returns true on success, false on error
+    static bool read_matrix(const std::string& filename, Matrix& matrix,
+                            const AsyncReadOptions& options = AsyncReadOptions(),
+                            AsyncReadStats* stats = nullptr);
+
+    // True if this kernel lets the process create an io_uring
+    static bool io_uring_available();
+};
+
+const char* backend_to_string(AsyncBackend backend);
+
+namespace async_io {
+
+// --io-bench: writes a random size x size matrix to --io-file (binary and
+// CSV), then times cold reads with CsvIO, ifstream, mmap, the thread pool
+// and io_uring, buffered and O_DIRECT, and prints GB/s and how much of the
+// file each left in the page cache
+void run_benchmark(const Config& config);
+
+} // namespace async_io
+
+} // namespace matmul
+
+#endif // ASYNC_IO_HPP
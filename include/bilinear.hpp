@@ -0,0 +1,87 @@
+#ifndef BILINEAR_HPP
+#define BILINEAR_HPP
+
+#include "matrix.hpp"
+#include "config.hpp"
+#include "buffer_pool.hpp"
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace matmul {
+namespace bilinear {
+
+// Fast bilinear schemes from algo/schemes/catalog.txt, compiled into
+// recursive implementations by tools/bilinear_gen at build time
+struct SchemeInfo {
+    std::string name;
+    int m, k, n;       // Block grid <m,k,n>
+    int rank;          // Block products per step
+    int additions;     // Block additions per step as written in the catalog
+    int cse_additions; // After common subexpression elimination
+};
+
+std::vector<SchemeInfo> catalog();
+
+// C = A * B with `levels` recursive steps of the named scheme, then OpenBLAS
+// on the leaves. Operands are zero-padded to multiples of the block grid
+// raised to `levels`. Throws std::runtime_error for an unknown scheme.
+Matrix multiply(const std::string& scheme, const Matrix& A, const Matrix& B, int levels);
+
+// --bilinear-bench: times every scheme at 1..3 levels on square and
+// rectangular shapes scaled from --size and picks the fastest per shape
+void run_benchmark(const Config& config);
+
+// Runtime used by the generated code
+namespace detail {
+
+// Scratch block from the buffer pool, rows x cols with leading dimension cols
+class Temp {
+public:
+    Temp(int rows, int cols)
+        : data(pool::allocate(static_cast<size_t>(rows) * cols)), ld(cols),
+          count_(static_cast<size_t>(rows) * cols) {}
+    ~Temp() { pool::release(data, count_); }
+
+    Temp(const Temp&) = delete;
+    Temp& operator=(const Temp&) = delete;
+
+    double* data;
+    int ld;
+
+private:
+    size_t count_;
+};
+
+struct Term {
+    double coef;
+    const double* src;
+    int ld;
+};
+
+// dst = sum of coef * src over the terms (rows x cols blocks)
+void combine(int rows, int cols, double* dst, int ldd, std::initializer_list<Term> terms);
+
+// C = A * B for an m x k by k x n leaf (OpenBLAS)
+void leaf_gemm(int m, int k, int n, const double* A, int lda, const double* B, int ldb,
+               double* C, int ldc);
+
+using StepFn = void (*)(const double* A, int lda, const double* B, int ldb, double* C, int ldc,
+                        int m, int k, int n, int levels);
+
+struct GeneratedScheme {
+    const char* name;
+    int m, k, n, rank, additions, cse_additions;
+    StepFn step;
+};
+
+// Defined in the generated source
+extern const GeneratedScheme generated_schemes[];
+extern const int generated_scheme_count;
+
+} // namespace detail
+
+} // namespace bilinear
+} // namespace matmul
+
+#endif // BILINEAR_HPP
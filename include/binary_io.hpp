@@ -0,0 +1,75 @@
+#ifndef BINARY_IO_HPP
+#define BINARY_IO_HPP
+
+#include "matrix.hpp"
+#include <cstdint>
+#include <string>
+
+namespace matmul {
+
+// On-disk header of the binary matrix format: 64 bytes, followed by
+// rows * cols native-endian doubles in row-major order
+struct BinaryMatrixHeader {
+    char magic[8];           // "MATMULB1"
+    uint32_t version;        // Format version (1)
+    uint32_t header_size;    // Bytes before the first element
+    int64_t rows;
+    int64_t cols;
+    uint64_t reserved[4];    // Zero; pads the header to 64 bytes
+};
+
+static_assert(sizeof(BinaryMatrixHeader) == 64, "BinaryMatrixHeader must be 64 bytes");
+
+class BinaryIO {
+public:
+    // Fill a header for a rows x cols matrix
+    static BinaryMatrixHeader make_header(int rows, int cols);
+
+    // Check magic/version/sizes of a header read from disk
+    static bool valid_header(const BinaryMatrixHeader& header);
+
+    // Read a matrix from a binary file
+    // Returns true on success, false on error
+    static bool read_matrix(const std::string& filename, Matrix& matrix);
+
+    // Write a matrix to a binary file
+    // Returns true on success, false on error
+    static bool write_matrix(const std::string& filename, const Matrix& matrix);
+};
+
+// Binary output file whose data section is memory-mapped, so a result
+// matrix can be computed directly into it. The file is preallocated to its
+// final size; close() (or the destructor) flushes it with msync(MS_SYNC)
+// and unmaps it.
+class MappedMatrixFile {
+public:
+    MappedMatrixFile() = default;
+    ~MappedMatrixFile();
+
+    MappedMatrixFile(const MappedMatrixFile&) = delete;
+    MappedMatrixFile& operator=(const MappedMatrixFile&) = delete;
+
+    // Create (or truncate) filename sized for a rows x cols matrix
+    // Returns true on success, false on error
+    bool create(const std::string& filename, int rows, int cols);
+
+    // Non-owning matrix over the mapped data section
+    Matrix view();
+
+    // Flush everything synchronously and unmap
+    // Returns true if all data reached the file
+    bool close();
+
+    bool is_open() const { return base_ != nullptr; }
+
+private:
+    char* base_ = nullptr;    // Start of the mapping (header included)
+    size_t length_ = 0;       // Mapping length in bytes
+    int fd_ = -1;
+    int rows_ = 0;
+    int cols_ = 0;
+};
+
+} // namespace matmul
+
+#endif // BINARY_IO_HPP
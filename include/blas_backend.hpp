@@ -0,0 +1,54 @@
+#ifndef BLAS_BACKEND_HPP
+#define BLAS_BACKEND_HPP
+
+#include "config.hpp"
+#include <string>
+
+namespace matmul {
+namespace blas {
+
+// The BLAS library openblas::multiply and openblas::gemm call into
+struct BackendInfo {
+    BlasBackend backend = BlasBackend::LINKED;
+    std::string library;         // File the dgemm symbol was found in
+    std::string vendor;          // Detected from the library's symbols
+    std::string version;         // Empty if the library does not report one
+    bool thread_control = false; // Library exposes a thread-count setter
+    int threads = 1;             // Threads it was last set to (1 without control)
+};
+
+// Load a backend with dlopen (LINKED uses the build-time library). An empty
+// path searches the backend's usual sonames. Returns true on success; on
+// failure prints an error and the previous backend stays active.
+bool load(BlasBackend backend, const std::string& path = "");
+
+// Set the active library's thread count. Returns false if it has none
+// (reference BLAS, or an unknown linked library).
+bool set_threads(int threads);
+
+// Threads one rank's BLAS should run: --blas-threads if given, else 1 for
+// sequential runs, num_threads for OpenMP/Hybrid, and the node's cores split
+// between its ranks for MPI (where every rank may call BLAS at once)
+int threads_for(const Config& config, int ranks_per_node);
+
+// Collective: load config.blas_backend on every rank and set its threads
+// for this run. Returns false (on every rank) if some rank failed to load.
+bool configure(const Config& config);
+
+const BackendInfo& active();
+
+// Row-major C = A * B (m x k times k x n, leading dimensions given)
+// through the active library
+void dgemm(int m, int k, int n, const double* A, int lda, const double* B, int ldb,
+           double* C, int ldc);
+
+// --blas-bench: loads every backend it can find and times square dgemm at
+// sizes doubling up to --size, each library with the thread count this run
+// would give it, and prints GFLOP/s and each result's difference from the
+// linked library's
+void run_benchmark(const Config& config);
+
+} // namespace blas
+} // namespace matmul
+
+#endif // BLAS_BACKEND_HPP
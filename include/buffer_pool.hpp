@@ -0,0 +1,52 @@
+#ifndef BUFFER_POOL_HPP
+#define BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace matmul {
+namespace pool {
+
+// Pooled storage for Matrix buffers.
+//
+// Requests are rounded up to a size class (four classes per power of two,
+// so at most 25% slack) and served from a thread-local free list for that
+// class, then from a shared free list, and only then from the system
+// (64-byte aligned). Released buffers go back to the thread-local list, the
+// shared list when that is full, or to the system when the pool already
+// holds `limit` bytes of idle buffers. Thread-safe.
+
+struct Stats {
+    uint64_t local_hits = 0;     // Served from the calling thread's free list
+    uint64_t global_hits = 0;    // Served from the shared free list
+    uint64_t misses = 0;         // Allocated from the system
+    uint64_t dropped = 0;        // Released to the system because of the limit
+    size_t idle_bytes = 0;       // Currently held in free lists
+    size_t peak_idle_bytes = 0;
+};
+
+// count doubles, not initialized; nullptr for count == 0
+double* allocate(size_t count);
+
+// Same, at an address that is a multiple of alignment (a power of two).
+// Alignments above 64 bytes always come from the system; the buffer is
+// returned with release(ptr, count) and pooled like any other.
+double* allocate(size_t count, size_t alignment);
+
+// Return a buffer from allocate(count) (same count)
+void release(double* ptr, size_t count);
+
+// Maximum idle bytes held by the pool (0 disables pooling); default 1 GB
+void set_limit(size_t bytes);
+size_t limit();
+
+Stats stats();
+void reset_stats();
+
+// Free all buffers in the shared list and the calling thread's list
+void trim();
+
+} // namespace pool
+} // namespace matmul
+
+#endif // BUFFER_POOL_HPP
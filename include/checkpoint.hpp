@@ -0,0 +1,129 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include "matrix.hpp"
+#include "config.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace matmul {
+namespace checkpoint {
+
+// Checkpoint of C on a global grid of tile_rows-row tiles, so progress
+// survives a different row split (--balance calibrate re-measuring, or a
+// different rank count). A rank's pieces are the grid tiles clipped to its
+// stripe. Files in the checkpoint directory:
+//   c.tiles        all of C, each piece written in place by its owner
+//   rank<R>.meta   header + global row ranges rank R completed, replaced atomically
+// A piece is only recorded in .meta after its data has been fdatasync'ed, so
+// a crash at any point leaves a consistent (possibly older) checkpoint. On
+// resume every rank reads all .meta files and skips the pieces they cover.
+class TileCheckpoint {
+public:
+    // Statistics for the run report
+    struct Stats {
+        int tiles_total = 0;
+        int tiles_resumed = 0;
+        int tiles_written = 0;
+        uint64_t bytes_written = 0;
+        int flushes = 0;
+        double submit_seconds = 0.0;   // Compute-side time spent handing tiles over
+        double writer_seconds = 0.0;   // Background time spent writing and syncing
+    };
+
+    // Open this rank's checkpoint for C rows [row_offset, row_offset +
+    // local_rows) of total_rows; with resume, load progress recorded for the
+    // same fingerprint (a mismatch starts from scratch with a warning)
+    TileCheckpoint(const std::string& dir, int rank, int row_offset, int local_rows, int total_rows,
+                   int cols, int tile_rows, uint64_t fingerprint, double interval_seconds, bool resume);
+    ~TileCheckpoint();
+
+    TileCheckpoint(const TileCheckpoint&) = delete;
+    TileCheckpoint& operator=(const TileCheckpoint&) = delete;
+
+    bool ok() const { return ok_; }
+    int num_tiles() const { return num_tiles_; }
+    bool tile_done(int tile) const { return done_[tile] != 0; }
+
+    // Local rows [tile_begin, tile_end) of a piece
+    int tile_begin(int tile) const { return bounds_[tile]; }
+    int tile_end(int tile) const { return bounds_[tile + 1]; }
+
+    // Copy completed tiles from disk into C_local; returns how many
+    int restore(Matrix& C_local);
+
+    // Hand a finished tile to the writer thread (copies its rows)
+    void submit(int tile, const Matrix& C_local);
+
+    // Drain the queue, record final progress and stop the writer
+    void finish();
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct PendingTile {
+        int tile;
+        std::vector<double> rows;
+    };
+
+    void writer_loop();
+    void flush_progress();   // fdatasync data, then publish the completed ranges
+    void load_progress(const std::string& dir, bool report);
+    off_t file_offset(int tile) const;
+
+    std::string data_path_;
+    std::string meta_path_;
+    int data_fd_ = -1;
+    int row_offset_;
+    int local_rows_;
+    int total_rows_;
+    int cols_;
+    int tile_rows_;
+    int num_tiles_;
+    std::vector<int> bounds_;      // Piece t is local rows [bounds_[t], bounds_[t + 1])
+    uint64_t fingerprint_;
+    double interval_seconds_;
+    bool ok_ = false;
+
+    std::vector<char> done_;       // Completed and durable (or restored)
+    std::vector<char> written_;    // Written by the writer, not yet synced
+
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable space_cv_;
+    std::deque<PendingTile> queue_;
+    bool stopping_ = false;
+
+    Stats stats_;
+};
+
+// Fingerprint of a problem: dimensions, tile size and a sampled hash of the
+// whole operands, so a checkpoint is never resumed against different inputs.
+// Each rank passes only its rows of A (starting at row_offset); the sampled
+// rows are hashed with their global index and XOR-reduced, so the value does
+// not depend on how the rows are split. Collective over MPI_COMM_WORLD.
+uint64_t fingerprint(const Matrix& A_local, int row_offset, int total_rows, const Matrix& B,
+                     int tile_rows);
+
+// Fill C_local (this rank's stripe, rows starting at row_offset of C = A * B,
+// A_local holding the same rows of A)
+// by calling compute_rows(row_begin, row_end) one piece of the global
+// tile_rows grid at a time. With dist.checkpoint_dir set, finished pieces are
+// persisted by a background writer and, with dist.resume, pieces covered by
+// a matching earlier run are restored instead of recomputed. Returns the
+// number of rows this rank actually computed. Collective over MPI_COMM_WORLD.
+int compute_tiles(Matrix& C_local, const Matrix& A_local, const Matrix& B,
+                   int row_offset, int tile_rows, const DistributedOptions& dist,
+                   const std::function<void(int, int)>& compute_rows);
+
+} // namespace checkpoint
+} // namespace matmul
+
+#endif // CHECKPOINT_HPP
@@ -0,0 +1,74 @@
+#ifndef COMM_HPP
+#define COMM_HPP
+
+#include "config.hpp"
+#include <mpi.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace matmul {
+namespace comm {
+
+// Collectives used for moving matrices between ranks. They behave like the
+// MPI calls they wrap and transparently apply the communication options in
+// DistributedOptions (lossless compression of large payloads, reduced
+// precision on the wire). A root or sender always keeps its exact values.
+
+// Traffic and codec statistics accumulated by this process since reset_stats()
+struct Stats {
+    uint64_t raw_bytes = 0;          // Payload bytes as doubles
+    uint64_t wire_bytes = 0;         // Bytes actually handed to MPI
+    int compressed_messages = 0;
+    int reduced_messages = 0;        // Sent as FP32 or split FP32
+    int plain_messages = 0;
+    double encode_seconds = 0.0;
+    double decode_seconds = 0.0;
+    double seconds = 0.0;            // Wall time spent inside bcast/allgatherv
+    double link_bandwidth = 0.0;     // Measured bytes/s (0 = not probed)
+    double max_abs_error = 0.0;      // Largest rounding of a value sent at reduced precision
+    double max_rel_error = 0.0;      // Same, relative to the exact value
+    std::string last_decision;       // Why the last AUTO decision went the way it did
+};
+
+Stats& stats();
+void reset_stats();
+
+// MPI_Bcast of count doubles; compressed payloads are pipelined in segments
+void bcast(double* data, size_t count, int root, MPI_Comm comm,
+           const DistributedOptions& dist);
+
+// MPI_Allgatherv of double stripes (counts/displs in elements)
+void allgatherv(const double* send, int send_count, double* recv,
+                const std::vector<int>& counts, const std::vector<int>& displs,
+                MPI_Comm comm, const DistributedOptions& dist);
+
+// Broadcast of the same buffer started repeatedly (the bandwidth probe, the
+// segment sizes of a compressed broadcast) without per-call setup. Uses MPI_Bcast_init with MPI 4, otherwise
+// persistent point-to-point requests from the root to every other rank.
+// Construction is collective over comm.
+class PersistentBcast {
+public:
+    PersistentBcast(void* buf, int count, MPI_Datatype type, int root, MPI_Comm comm);
+    ~PersistentBcast();
+
+    PersistentBcast(const PersistentBcast&) = delete;
+    PersistentBcast& operator=(const PersistentBcast&) = delete;
+
+    void start();
+    void wait();
+    bool native() const { return native_; }   // MPI_Bcast_init in use
+
+private:
+    std::vector<MPI_Request> requests_;
+    bool native_ = false;
+};
+
+// Add the accumulated statistics to dist.report (reduced over ranks;
+// collective over MPI_COMM_WORLD)
+void report(const DistributedOptions& dist);
+
+} // namespace comm
+} // namespace matmul
+
+#endif // COMM_HPP
@@ -0,0 +1,39 @@
+#ifndef COMPRESSION_HPP
+#define COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace matmul {
+namespace compression {
+
+// Lossless codec for arrays of doubles. It is a predictor plus byte-plane
+// packer, not an entropy coder: zero and repeated bytes are removed, but
+// the remaining bytes are stored as they are.
+//   1. XOR each value with its predecessor (neighbouring values share sign,
+//      exponent and leading mantissa bits, which become zero)
+//   2. Shuffle the 64-bit words into 8 byte planes
+//   3. Store each plane raw, as a single repeated byte, or as a bitmap of
+//      non-zero bytes followed by those bytes - whichever is smallest
+// Data is split into fixed-size chunks that are encoded and decoded
+// independently (in parallel with OpenMP), so a stream of chunks can be
+// pipelined with communication.
+
+// Doubles per independently coded chunk
+const size_t CHUNK_DOUBLES = 1 << 15;
+
+// Upper bound of encode() output for count doubles
+size_t max_encoded_size(size_t count);
+
+// Encode count doubles into out (replacing its contents)
+void encode(const double* data, size_t count, std::vector<uint8_t>& out);
+
+// Decode a buffer produced by encode() for the same count
+// Returns false if the buffer is malformed
+bool decode(const uint8_t* in, size_t bytes, double* data, size_t count);
+
+} // namespace compression
+} // namespace matmul
+
+#endif // COMPRESSION_HPP
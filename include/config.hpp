@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <utility>
 #include <iostream>
 #include <stdexcept>
 
@@ -12,7 +13,8 @@ namespace matmul {
 enum class Algorithm {
     NAIVE,
     STRASSEN,
-    OPENBLAS
+    OPENBLAS,
+    WINOGRAD    // Winograd's 1968 inner-product scheme
 };
 
 // Execution mode
@@ -28,6 +30,79 @@ struct OptimizationOptions {
     bool cache_friendly = false;
     bool use_blocking = false;
     int block_size = 64;
+    bool packed = false;            // Packed, register-tiled kernel (takes precedence over blocking)
+    bool streaming_stores = false;  // Packed kernel writes C tiles with non-temporal stores
+    int prefetch_distance = 0;      // Packed kernel prefetches this far ahead while packing (0: off)
+};
+
+// Row distribution across ranks for the distributed engines
+enum class LoadBalance {
+    EQUAL,      // rows_per_proc plus remainder
+    CALIBRATE,  // Proportional to a per-rank calibration kernel
+    HISTORY     // Proportional to the per-rank rates of the previous run
+};
+
+// Lossless compression of large MPI payloads
+enum class CompressionMode {
+    OFF,
+    ON,
+    AUTO        // Only when the measured link bandwidth makes it profitable
+};
+
+// Precision of matrices on the wire (computation is always FP64)
+enum class CommPrecision {
+    FP64,
+    FP32,       // Rounded to float
+    SPLIT       // Float hi part, plus the float lo remainder where it is nonzero
+};
+
+// Distributed validation: every rank checks only its own row stripe of C
+enum class DistValidation {
+    OFF,
+    STRIPE,     // Against an OpenBLAS reference of the stripe (A's rows x B)
+    VECTOR      // Against a check vector: C x vs. A (B x)
+};
+
+// BLAS library behind openblas::multiply and openblas::gemm
+enum class BlasBackend {
+    LINKED,     // Whatever find_package(BLAS) linked at build time
+    OPENBLAS,
+    BLIS,
+    MKL,
+    REFERENCE   // Netlib CBLAS (single-threaded)
+};
+
+// Statistics reported by engines and printed with the results (rank 0)
+struct RunReport {
+    std::vector<std::pair<std::string, std::string>> entries;  // (label, value)
+
+    void add(const std::string& label, const std::string& value) {
+        entries.emplace_back(label, value);
+    }
+};
+
+// Options for the distributed (MPI/Hybrid) engines
+struct DistributedOptions {
+    // Checkpoint/restart of completed C tiles
+    std::string checkpoint_dir = "";     // Empty = no checkpointing
+    double checkpoint_interval = 30.0;   // Seconds between durable progress records
+    bool resume = false;                 // Restore tiles recorded in checkpoint_dir
+
+    // Heterogeneity-aware row partitioning
+    LoadBalance balance = LoadBalance::EQUAL;
+    std::string balance_file = "";       // Per-rank rates, read (HISTORY) and rewritten
+
+    // Communication
+    CompressionMode compression = CompressionMode::OFF;
+    CommPrecision precision = CommPrecision::FP64;
+    bool comm_thread = false;            // Hybrid: dedicated thread overlapping the C exchange
+    int thread_support = 0;              // MPI thread level provided to this process
+
+    // --parallel-read: rows of A each rank parsed itself. When set, the
+    // row-striped engines receive only this rank's stripe as A
+    std::vector<int> a_stripe_rows;
+
+    RunReport* report = nullptr;         // Where engines add statistics (may be null)
 };
 
 // Configuration for matrix multiplication
@@ -35,6 +110,7 @@ struct Config {
     Algorithm algorithm = Algorithm::NAIVE;
     ExecutionMode mode = ExecutionMode::SEQUENTIAL;
     OptimizationOptions optimization;
+    DistributedOptions distributed;
 
     // Parallelization parameters
     int num_threads = 1;      // For OpenMP
@@ -44,15 +120,56 @@ struct Config {
     int matrix_size = 100;
     std::string input_file = "";   // Empty = random initialization
     std::string output_file = "";  // Derived from input_file if provided
+    bool parallel_read = false;    // Every MPI rank parses its own byte range of input_file
+    int pool_limit_mb = 1024;      // Idle Matrix buffers kept for reuse (0 = no pooling)
+    std::string binary_output_file = "";  // Result computed directly into this mapped file
 
     // Results
     double execution_time = 0.0;
+    RunReport report;
 
     // Verification options
     bool verification_mode = false;                    // Run multiple algorithms and compare
     std::vector<Algorithm> verify_algorithms;          // Algorithms to verify (for verification mode)
     std::vector<ExecutionMode> verify_modes;           // Modes to test (for verification mode)
     bool validate_against_openblas = false;            // Single-run validation against OpenBLAS
+    DistValidation dist_validation = DistValidation::OFF;  // Per-rank stripe validation (MPI-reduced)
+    BlasBackend blas_backend = BlasBackend::LINKED;    // Loaded with dlopen unless LINKED
+    std::string blas_library = "";                     // Library path (empty = search by soname)
+    int blas_threads = 0;                              // BLAS threads per rank (0 = match the run)
+    bool blas_bench = false;                           // Compare every BLAS backend that loads
+    bool transfer_bench = false;                       // MPI copy/setup overhead micro-benchmark
+    bool commbench = false;                            // Sweep collectives and fit alpha-beta
+    std::string comm_model_file = "";                  // Fitted model: written by commbench, read by runs
+    bool simulate = false;                             // Predict distributed engine scaling
+    std::string sim_params_file = "";                  // Network/node parameters for simulate
+    bool gemv_bench = false;                           // Latency/throughput of batched matrix-vector products
+    int gemv_batch = 32;                               // Most vectors per batch
+    double gemv_rate = 0.0;                            // Offered vectors/s (0 = auto)
+    bool spgemm = false;                               // Sparse x sparse multiply instead of dense
+    std::string sparse_a_file = "";                    // Matrix Market or .csr (empty = random)
+    std::string sparse_b_file = "";                    // Empty = A (with a file) or random
+    std::string sparse_output_file = "";               // Where to write the sparse C
+    int nnz_per_row = 8;                               // Density of random sparse operands
+    bool bsr = false;                                  // Block-sparse multiply vs. dense and CSR
+    int bsr_block = 32;                                // BSR block edge
+    double bsr_fill = 0.05;                            // Share of nonzero blocks in random operands
+    double bsr_threshold = 0.5;                        // Above this block density, stay dense
+    bool bilinear_bench = false;                       // Time the fast scheme catalog per shape
+    bool winograd_bench = false;                       // Winograd inner product vs naive per element type
+    std::string einsum = "";                           // Tensor contraction spec, e.g. "abk,kc->abc"
+    std::string tensor_a_file = "";                    // Binary tensor or .csv matrix (empty = random)
+    std::string tensor_b_file = "";                    // Empty = A (with a file) or random
+    std::string tensor_output_file = "";               // Where to write the contraction result
+    int tensor_extent = 32;                            // Extent of every index of random tensors
+    bool lu = false;                                   // LU factorization and solve of a random system
+    int lu_rhs = 16;                                   // Right-hand sides for --lu
+    std::string stream_b_file;                         // B for --stream (A on stdin, C on stdout)
+    int stream_block = 256;                            // Rows of A per streamed block
+    bool io_bench = false;                             // Compare binary loaders (CSV, mmap, async)
+    std::string io_file = "io_bench.bin";              // Scratch file for --io-bench
+    int io_depth = 32;                                 // Reads in flight for the async loader
+    bool writeback_bench = false;                      // Packed kernel variants across sizes
     double abs_tolerance = 1e-8;                       // Absolute error tolerance
     double rel_tolerance = 1e-5;                       // Relative error tolerance
 
@@ -67,6 +184,7 @@ inline std::string algorithm_to_string(Algorithm algo) {
         case Algorithm::NAIVE: return "Naive";
         case Algorithm::STRASSEN: return "Strassen";
         case Algorithm::OPENBLAS: return "OpenBLAS";
+        case Algorithm::WINOGRAD: return "Winograd";
         default: return "Unknown";
     }
 }
@@ -89,6 +207,7 @@ inline Algorithm parse_algorithm(const std::string& str) {
     if (lower == "naive") return Algorithm::NAIVE;
     if (lower == "strassen") return Algorithm::STRASSEN;
     if (lower == "openblas" || lower == "blas") return Algorithm::OPENBLAS;
+    if (lower == "winograd") return Algorithm::WINOGRAD;
 
     throw std::runtime_error("Unknown algorithm: " + str);
 }
@@ -105,20 +224,170 @@ inline ExecutionMode parse_execution_mode(const std::string& str) {
     throw std::runtime_error("Unknown execution mode: " + str);
 }
 
+inline std::string balance_to_string(LoadBalance balance) {
+    switch (balance) {
+        case LoadBalance::EQUAL: return "Equal";
+        case LoadBalance::CALIBRATE: return "Calibrated";
+        case LoadBalance::HISTORY: return "History";
+        default: return "Unknown";
+    }
+}
+
+inline LoadBalance parse_balance(const std::string& str) {
+    std::string lower = str;
+    for (char& c : lower) c = std::tolower(c);
+
+    if (lower == "equal") return LoadBalance::EQUAL;
+    if (lower == "calibrate" || lower == "calibrated") return LoadBalance::CALIBRATE;
+    if (lower == "history") return LoadBalance::HISTORY;
+
+    throw std::runtime_error("Unknown balance mode: " + str);
+}
+
+inline std::string compression_to_string(CompressionMode mode) {
+    switch (mode) {
+        case CompressionMode::OFF: return "Off";
+        case CompressionMode::ON: return "On";
+        case CompressionMode::AUTO: return "Auto";
+        default: return "Unknown";
+    }
+}
+
+inline CompressionMode parse_compression(const std::string& str) {
+    std::string lower = str;
+    for (char& c : lower) c = std::tolower(c);
+
+    if (lower == "off" || lower == "none") return CompressionMode::OFF;
+    if (lower == "on") return CompressionMode::ON;
+    if (lower == "auto") return CompressionMode::AUTO;
+
+    throw std::runtime_error("Unknown compression mode: " + str);
+}
+
+inline std::string precision_to_string(CommPrecision precision) {
+    switch (precision) {
+        case CommPrecision::FP64: return "FP64";
+        case CommPrecision::FP32: return "FP32";
+        case CommPrecision::SPLIT: return "Split FP32 (hi/lo)";
+        default: return "Unknown";
+    }
+}
+
+inline CommPrecision parse_precision(const std::string& str) {
+    std::string lower = str;
+    for (char& c : lower) c = std::tolower(c);
+
+    if (lower == "fp64" || lower == "double") return CommPrecision::FP64;
+    if (lower == "fp32" || lower == "float") return CommPrecision::FP32;
+    if (lower == "split") return CommPrecision::SPLIT;
+
+    throw std::runtime_error("Unknown communication precision: " + str);
+}
+
+inline std::string blas_backend_to_string(BlasBackend backend) {
+    switch (backend) {
+        case BlasBackend::LINKED: return "Linked";
+        case BlasBackend::OPENBLAS: return "OpenBLAS";
+        case BlasBackend::BLIS: return "BLIS";
+        case BlasBackend::MKL: return "MKL";
+        case BlasBackend::REFERENCE: return "Reference";
+        default: return "Unknown";
+    }
+}
+
+inline BlasBackend parse_blas_backend(const std::string& str) {
+    std::string lower = str;
+    for (char& c : lower) c = std::tolower(c);
+
+    if (lower == "linked") return BlasBackend::LINKED;
+    if (lower == "openblas") return BlasBackend::OPENBLAS;
+    if (lower == "blis") return BlasBackend::BLIS;
+    if (lower == "mkl") return BlasBackend::MKL;
+    if (lower == "reference" || lower == "netlib") return BlasBackend::REFERENCE;
+
+    throw std::runtime_error("Unknown BLAS backend: " + str);
+}
+
+inline DistValidation parse_dist_validation(const std::string& str) {
+    std::string lower = str;
+    for (char& c : lower) c = std::tolower(c);
+
+    if (lower == "off") return DistValidation::OFF;
+    if (lower == "stripe") return DistValidation::STRIPE;
+    if (lower == "vector") return DistValidation::VECTOR;
+
+    throw std::runtime_error("Unknown distributed validation: " + str);
+}
+
 // Print usage/help information
 inline void print_usage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [OPTIONS]\n\n";
     std::cout << "Matrix Multiplication with Multiple Algorithms and Parallelization Modes\n\n";
     std::cout << "OPTIONS:\n";
-    std::cout << "  -a, --algorithm <type>     Algorithm: naive, strassen, openblas (default: naive)\n";
+    std::cout << "  -a, --algorithm <type>     Algorithm: naive, strassen, openblas, winograd (default: naive)\n";
     std::cout << "  -m, --mode <type>          Execution mode: seq, omp, mpi, hybrid (default: seq)\n";
     std::cout << "  -s, --size <N>             Matrix size NxN (default: 100)\n";
     std::cout << "  -t, --threads <N>          Number of OpenMP threads (default: 4)\n";
     std::cout << "  -o, --optimize             Enable cache-friendly blocking\n";
     std::cout << "  -b, --block-size <N>       Block size for optimization (default: 64)\n";
+    std::cout << "  --packed                   Packed register-tiled kernel (Naive seq/omp and MPI stripes)\n";
+    std::cout << "  --nt-stores                Packed kernel: write C tiles with non-temporal stores\n";
+    std::cout << "  --prefetch <d>             Packed kernel: prefetch d rows/lines ahead while packing\n";
     std::cout << "  -i, --input <file>         Input CSV file (default: random matrices)\n";
+    std::cout << "  --parallel-read            Parse the input CSV on all MPI ranks in parallel\n";
+    std::cout << "  --binary-output <file>     Compute C directly into a memory-mapped binary file\n";
+    std::cout << "                             (in place for naive seq/omp and OpenBLAS; others copy)\n";
+    std::cout << "  --checkpoint <dir>         Checkpoint completed C tiles to dir (MPI/Hybrid)\n";
+    std::cout << "  --checkpoint-interval <s>  Seconds between checkpoint progress records (default: 30)\n";
+    std::cout << "  --resume                   Skip tiles already recorded in the checkpoint\n";
+    std::cout << "  --balance <mode>           Row split: equal, calibrate, history (default: equal)\n";
+    std::cout << "  --balance-file <file>      Per-rank rates for history balancing (updated each run)\n";
+    std::cout << "  --compress <mode>          Compress large MPI payloads: off, on, auto (default: off)\n";
+    std::cout << "                             (XOR + byte-plane packing of zero bytes; no entropy coder)\n";
+    std::cout << "  --comm-thread              Hybrid: one thread per rank exchanges C tiles during compute\n";
+    std::cout << "  --comm-precision <p>       Matrix precision on the wire: fp64, fp32, split (default: fp64)\n";
     std::cout << "  --validate                 Validate result against OpenBLAS\n";
+    std::cout << "  --dist-validate <mode>     Each rank validates its stripe of C: stripe, vector\n";
+    std::cout << "  --blas <name>              BLAS library: linked, openblas, blis, mkl, reference\n";
+    std::cout << "  --blas-lib <path>          Load this library for --blas instead of searching\n";
+    std::cout << "  --blas-threads <n>         BLAS threads per rank (default: match mode and ranks per node)\n";
     std::cout << "  --verify                   Verification mode (compare multiple algorithms)\n";
+    std::cout << "  --pool-limit <MB>          Idle Matrix buffers kept for reuse (default: 1024, 0 = off)\n";
+    std::cout << "  --transfer-bench           Micro-benchmark MPI copy/setup overheads at --size\n";
+    std::cout << "  --commbench                Benchmark MPI collectives, fit latency/bandwidth model\n";
+    std::cout << "  --comm-model <file>        Model written by --commbench (default: commbench.txt);\n";
+    std::cout << "                             MPI/Hybrid runs report predicted vs. actual comm time\n";
+    std::cout << "  --simulate                 Predict per-phase times of the MPI engines at many ranks\n";
+    std::cout << "  --sim-params <file>        Network/node parameters for --simulate\n";
+    std::cout << "  --gemv-bench               Batch matrix-vector products into one multiply; report\n";
+    std::cout << "                             latency and throughput per batching deadline\n";
+    std::cout << "  --gemv-batch <n>           Most vectors per batch (default: 32)\n";
+    std::cout << "  --gemv-rate <v/s>          Offered vectors per second (default: auto)\n";
+    std::cout << "  --spgemm                   Sparse x sparse multiply (seq, or omp with -t)\n";
+    std::cout << "  --sparse-a <file>          Sparse A: Matrix Market (.mtx) or raw CSR (.csr)\n";
+    std::cout << "  --sparse-b <file>          Sparse B (default: A, or random without --sparse-a)\n";
+    std::cout << "  --sparse-output <file>     Write the sparse result (.mtx or .csr)\n";
+    std::cout << "  --nnz-per-row <n>          Nonzeros per row of random sparse operands (default: 8)\n";
+    std::cout << "  --bsr                      Block-sparse (BSR) multiply, compared with dense and CSR\n";
+    std::cout << "  --bsr-block <n>            BSR block edge (default: 32)\n";
+    std::cout << "  --bsr-fill <f>             Share of nonzero blocks in random operands (default: 0.05)\n";
+    std::cout << "  --bsr-threshold <f>        Highest block density converted to BSR (default: 0.5)\n";
+    std::cout << "  --bilinear-bench           Time the fast bilinear schemes on shapes from --size\n";
+    std::cout << "  --winograd-bench           Winograd inner product vs naive for double/int64/modular\n";
+    std::cout << "  --einsum <spec>            Tensor contraction, e.g. \"abk,kc->abc\" (TTGT and batched GEMM)\n";
+    std::cout << "  --tensor-a <file>          Tensor A: binary tensor file or .csv matrix\n";
+    std::cout << "  --tensor-b <file>          Tensor B (default: A, or random without --tensor-a)\n";
+    std::cout << "  --tensor-output <file>     Write the contraction result\n";
+    std::cout << "  --tensor-extent <n>        Extent of every index of random tensors (default: 32)\n";
+    std::cout << "  --lu                       LU-factor a random size x size system and solve it\n";
+    std::cout << "  --lu-rhs <n>               Right-hand sides for --lu (default: 16)\n";
+    std::cout << "  --stream <B-file>          Stream A from stdin, write C = A x B to stdout\n";
+    std::cout << "  --stream-block <rows>      Rows per streamed block (default: 256)\n";
+    std::cout << "  --io-bench                 Time cold loads: CSV, ifstream, mmap, io_uring, O_DIRECT\n";
+    std::cout << "  --io-file <path>           Scratch file for --io-bench (default: io_bench.bin)\n";
+    std::cout << "  --io-depth <n>             Reads in flight for the async loader (default: 32)\n";
+    std::cout << "  --writeback-bench          Packed kernel with/without NT stores and prefetch, by size\n";
+    std::cout << "  --blas-bench               Time dgemm on every BLAS backend that loads, by size\n";
     std::cout << "  -h, --help                 Show this help message\n\n";
     std::cout << "EXAMPLES:\n";
     std::cout << "  # Interactive mode (if no arguments)\n";
@@ -2,6 +2,7 @@
 #define CSV_IO_HPP
 
 #include "matrix.hpp"
+#include <mpi.h>
 #include <string>
 
 namespace matmul {
@@ -12,6 +13,15 @@ public:
     // Returns true on success, false on error
     static bool read_matrix(const std::string& filename, Matrix& matrix);
 
+    // Read this rank's stripe of a CSV matrix (collective over comm)
+    // The file is memory-mapped and split into equal byte ranges; each rank
+    // parses the rows that start inside its range and learns its global row
+    // offset with a prefix scan over the row counts. No data is broadcast.
+    // Returns true on success on every rank, false on every rank otherwise.
+    static bool read_matrix_stripe(const std::string& filename, Matrix& stripe,
+                                   int& row_offset, int& total_rows,
+                                   MPI_Comm comm = MPI_COMM_WORLD);
+
     // Write a matrix to CSV file
     // Returns true on success, false on error
     static bool write_matrix(const std::string& filename, const Matrix& matrix);
@@ -0,0 +1,88 @@
+#ifndef GEMV_BATCH_HPP
+#define GEMV_BATCH_HPP
+
+#include "matrix.hpp"
+#include "config.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace matmul {
+namespace gemv {
+
+// Collects matrix-vector products y = A * x against one fixed A and runs them
+// as a single A * X multiply (X = the pending vectors as columns), so A is
+// streamed once per batch instead of once per vector. A batch starts when
+// max_batch vectors are pending or the oldest has waited deadline_seconds;
+// whatever is pending then goes into it (up to max_batch).
+//
+// The batch runs through multiply() on a local engine: MPI/Hybrid map to
+// Sequential/OpenMP, and Strassen to naive (the batch is not square).
+class GemvQueue {
+public:
+    using Callback = std::function<void(std::vector<double>&& y)>;
+
+    struct Stats {
+        uint64_t vectors = 0;
+        uint64_t batches = 0;
+        double gemm_seconds = 0.0;  // Time inside the batched multiplies
+    };
+
+    // A must outlive the queue
+    GemvQueue(const Matrix& A, const Config& config, int max_batch, double deadline_seconds);
+    ~GemvQueue();  // Runs what is still pending, then stops the worker
+
+    GemvQueue(const GemvQueue&) = delete;
+    GemvQueue& operator=(const GemvQueue&) = delete;
+
+    // x must have A.cols() entries. done runs on the worker thread.
+    void submit(std::vector<double> x, Callback done);
+    std::future<std::vector<double>> submit(std::vector<double> x);
+
+    // Block until every submitted vector has its result
+    void flush();
+
+    Stats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending {
+        std::vector<double> x;
+        Callback done;
+        Clock::time_point arrival;
+    };
+
+    void worker();
+    void run_batch(std::vector<Pending>& batch);
+
+    const Matrix& A_;
+    Config config_;
+    size_t max_batch_;
+    Clock::duration deadline_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable idle_;
+    std::deque<Pending> pending_;
+    bool busy_ = false;       // Worker is running a batch
+    bool stopping_ = false;
+    Stats stats_;
+    std::thread worker_;
+};
+
+// --gemv-bench: for a size x size A, offers vectors at a fixed rate and
+// reports throughput and latency (p50/p99) for a range of deadlines, plus
+// the unbatched baseline. rate 0 picks one between the unbatched and the
+// fully batched capacity.
+void run_benchmark(const Config& config);
+
+} // namespace gemv
+} // namespace matmul
+
+#endif // GEMV_BATCH_HPP
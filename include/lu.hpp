@@ -0,0 +1,43 @@
+#ifndef LU_HPP
+#define LU_HPP
+
+#include "matrix.hpp"
+#include "config.hpp"
+#include <vector>
+
+namespace matmul {
+namespace lu {
+
+// P A = L U with L unit lower triangular and U upper triangular, stored
+// together in lu (L below the diagonal). Row i of P A is row pivots[i] of A.
+struct Factorization {
+    Matrix lu;
+    std::vector<int> pivots;
+};
+
+struct Stats {
+    double gemm_seconds = 0.0;     // Schur complement and triangular-solve updates
+    double gemm_flops = 0.0;       // Flops performed by those updates
+    int gemm_calls = 0;
+};
+
+// Recursive LU with partial pivoting (Toledo): each call factors the left
+// half of its columns, updates the right half with a triangular solve and a
+// Schur complement A22 -= A21 * A12, then factors the rest of A22. The
+// updates (and the triangular solves' own updates) run through multiply()
+// with config's engine, so under MPI and Hybrid every rank must call this
+// with the same A. Panels of at most `base` columns are factored directly.
+// Throws std::runtime_error when a pivot is exactly zero.
+Factorization factor(const Matrix& A, const Config& config, int base = 32, Stats* stats = nullptr);
+
+// X with A X = B for every column of B, from A's factorization
+Matrix solve(const Factorization& f, const Matrix& B, const Config& config, Stats* stats = nullptr);
+
+// --lu: factors a random size x size system, solves --lu-rhs right-hand
+// sides and prints GFLOP/s, the residual norms and the HPL-scaled residual
+void run(const Config& config, int rank);
+
+} // namespace lu
+} // namespace matmul
+
+#endif // LU_HPP
@@ -40,6 +40,21 @@ public:
     Matrix(Matrix&& other) noexcept;
     ~Matrix();
 
+    // Non-owning matrix over caller-managed storage (e.g. a memory-mapped file)
+    // The storage must outlive the view; copies of a view own their data.
+    // Read-only storage is wrapped in a ConstMatrixView instead.
+    static Matrix view(double* data, int rows, int cols);
+    bool is_view() const { return ptr_ != nullptr && owned_ == nullptr; }
+
+    // Owned matrix whose elements are not zeroed, for results that are
+    // overwritten completely
+    static Matrix uninitialized(int rows, int cols);
+
+    // Same, with data() placed phase bytes past a multiple of alignment (a
+    // power of two; phase a multiple of sizeof(double)), so that file data
+    // starting at an offset congruent to phase is read into aligned memory
+    static Matrix uninitialized_aligned(int rows, int cols, size_t alignment, size_t phase);
+
     // Assignment operators
     Matrix& operator=(const Matrix& other);
     Matrix& operator=(Matrix&& other) noexcept;
@@ -86,12 +101,34 @@ public:
 private:
     int rows_;
     int cols_;
-    std::vector<double> data_;
+    double* owned_;             // Storage from the buffer pool (null for views)
+    double* ptr_;               // owned_ (+ shift_) or external storage
+    size_t shift_ = 0;          // Doubles of owned_ before ptr_ (aligned matrices)
 
     // Cache-friendly storage (row-major)
     inline int index(int row, int col) const {
         return row * cols_ + col;
     }
+
+    size_t count() const { return static_cast<size_t>(rows_) * cols_; }
+    size_t allocated() const { return count() + shift_; }
+};
+
+// Read-only view over caller-managed storage, usable wherever a const Matrix&
+// is expected. It can be neither copied nor moved, so it never turns into a
+// writable Matrix; copying the Matrix it wraps makes an owned copy.
+class ConstMatrixView {
+public:
+    ConstMatrixView(const double* data, int rows, int cols);
+
+    ConstMatrixView(const ConstMatrixView&) = delete;
+    ConstMatrixView& operator=(const ConstMatrixView&) = delete;
+
+    operator const Matrix&() const { return matrix_; }
+    const Matrix& matrix() const { return matrix_; }
+
+private:
+    Matrix matrix_;
 };
 
 } // namespace matmul
@@ -0,0 +1,61 @@
+#ifndef MPI_BENCH_HPP
+#define MPI_BENCH_HPP
+
+#include "config.hpp"
+#include <string>
+#include <vector>
+
+namespace matmul {
+namespace mpi_bench {
+
+// Micro-benchmark of the copy and setup overhead removed from the
+// distributed engines, for config.matrix_size (rank 0 prints the table):
+//   - A stripe: element-wise copy into A_local vs. a view of A
+//   - B replica: copy of B vs. a reference
+//   - Column block: pack + contiguous send + unpack vs. MPI_Type_vector in place
+//   - Panel bcast: MPI_Bcast per iteration vs. a persistent request
+// Collective over MPI_COMM_WORLD.
+void run_transfer_overheads(const Config& config);
+
+// Collectives used by the engines, in the order of CommModel::Fit::op
+enum class CommOp { BCAST, ALLGATHERV, SCATTERV, SENDRECV };
+
+std::string op_to_string(CommOp op);
+
+// Latency/bandwidth (alpha-beta) model: t(bytes) = alpha + beta * bytes,
+// fitted per collective and communicator size
+struct CommModel {
+    struct Fit {
+        CommOp op;
+        int ranks;
+        double alpha;   // Seconds
+        double beta;    // Seconds per byte
+    };
+    std::vector<Fit> fits;
+
+    // Fit for op at the closest measured communicator size (null if none)
+    const Fit* find(CommOp op, int ranks) const;
+    double predict(CommOp op, int ranks, double bytes) const;
+
+    // Text file: "commbench 1", then "<op> <ranks> <alpha> <beta>" lines
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+};
+
+// Sweep Bcast, Allgatherv, Scatterv and Sendrecv (ring shift) over message
+// sizes up to 8 * matrix_size^2 bytes (at least 4 MB) and communicator sizes
+// 2, 4, 8, ... and the full world, fit the alpha-beta model, write it to
+// config.comm_model_file and compare the model's prediction for the
+// communication of one matrix_size multiply with a measured one.
+// Collective over MPI_COMM_WORLD; rank 0 prints.
+void run_commbench(const Config& config);
+
+// Predicted (from config.comm_model_file) vs. actual communication time of
+// the finished distributed run, added to config.report on rank 0.
+// Collective over MPI_COMM_WORLD.
+void report_prediction(Config& config);
+
+} // namespace mpi_bench
+} // namespace matmul
+
+#endif // MPI_BENCH_HPP
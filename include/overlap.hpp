@@ -0,0 +1,41 @@
+#ifndef OVERLAP_HPP
+#define OVERLAP_HPP
+
+#include "matrix.hpp"
+#include "config.hpp"
+#include "partition.hpp"
+#include <functional>
+
+namespace matmul {
+namespace overlap {
+
+// Whether compute_and_allgather() can run here: needs at least
+// MPI_THREAD_FUNNELED on every rank and more than one rank (collective)
+bool available(const DistributedOptions& dist);
+
+// Compute this rank's stripe of C tile by tile while exchanging finished
+// tiles with every other rank.
+//
+// The OpenMP team has compute_threads + 1 threads. The master thread is the
+// communication thread: it pre-posts receives for all peer tiles straight
+// into C, posts sends of local tiles as soon as they are finished and keeps
+// MPI progressing with MPI_Testsome. The other threads take tiles of
+// tile_rows rows in order and call compute_rows(local_begin, local_end).
+// Only the master thread calls MPI (MPI_THREAD_FUNNELED).
+//
+// C is the full m x n result; compute_rows must write this rank's rows of it.
+// On return all of C is assembled on every rank. Returns the compute time.
+// Collective over MPI_COMM_WORLD.
+double compute_and_allgather(Matrix& C, const partition::RowPartition& part,
+                             int tile_rows, int compute_threads,
+                             const std::function<void(int, int)>& compute_rows,
+                             const DistributedOptions& dist);
+
+// Tile height shared by all ranks: about four tiles per compute thread on
+// the smallest stripe, capped at max_rows
+int tile_rows_for(const partition::RowPartition& part, int compute_threads, int max_rows);
+
+} // namespace overlap
+} // namespace matmul
+
+#endif // OVERLAP_HPP
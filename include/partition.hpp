@@ -0,0 +1,62 @@
+#ifndef PARTITION_HPP
+#define PARTITION_HPP
+
+#include "config.hpp"
+#include "matrix.hpp"
+#include <vector>
+
+namespace matmul {
+namespace partition {
+
+// Contiguous row stripes of an m-row matrix over the MPI ranks
+struct RowPartition {
+    std::vector<int> rows;      // Rows owned by each rank
+    std::vector<int> offsets;   // First global row of each rank
+
+    int local_rows(int rank) const { return rows[rank]; }
+    int row_offset(int rank) const { return offsets[rank]; }
+
+    // Counts/displacements (in elements) for gathering n-column stripes
+    void counts(int n, std::vector<int>& sendcounts, std::vector<int>& displs) const;
+};
+
+// Equal split: rows_per_proc each, the first (m % size) ranks get one more
+RowPartition equal(int m, int size);
+
+// Split proportional to weights (largest remainder rounding)
+RowPartition weighted(int m, const std::vector<double>& weights);
+
+// Time a small blocked kernel on this rank; returns GFLOP/s
+// num_threads > 1 uses the OpenMP kernel (hybrid mode)
+double calibrate(const OptimizationOptions& opt, int num_threads);
+
+// Rows of the A an engine multiplies: A.rows(), or with --parallel-read the
+// sum of dist.a_stripe_rows (A then holds only this rank's stripe)
+int global_rows(const Matrix& A, const DistributedOptions& dist);
+
+// This rank's rows of A as a read-only view, no copy
+ConstMatrixView local_rows_of(const Matrix& A, const RowPartition& part, int rank,
+                           const DistributedOptions& dist);
+
+// Partition for a distributed engine according to dist.balance:
+//   EQUAL     - equal split (no communication)
+//   CALIBRATE - every rank runs calibrate(), split by measured GFLOP/s
+//   HISTORY   - split by the per-rank rates in dist.balance_file from the
+//               previous run, falling back to CALIBRATE if unusable
+// With --parallel-read the stripes as read are used instead.
+// Collective over MPI_COMM_WORLD for CALIBRATE/HISTORY.
+RowPartition for_engine(int m, const OptimizationOptions& opt, int num_threads,
+                        const DistributedOptions& dist);
+
+// Report per-rank compute times of the finished run and, when
+// dist.balance_file is set, store the measured rates for the next run.
+// computed_rows is what this rank actually multiplied in local_seconds
+// (fewer than its share when checkpointed tiles were resumed).
+// Collective over MPI_COMM_WORLD.
+void record(int computed_rows, double local_seconds, int n, int k,
+            const DistributedOptions& dist);
+
+} // namespace partition
+} // namespace matmul
+
+#endif // PARTITION_HPP
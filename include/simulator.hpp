@@ -0,0 +1,61 @@
+#ifndef SIMULATOR_HPP
+#define SIMULATOR_HPP
+
+#include "config.hpp"
+#include "mpi_bench.hpp"
+#include <string>
+#include <vector>
+
+namespace matmul {
+namespace simulator {
+
+// Machine description for the simulation. Unset values (0) are filled in by
+// resolve_params(): the network from the --comm-model fit (or defaults), the
+// node from this machine.
+struct SimParams {
+    double latency = 0.0;          // Seconds per message (alpha)
+    double bandwidth = 0.0;        // Bytes/s per link (1/beta)
+    int cores_per_node = 0;
+    int nodes = 0;                 // 0 = as many as the ranks x threads need
+    double gflops_per_core = 0.0;  // Kernel rate of one core at the simulated size
+    std::vector<int> ranks;        // Rank counts to simulate
+    std::string network_source;    // Where latency/bandwidth came from
+    mpi_bench::CommModel measured; // Collective fits from --comm-model; used as-is
+                                   // at rank counts they were measured at
+};
+
+// Read "key value" lines (latency, bandwidth, cores_per_node, nodes,
+// gflops_per_core, ranks a,b,c); '#' starts a comment
+bool load_params(const std::string& filename, SimParams& params);
+
+// Predicted time of each phase of one multiply, slowest rank
+struct PhaseTimes {
+    double bcast = 0.0;     // A and B broadcast by main
+    double compute = 0.0;   // Local rows (largest stripe)
+    double gather = 0.0;    // C all-gather
+    double total() const { return bcast + compute + gather; }
+};
+
+enum class Engine { NAIVE_MPI, NAIVE_HYBRID, STRASSEN_MPI };
+
+std::string engine_to_string(Engine engine);
+
+// Replay an engine's schedule for an n x n multiply on `ranks` ranks:
+// collectives costed with the measured fit for that rank count if there is
+// one, otherwise with alpha-beta formulas for the algorithms MPI libraries
+// use; compute from the per-rank flops and the node's core share
+PhaseTimes simulate(Engine engine, int n, int ranks, int threads, const SimParams& params);
+
+// Fill unset parameters (rank 0; measures the kernel rate at config.matrix_size)
+void resolve_params(const Config& config, SimParams& params);
+
+// --simulate: print predicted phase times for every engine and rank count;
+// when launched on more than one rank, also run the engines for real at
+// this rank count and print measured phase times next to the prediction.
+// Collective over MPI_COMM_WORLD.
+void run(const Config& config);
+
+} // namespace simulator
+} // namespace matmul
+
+#endif // SIMULATOR_HPP
@@ -0,0 +1,100 @@
+#ifndef SPARSE_HPP
+#define SPARSE_HPP
+
+#include "matrix.hpp"
+#include "config.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace matmul {
+
+// Compressed sparse row matrix: the column indices of row i are
+// col_idx[row_ptr[i] .. row_ptr[i+1]), ascending, with values alongside
+struct CsrMatrix {
+    int rows = 0;
+    int cols = 0;
+    std::vector<int64_t> row_ptr{0};
+    std::vector<int> col_idx;
+    std::vector<double> values;
+
+    CsrMatrix() = default;
+    CsrMatrix(int rows, int cols) : rows(rows), cols(cols), row_ptr(rows + 1, 0) {}
+
+    int64_t nnz() const { return row_ptr.empty() ? 0 : row_ptr.back(); }
+
+    // Entries of A that are exactly zero are dropped
+    static CsrMatrix from_dense(const Matrix& A);
+    Matrix to_dense() const;
+
+    // rows x cols with about nnz_per_row entries per row at uniformly random
+    // columns, values in [-1, 1]
+    static CsrMatrix random(int rows, int cols, int nnz_per_row, unsigned seed = 42);
+};
+
+// Block compressed sparse row matrix: the nonzero blocks of block row I are
+// block columns col_idx[row_ptr[I] .. row_ptr[I+1]), ascending; block p is
+// the block x block row-major array at blocks[p * block * block]. Edge blocks
+// of a matrix that is not a multiple of block are zero-padded.
+struct BsrMatrix {
+    int rows = 0;
+    int cols = 0;
+    int block = 0;
+    int block_rows = 0;
+    int block_cols = 0;
+    std::vector<int64_t> row_ptr{0};
+    std::vector<int> col_idx;
+    std::vector<double> blocks;
+
+    BsrMatrix() = default;
+    BsrMatrix(int rows, int cols, int block);
+
+    int64_t nnzb() const { return row_ptr.empty() ? 0 : row_ptr.back(); }
+    double block_density() const {
+        return block_rows > 0 && block_cols > 0
+                   ? static_cast<double>(nnzb()) / (static_cast<double>(block_rows) * block_cols) : 0.0;
+    }
+    const double* block_data(int64_t p) const { return blocks.data() + p * block * block; }
+    double* block_data(int64_t p) { return blocks.data() + p * block * block; }
+
+    // Keep every block of A with a nonzero entry. Returns false (and leaves
+    // out alone) when more than max_density of the blocks are nonzero, where
+    // the dense engines are the better choice.
+    static bool from_dense(const Matrix& A, int block, double max_density, BsrMatrix& out);
+    Matrix to_dense() const;
+};
+
+class SparseIO {
+public:
+    // Matrix Market coordinate format (real, integer or pattern; general or
+    // symmetric). Duplicate entries are summed, as the format specifies.
+    // Returns true on success, false on error
+    static bool read_matrix_market(const std::string& filename, CsrMatrix& matrix);
+    static bool write_matrix_market(const std::string& filename, const CsrMatrix& matrix);
+
+    // Raw CSR arrays: "MATMULS1", int64 rows, cols, nnz, then row_ptr
+    // (int64), col_idx (int32) and values (double), native-endian
+    static bool read_csr(const std::string& filename, CsrMatrix& matrix);
+    static bool write_csr(const std::string& filename, const CsrMatrix& matrix);
+
+    // By extension: ".csr" is raw CSR, anything else Matrix Market
+    static bool read(const std::string& filename, CsrMatrix& matrix);
+    static bool write(const std::string& filename, const CsrMatrix& matrix);
+};
+
+namespace sparse {
+
+// --spgemm: C = A * B for --sparse-a/--sparse-b (B defaults to A) or random
+// size x size operands; prints nnz, phase times and nnz/s throughput
+void run_spgemm(const Config& config);
+
+// --bsr: converts block-sparse size x size operands (random with --bsr-fill
+// of the blocks nonzero, or --sparse-a/--sparse-b) to BSR and compares the
+// BSR engine with the configured dense engine and CSR SpGEMM
+void run_bsr(const Config& config);
+
+} // namespace sparse
+
+} // namespace matmul
+
+#endif // SPARSE_HPP
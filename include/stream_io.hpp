@@ -0,0 +1,93 @@
+#ifndef STREAM_IO_HPP
+#define STREAM_IO_HPP
+
+#include "config.hpp"
+#include <cstdint>
+
+namespace matmul {
+
+// Header of a framed binary stream: 64 bytes, followed by frames of an
+// int64 row count and rows * cols native-endian doubles. A frame of zero
+// rows ends the stream, so the producer need not know the row count upfront.
+struct StreamHeader {
+    char magic[8];           // "MATMULF1"
+    uint32_t version;        // Format version (1)
+    uint32_t header_size;    // Bytes before the first frame
+    int64_t cols;
+    uint64_t reserved[5];    // Zero; pads the header to 64 bytes
+};
+
+static_assert(sizeof(StreamHeader) == 64, "StreamHeader must be 64 bytes");
+
+// Reads row blocks from a file descriptor holding either a framed stream or
+// a plain binary matrix (MATMULB1), without ever holding more than the
+// caller's block
+class FrameReader {
+public:
+    explicit FrameReader(int fd) : fd_(fd) {}
+
+    // Read and check the header
+    // Returns true on success, false on error
+    bool open();
+
+    int64_t cols() const { return cols_; }
+    bool framed() const { return framed_; }
+    int64_t rows() const { return rows_; }          // Plain matrices only (-1 when framed)
+    uint64_t bytes() const { return bytes_; }
+
+    // Read up to max_rows rows into dst. Rows from later frames are added only
+    // while they are already readable, so a slow producer never stalls a
+    // block that could be computed now.
+    // Returns the rows read, 0 at the end of the stream, -1 on error
+    int read_rows(double* dst, int max_rows);
+
+private:
+    bool read_full(void* dst, size_t bytes);
+
+    int fd_;
+    bool framed_ = false;
+    bool done_ = false;
+    int64_t cols_ = 0;
+    int64_t rows_ = -1;
+    int64_t frame_left_ = 0;  // Rows of the current frame (or plain matrix) still unread
+    uint64_t bytes_ = 0;
+};
+
+// Writes row blocks to a file descriptor in the same layout as the input:
+// one frame per block for a framed stream, raw rows after a MATMULB1 header
+// otherwise
+class FrameWriter {
+public:
+    explicit FrameWriter(int fd) : fd_(fd) {}
+
+    // Write the header (rows is only used for plain matrices)
+    bool begin(int64_t cols, bool framed, int64_t rows);
+
+    // Write rows * cols doubles; a frame header and its rows go out in one writev()
+    bool write_rows(const double* src, int rows);
+
+    // End-of-stream frame (framed streams only)
+    bool finish();
+
+    uint64_t bytes() const { return bytes_; }
+
+private:
+    int fd_;
+    bool framed_ = false;
+    int64_t cols_ = 0;
+    uint64_t bytes_ = 0;
+};
+
+namespace stream {
+
+// --stream: A arrives on stdin, B is loaded once from config.stream_b_file,
+// and each block of --stream-block rows of C is written to stdout as soon as
+// it is computed. Memory stays at B plus one block of A and one of C.
+// Statistics go to stderr. Returns false on a malformed or truncated stream.
+bool run(const Config& config);
+
+} // namespace stream
+
+} // namespace matmul
+
+#endif // STREAM_IO_HPP
@@ -0,0 +1,111 @@
+#ifndef TENSOR_HPP
+#define TENSOR_HPP
+
+#include "matrix.hpp"
+#include "config.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace matmul {
+
+// Dense N-dimensional tensor, row-major (the last index is contiguous)
+class Tensor {
+public:
+    Tensor() = default;
+    explicit Tensor(std::vector<int> shape);
+
+    const std::vector<int>& shape() const { return shape_; }
+    int rank() const { return static_cast<int>(shape_.size()); }
+    int extent(int dim) const { return shape_[dim]; }
+    size_t count() const { return data_.size(); }
+
+    // Elements between consecutive values of each index
+    std::vector<int64_t> strides() const;
+
+    double* data() { return data_.data(); }
+    const double* data() const { return data_.data(); }
+
+    double& at(const std::vector<int>& index);
+    double at(const std::vector<int>& index) const;
+
+    void randomize(double min = 0.0, double max = 1.0, unsigned seed = 42);
+
+    // Rank-2 tensors and matrices share the same layout
+    static Tensor from_matrix(const Matrix& M);
+    Matrix to_matrix() const;
+
+private:
+    std::vector<int> shape_;
+    std::vector<double> data_;
+};
+
+class TensorIO {
+public:
+    // "MATMULT1", int64 rank, int64 extents[rank], then the elements as
+    // doubles, row-major and native-endian
+    static bool read_tensor(const std::string& filename, Tensor& tensor);
+    static bool write_tensor(const std::string& filename, const Tensor& tensor);
+
+    // By extension: ".csv" is a matrix (rank 2) through CsvIO, anything
+    // else the binary tensor format
+    static bool read(const std::string& filename, Tensor& tensor);
+    static bool write(const std::string& filename, const Tensor& tensor);
+};
+
+namespace tensor {
+
+// out has extents in.extent(perm[d]) and out[..., i_d, ...] = in[... i_d at
+// position perm[d] ...]. Contiguous runs are copied row by row; otherwise the
+// two unit-stride indices are transposed in cache-sized tiles. Parallel over
+// the remaining indices with OpenMP.
+Tensor permute(const Tensor& in, const std::vector<int>& perm, int num_threads);
+
+// How contract() maps a contraction onto matrix products
+enum class Strategy {
+    AUTO,      // Batched when no operand has to move, else TTGT
+    TTGT,      // Transpose operands into [batch, m, k] x [batch, k, n], GEMM, transpose C
+    BATCHED    // One GEMM per batch entry, straight on strided slices
+};
+
+struct Plan {
+    // Index letters of each group, in the order they are fused
+    std::string batch, m, n, k;
+    int64_t batch_size = 1, m_size = 1, n_size = 1, k_size = 1;
+    bool batched = false;                  // Strided slices, no copies
+    bool permute_a = false, permute_b = false, permute_c = false;
+
+    std::string describe() const;
+};
+
+struct Stats {
+    Plan plan;
+    double permute_seconds = 0.0;          // Operands in, result out
+    double gemm_seconds = 0.0;
+};
+
+// Einsum-style contraction, e.g. "abk,kc->abc" or "bij,bjk->bik": indices in
+// both operands but not the output are summed, indices in the output must
+// appear in an operand. Throws std::runtime_error for a malformed spec,
+// repeated or unmatched indices and extent mismatches, and for BATCHED when
+// an operand's layout does not allow it.
+//
+// Contiguous slices run through multiply_into() with config's engine (MPI
+// and Hybrid run locally as Sequential and OpenMP); strided slices call
+// OpenBLAS with leading dimensions.
+Tensor contract(const std::string& spec, const Tensor& A, const Tensor& B, const Config& config,
+                Strategy strategy = Strategy::AUTO, Stats* stats = nullptr);
+
+// Direct loop over every index, for validation
+Tensor contract_reference(const std::string& spec, const Tensor& A, const Tensor& B);
+
+// --einsum: contracts --tensor-a/--tensor-b (random operands with every
+// extent --tensor-extent otherwise) with both strategies and prints the plan,
+// permutation and GEMM times
+void run_einsum(const Config& config);
+
+} // namespace tensor
+
+} // namespace matmul
+
+#endif // TENSOR_HPP
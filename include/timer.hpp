@@ -1,11 +1,53 @@
 #ifndef TIMER_HPP
 #define TIMER_HPP
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MATMUL_HAVE_TSC 1
+#endif
 
 namespace matmul {
 
+// Monotonic tick source for timing short kernel phases. Reads the invariant
+// TSC (rdtscp, fenced so later work cannot start before the read) when the
+// CPU has one, calibrated once against CLOCK_MONOTONIC_RAW; otherwise falls
+// back to std::chrono::steady_clock with nanosecond ticks.
+class CycleClock {
+public:
+    static uint64_t now() {
+#ifdef MATMUL_HAVE_TSC
+        if (uses_tsc()) {
+            unsigned int aux;
+            uint64_t ticks = __rdtscp(&aux);
+            _mm_lfence();
+            return ticks;
+        }
+#endif
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static double seconds_per_tick() { return calibration().seconds_per_tick; }
+    static bool uses_tsc() { return calibration().tsc; }
+
+    // e.g. "TSC 2.995 GHz (invariant)" or "steady_clock (no invariant TSC)"
+    static std::string description();
+
+private:
+    struct Calibration {
+        bool tsc;
+        double seconds_per_tick;
+    };
+    static const Calibration& calibration();
+};
+
 class Timer {
 public:
     Timer();
@@ -24,14 +66,80 @@ public:
     std::string elapsed_string() const;
 
 private:
-    using Clock = std::chrono::high_resolution_clock;
-    using TimePoint = std::chrono::time_point<Clock>;
-
-    TimePoint start_time_;
-    TimePoint stop_time_;
+    uint64_t start_ticks_;
+    uint64_t stop_ticks_;
     bool is_running_;
 };
 
+// Time spent in one named phase, summed over every thread that enters it.
+// Each thread adds into its own cache-line slot, so accumulating needs no
+// atomic read-modify-write and threads never contend.
+class PhaseAccumulator {
+public:
+    static const int MAX_THREADS = 256;
+
+    explicit PhaseAccumulator(const std::string& name);
+    ~PhaseAccumulator();
+
+    PhaseAccumulator(const PhaseAccumulator&) = delete;
+    PhaseAccumulator& operator=(const PhaseAccumulator&) = delete;
+
+    void add(uint64_t ticks) {
+        Slot& slot = slots_[thread_slot()];
+        slot.ticks.store(slot.ticks.load(std::memory_order_relaxed) + ticks,
+                         std::memory_order_relaxed);
+        slot.calls.store(slot.calls.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+    }
+
+    const std::string& name() const { return name_; }
+    double seconds() const;
+    uint64_t calls() const;
+    void reset();
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> calls{0};
+    };
+
+    // Small per-thread index handed out on first use
+    static int thread_slot();
+
+    std::string name_;
+    std::unique_ptr<Slot[]> slots_;
+};
+
+// Adds the lifetime of the scope to a phase
+class ScopedTimer {
+public:
+    explicit ScopedTimer(PhaseAccumulator& phase) : phase_(phase), start_(CycleClock::now()) {}
+    ~ScopedTimer() { phase_.add(CycleClock::now() - start_); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    PhaseAccumulator& phase_;
+    uint64_t start_;
+};
+
+namespace phases {
+
+struct PhaseTotal {
+    std::string name;
+    double seconds;
+    uint64_t calls;
+};
+
+// Zero every registered phase (before the timed region)
+void reset_all();
+
+// Totals of every phase that was entered since the last reset
+std::vector<PhaseTotal> totals();
+
+} // namespace phases
+
 } // namespace matmul
 
 #endif // TIMER_HPP
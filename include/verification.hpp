@@ -22,6 +22,20 @@ bool validate_against_reference(const Matrix& result,
                                 Algorithm algo,
                                 const Config& config);
 
+// Distributed validation (collective over MPI_COMM_WORLD): each rank checks
+// only its equal-split row stripe of C, either against an OpenBLAS
+// reference of that stripe (DistValidation::STRIPE) or with a check vector x,
+// comparing C x against A (B x) row by row (DistValidation::VECTOR). The
+// per-rank ComparisonResults are combined with a custom MPI_Op: sums and
+// counts add, the maxima keep their location. Rank 0 prints the report.
+// Returns the combined verdict on every rank.
+bool validate_distributed(const Matrix& C,
+                          const Matrix& A,
+                          const Matrix& B,
+                          const Config& config,
+                          int rank,
+                          int size);
+
 // Run full verification suite comparing multiple algorithms
 // Only works in Sequential/OpenMP modes (not MPI)
 void run_verification_suite(const Matrix& A,
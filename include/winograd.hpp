@@ -0,0 +1,67 @@
+#ifndef WINOGRAD_HPP
+#define WINOGRAD_HPP
+
+#include "config.hpp"
+#include <cstdint>
+
+namespace matmul {
+namespace winograd {
+
+// Integers modulo the prime 998244353. A product is a 64-bit multiply plus a
+// reduction, several times the cost of an addition, which is the case the
+// inner-product scheme is for.
+struct Modular {
+    static constexpr uint32_t P = 998244353;
+    uint32_t v = 0;
+
+    Modular() = default;
+    explicit Modular(uint64_t x) : v(static_cast<uint32_t>(x % P)) {}
+
+    friend Modular operator+(Modular a, Modular b) {
+        uint32_t s = a.v + b.v;  // < 2P < 2^31
+        return raw(s >= P ? s - P : s);
+    }
+    friend Modular operator-(Modular a, Modular b) {
+        return raw(a.v >= b.v ? a.v - b.v : a.v + P - b.v);
+    }
+    friend Modular operator*(Modular a, Modular b) {
+        return raw(static_cast<uint32_t>(static_cast<uint64_t>(a.v) * b.v % P));
+    }
+    Modular& operator+=(Modular b) { return *this = *this + b; }
+    friend bool operator==(Modular a, Modular b) { return a.v == b.v; }
+
+private:
+    static Modular raw(uint32_t x) {
+        Modular m;
+        m.v = x;
+        return m;
+    }
+};
+
+// Winograd's 1968 inner-product scheme: with row factors
+//   r_i = sum_j a[i][2j] * a[i][2j+1]   and   c_c = sum_j b[2j][c] * b[2j+1][c]
+// each entry is
+//   C[i][c] = sum_j (a[i][2j] + b[2j+1][c]) * (a[i][2j+1] + b[2j][c]) - r_i - c_c
+// (plus a[i][k-1] * b[k-1][c] for odd k), so an m x k by k x n product takes
+// about m*n*k/2 multiplications instead of m*n*k, for ~m*n*k/2 more additions.
+//
+// C = A * B for row-major m x k and k x n arrays (C is m x n, overwritten).
+// Instantiated for double, int64_t, uint64_t and Modular; int64_t entries are
+// computed modulo 2^64, so C is exact whenever every entry fits.
+template <typename T>
+void multiply(int m, int k, int n, const T* A, const T* B, T* C, int num_threads);
+template <>
+void multiply<int64_t>(int m, int k, int n, const int64_t* A, const int64_t* B, int64_t* C,
+                       int num_threads);
+
+// Multiplications performed by multiply() for an m x k by k x n product
+int64_t multiplications(int m, int k, int n);
+
+// --winograd-bench: times the scheme against the naive kernels for double,
+// int64 and modular elements on size x size operands and checks the results
+void run_benchmark(const Config& config);
+
+} // namespace winograd
+} // namespace matmul
+
+#endif // WINOGRAD_HPP
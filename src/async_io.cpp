@@ -0,0 +1,656 @@
+#include "async_io.hpp"
+#include "binary_io.hpp"
+#include "csv_io.hpp"
+#include "timer.hpp"
+#include <omp.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+    #include <sys/syscall.h>
+    #define MATMUL_HAVE_IO_URING 1
+#endif
+
+namespace matmul {
+
+namespace {
+
+struct Alignment {
+    size_t memory;   // Buffer address
+    size_t offset;   // File offset and length
+};
+
+// O_DIRECT alignment of fd's file; 4096 is safe on every block device
+Alignment dio_alignment(int fd) {
+#ifdef STATX_DIOALIGN
+    struct statx st;
+    if (statx(fd, "", AT_EMPTY_PATH, STATX_DIOALIGN, &st) == 0 && (st.stx_mask & STATX_DIOALIGN) &&
+        st.stx_dio_offset_align != 0) {
+        return {std::max<size_t>(st.stx_dio_mem_align, 1), st.stx_dio_offset_align};
+    }
+#else
+    (void)fd;
+#endif
+    return {4096, 4096};
+}
+
+// One read request: `length` bytes at file `offset` into dst, or into an
+// aligned bounce buffer whose bytes [skip, skip + copy) then go to dst
+struct Chunk {
+    uint64_t offset;
+    size_t length;
+    char* dst;
+    size_t skip;
+    size_t copy;
+    bool bounce;
+};
+
+// Chunks for the data section [begin, end) of the file, landing at data.
+// With O_DIRECT the chunk grid is aligned in file offsets and the storage is
+// allocated to line up with it, so only the first chunk (shared with the
+// header) and the last one need bouncing.
+std::vector<Chunk> plan_chunks(char* data, uint64_t begin, uint64_t end, size_t chunk_bytes,
+                               bool direct, Alignment align) {
+    std::vector<Chunk> chunks;
+    if (!direct) {
+        for (uint64_t start = begin; start < end; start += chunk_bytes) {
+            size_t length = static_cast<size_t>(std::min<uint64_t>(chunk_bytes, end - start));
+            chunks.push_back({start, length, data + (start - begin), 0, length, false});
+        }
+        return chunks;
+    }
+
+    for (uint64_t grid = begin - begin % chunk_bytes; grid < end; grid += chunk_bytes) {
+        uint64_t start = std::max(grid, begin);
+        uint64_t stop = std::min<uint64_t>(grid + chunk_bytes, end);
+        uint64_t aligned_start = start - start % align.offset;
+        uint64_t aligned_stop = (stop + align.offset - 1) / align.offset * align.offset;
+        char* dst = data + (start - begin);
+        bool bounce = aligned_start != start || aligned_stop != stop ||
+                      reinterpret_cast<uintptr_t>(dst) % align.memory != 0;
+        if (bounce) {
+            chunks.push_back({aligned_start, static_cast<size_t>(aligned_stop - aligned_start), dst,
+                              static_cast<size_t>(start - aligned_start), static_cast<size_t>(stop - start),
+                              true});
+        } else {
+            size_t length = static_cast<size_t>(stop - start);
+            chunks.push_back({start, length, dst, 0, length, false});
+        }
+    }
+    return chunks;
+}
+
+// Bytes of a chunk's read that must arrive (a bounced tail read may stop at EOF)
+size_t needed(const Chunk& c) {
+    return c.bounce ? c.skip + c.copy : c.length;
+}
+
+struct FreeDeleter {
+    void operator()(char* p) const { std::free(p); }
+};
+using AlignedBuffer = std::unique_ptr<char, FreeDeleter>;
+
+AlignedBuffer aligned_buffer(size_t bytes, size_t align) {
+    align = std::max<size_t>(align, 4096);
+    void* p = std::aligned_alloc(align, (bytes + align - 1) / align * align);
+    if (p == nullptr) throw std::bad_alloc();
+    return AlignedBuffer(static_cast<char*>(p));
+}
+
+// Finish a read that stopped short after `done` bytes, synchronously (short
+// reads only happen at EOF). base is where byte 0 of the read lands. Under
+// O_DIRECT the remainder generally starts off the alignment grid, so it is
+// re-read from the aligned offset below it through an aligned buffer.
+bool read_rest(int fd, const Chunk& c, char* base, size_t done, bool direct, Alignment align) {
+    size_t from = direct ? done - done % align.offset : done;
+    AlignedBuffer scratch;
+    char* buf = base + from;
+    if (direct) {
+        scratch = aligned_buffer(c.length - from, align.memory);
+        buf = scratch.get();
+    }
+    size_t got = 0;
+    while (from + got < needed(c)) {
+        ssize_t n = pread(fd, buf + got, c.length - from - got, static_cast<off_t>(c.offset + from + got));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        got += static_cast<size_t>(n);
+    }
+    if (direct) std::memcpy(base + done, buf + (done - from), needed(c) - done);
+    return true;
+}
+
+// pread() from a pool of threads, each with its own bounce buffer
+bool read_threads(int fd, const std::vector<Chunk>& chunks, int threads, size_t buffer_bytes,
+                  bool direct, Alignment align) {
+    std::atomic<bool> ok(true);
+    bool any_bounce = std::any_of(chunks.begin(), chunks.end(), [](const Chunk& c) { return c.bounce; });
+    int count = static_cast<int>(chunks.size());
+
+    #pragma omp parallel num_threads(threads)
+    {
+        AlignedBuffer bounce;
+        if (any_bounce) bounce = aligned_buffer(buffer_bytes, align.memory);
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int i = 0; i < count; ++i) {
+            if (!ok.load(std::memory_order_relaxed)) continue;
+            const Chunk& c = chunks[i];
+            char* buf = c.bounce ? bounce.get() : c.dst;
+            ssize_t n;
+            do {
+                n = pread(fd, buf, c.length, static_cast<off_t>(c.offset));
+            } while (n < 0 && errno == EINTR);
+            bool read = n >= 0 && (static_cast<size_t>(n) >= needed(c) ||
+                                   (n > 0 && read_rest(fd, c, buf, static_cast<size_t>(n), direct, align)));
+            if (!read) {
+                ok.store(false, std::memory_order_relaxed);
+            } else if (c.bounce) {
+                std::memcpy(c.dst, buf + c.skip, c.copy);
+            }
+        }
+    }
+    return ok.load();
+}
+
+#ifdef MATMUL_HAVE_IO_URING
+
+// Minimal io_uring over the raw system calls (no liburing): one submission
+// and one completion ring, no SQPOLL, so the kernel reads submissions only
+// inside io_uring_enter()
+class Ring {
+public:
+    Ring() = default;
+    ~Ring() {
+        if (sqes_ != nullptr) munmap(sqes_, sqes_bytes_);
+        if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_bytes_);
+        if (sq_ring_ != nullptr) munmap(sq_ring_, sq_bytes_);
+        if (fd_ >= 0) close(fd_);
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    bool init(unsigned entries) {
+        struct io_uring_params p;
+        std::memset(&p, 0, sizeof(p));
+        fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &p));
+        if (fd_ < 0) return false;
+
+        sq_bytes_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_bytes_ = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+        bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) sq_bytes_ = cq_bytes_ = std::max(sq_bytes_, cq_bytes_);
+
+        sq_ring_ = map(sq_bytes_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == nullptr) return false;
+        cq_ring_ = single ? sq_ring_ : map(cq_bytes_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == nullptr) return false;
+        sqes_bytes_ = p.sq_entries * sizeof(struct io_uring_sqe);
+        sqes_ = static_cast<struct io_uring_sqe*>(map(sqes_bytes_, IORING_OFF_SQES));
+        if (sqes_ == nullptr) return false;
+
+        char* sq = static_cast<char*>(sq_ring_);
+        char* cq = static_cast<char*>(cq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sq_entries_ = p.sq_entries;
+        sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + p.cq_off.cqes);
+        return true;
+    }
+
+    unsigned capacity() const { return sq_entries_; }
+
+    // IORING_OP_READ arrived in 5.6, together with the probe itself
+    bool supports_read() {
+#ifdef IO_URING_OP_SUPPORTED   // Defined with the probe interface
+        const unsigned ops = 256;
+        std::vector<char> raw(sizeof(struct io_uring_probe) + ops * sizeof(struct io_uring_probe_op), 0);
+        struct io_uring_probe* probe = reinterpret_cast<struct io_uring_probe*>(raw.data());
+        if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, ops) < 0) return false;
+        return probe->ops_len > IORING_OP_READ &&
+               (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) != 0;
+#else
+        return false;
+#endif
+    }
+
+    // Queue a read; the caller keeps at most capacity() in flight
+    void push_read(int fd, void* buf, size_t length, uint64_t offset, uint64_t user_data) {
+        unsigned tail = *sq_tail_;
+        unsigned index = tail & sq_mask_;
+        struct io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buf);
+        sqe->len = static_cast<uint32_t>(length);
+        sqe->off = offset;
+        sqe->user_data = user_data;
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        ++pending_;
+    }
+
+    // Submit everything queued and wait for at least one completion
+    bool submit_and_wait() {
+        while (true) {
+            long rc = syscall(__NR_io_uring_enter, fd_, pending_, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (rc >= 0) {
+                pending_ -= static_cast<unsigned>(rc);
+                return true;
+            }
+            if (errno != EINTR) return false;
+        }
+    }
+
+    // Wait for a completion without submitting anything
+    bool wait() {
+        while (true) {
+            long rc = syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (rc >= 0) return true;
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) return false;
+        }
+    }
+
+    // Take back the reads queued since the last submission (the kernel only
+    // consumes the submission ring inside io_uring_enter); returns how many
+    unsigned discard_pending() {
+        unsigned dropped = pending_;
+        __atomic_store_n(sq_tail_, *sq_tail_ - dropped, __ATOMIC_RELEASE);
+        pending_ = 0;
+        return dropped;
+    }
+
+    bool pop(struct io_uring_cqe& out) {
+        unsigned head = *cq_head_;
+        if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) return false;
+        out = cqes_[head & cq_mask_];
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+private:
+    void* map(size_t bytes, off_t offset) {
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    int fd_ = -1;
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    size_t sq_bytes_ = 0, cq_bytes_ = 0, sqes_bytes_ = 0;
+    struct io_uring_sqe* sqes_ = nullptr;
+    struct io_uring_cqe* cqes_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned sq_mask_ = 0, cq_mask_ = 0, sq_entries_ = 0;
+    unsigned pending_ = 0;   // Queued but not yet submitted
+};
+
+// Keeps up to depth reads in flight. A short read (at EOF) is finished by
+// read_rest(). After an error no new chunks are issued, but the reads still
+// in flight are reaped before their buffers are released. first_error is
+// the first failure's -errno (0 if none).
+bool read_uring(Ring& ring, int fd, const std::vector<Chunk>& chunks, size_t buffer_bytes, bool direct,
+                Alignment align, int& first_error) {
+    int depth = static_cast<int>(ring.capacity());
+    bool any_bounce = std::any_of(chunks.begin(), chunks.end(), [](const Chunk& c) { return c.bounce; });
+
+    struct Request {
+        size_t chunk;
+        size_t done;
+    };
+    std::vector<Request> requests(depth);
+    std::vector<AlignedBuffer> buffers(any_bounce ? depth : 0);
+    for (AlignedBuffer& b : buffers) b = aligned_buffer(buffer_bytes, align.memory);
+    std::vector<int> free_slots;
+    for (int s = depth - 1; s >= 0; --s) free_slots.push_back(s);
+
+    auto target = [&](int slot) {
+        const Chunk& c = chunks[requests[slot].chunk];
+        return c.bounce ? buffers[slot].get() : c.dst;
+    };
+
+    size_t next = 0;
+    int in_flight = 0;
+    bool ok = true;
+    first_error = 0;
+    while (true) {
+        while (ok && next < chunks.size() && !free_slots.empty()) {
+            int slot = free_slots.back();
+            free_slots.pop_back();
+            requests[slot] = {next++, 0};
+            const Chunk& c = chunks[requests[slot].chunk];
+            ring.push_read(fd, target(slot), c.length, c.offset, static_cast<uint64_t>(slot));
+            ++in_flight;
+        }
+        if (in_flight == 0) break;
+        if (ok && !ring.submit_and_wait()) {
+            ok = false;
+            first_error = -errno;
+        }
+        if (!ok) {
+            // What was not submitted never completes; what was must still be
+            // drained before its buffers go away
+            in_flight -= static_cast<int>(ring.discard_pending());
+            if (in_flight == 0) break;
+            if (!ring.wait()) {
+                // The kernel may still write into the buffers; freeing them would be worse
+                std::cerr << "Error: Lost track of io_uring reads in flight\n";
+                std::abort();
+            }
+        }
+
+        struct io_uring_cqe cqe;
+        while (ring.pop(cqe)) {
+            int slot = static_cast<int>(cqe.user_data);
+            Request& r = requests[slot];
+            const Chunk& c = chunks[r.chunk];
+            if (cqe.res > 0) r.done = static_cast<size_t>(cqe.res);
+            if (cqe.res <= 0) {
+                if (first_error == 0) first_error = cqe.res < 0 ? cqe.res : -EIO;
+                ok = false;
+            } else if (ok && r.done < needed(c) && !read_rest(fd, c, target(slot), r.done, direct, align)) {
+                if (first_error == 0) first_error = -EIO;
+                ok = false;
+            } else if (ok && c.bounce) {
+                std::memcpy(c.dst, buffers[slot].get() + c.skip, c.copy);
+            }
+            free_slots.push_back(slot);
+            --in_flight;
+        }
+    }
+    return ok;
+}
+
+#endif
+
+} // namespace
+
+const char* backend_to_string(AsyncBackend backend) {
+    switch (backend) {
+        case AsyncBackend::AUTO: return "auto";
+        case AsyncBackend::IO_URING: return "io_uring";
+        case AsyncBackend::THREADS: return "thread pool";
+    }
+    return "unknown";
+}
+
+bool AsyncIO::io_uring_available() {
+#ifdef MATMUL_HAVE_IO_URING
+    Ring ring;
+    return ring.init(1) && ring.supports_read();
+#else
+    return false;
+#endif
+}
+
+bool AsyncIO::read_matrix(const std::string& filename, Matrix& matrix, const AsyncReadOptions& options,
+                          AsyncReadStats* stats) {
+    Timer timer;
+    timer.start();
+
+    // The header is read through the page cache: O_DIRECT needs an aligned buffer
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open file '" << filename << "'\n";
+        return false;
+    }
+    BinaryMatrixHeader header;
+    struct stat st;
+    bool valid = pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                 BinaryIO::valid_header(header) && fstat(fd, &st) == 0;
+    if (!valid) {
+        close(fd);
+        std::cerr << "Error: '" << filename << "' is not a binary matrix file\n";
+        return false;
+    }
+    uint64_t begin = header.header_size;
+    uint64_t end = begin + static_cast<uint64_t>(header.rows) * header.cols * sizeof(double);
+    if (static_cast<uint64_t>(st.st_size) < end) {
+        close(fd);
+        std::cerr << "Error: '" << filename << "' is truncated\n";
+        return false;
+    }
+
+    bool direct = false;
+    if (options.direct) {
+        int direct_fd = open(filename.c_str(), O_RDONLY | O_DIRECT);
+        if (direct_fd >= 0) {  // Otherwise (tmpfs, some network file systems) stay buffered
+            close(fd);
+            fd = direct_fd;
+            direct = true;
+        }
+    }
+    Alignment align = direct ? dio_alignment(fd) : Alignment{1, 1};
+    size_t chunk_bytes = std::max<size_t>(options.chunk_bytes, align.offset);
+    chunk_bytes = (chunk_bytes + align.offset - 1) / align.offset * align.offset;
+    int depth = std::max(options.queue_depth, 1);
+
+    // Under O_DIRECT the storage takes the file's phase against the alignment,
+    // so every chunk on the aligned grid lands on an aligned address
+    int rows = static_cast<int>(header.rows);
+    int cols = static_cast<int>(header.cols);
+    if (direct && begin % sizeof(double) == 0) {
+        matrix = Matrix::uninitialized_aligned(rows, cols, align.memory, begin % align.memory);
+    } else {
+        matrix = Matrix::uninitialized(rows, cols);
+    }
+    std::vector<Chunk> chunks =
+        plan_chunks(reinterpret_cast<char*>(matrix.data()), begin, end, chunk_bytes, direct, align);
+
+    AsyncBackend used = AsyncBackend::THREADS;
+    bool ok = false;
+    bool done = false;
+#ifdef MATMUL_HAVE_IO_URING
+    if (options.backend != AsyncBackend::THREADS) {
+        Ring ring;
+        if (ring.init(static_cast<unsigned>(depth)) && ring.supports_read()) {
+            int error = 0;
+            used = AsyncBackend::IO_URING;
+            ok = read_uring(ring, fd, chunks, chunk_bytes, direct, align, error);
+            // -EINVAL for the opcode itself (older kernels): AUTO redoes the file with the pool
+            done = ok || options.backend == AsyncBackend::IO_URING || error != -EINVAL;
+        }
+    }
+#endif
+    if (!done && options.backend == AsyncBackend::IO_URING) {
+        close(fd);
+        std::cerr << "Error: io_uring is not available\n";
+        return false;
+    }
+    if (!done) {
+        used = AsyncBackend::THREADS;
+        ok = read_threads(fd, chunks, depth, chunk_bytes, direct, align);
+    }
+    close(fd);
+
+    timer.stop();
+    if (stats) {
+        stats->backend = used;
+        stats->direct = direct;
+        stats->chunks = chunks.size();
+        stats->bounced = std::count_if(chunks.begin(), chunks.end(), [](const Chunk& c) { return c.bounce; });
+        stats->seconds = timer.elapsed_seconds();
+    }
+    if (!ok) {
+        std::cerr << "Error: Reading '" << filename << "' failed\n";
+    }
+    return ok;
+}
+
+namespace async_io {
+
+namespace {
+
+// Write back and drop filename's pages so the next read comes from the device
+void evict(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+// Share of filename's pages resident in the page cache
+double cached_fraction(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return 0.0;
+    struct stat st;
+    double fraction = 0.0;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        size_t bytes = static_cast<size_t>(st.st_size);
+        void* addr = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            std::vector<unsigned char> resident((bytes + page - 1) / page);
+            if (mincore(addr, bytes, resident.data()) == 0) {
+                size_t count = std::count_if(resident.begin(), resident.end(),
+                                             [](unsigned char r) { return (r & 1) != 0; });
+                fraction = static_cast<double>(count) / resident.size();
+            }
+            munmap(addr, bytes);
+        }
+    }
+    close(fd);
+    return fraction;
+}
+
+uint64_t file_bytes(const std::string& filename) {
+    struct stat st;
+    return stat(filename.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+// The mmap baseline: map the file and copy the data section out
+bool read_mmap(const std::string& filename, Matrix& matrix) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    bool ok = false;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(BinaryMatrixHeader)) {
+        size_t bytes = static_cast<size_t>(st.st_size);
+        void* addr = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            madvise(addr, bytes, MADV_SEQUENTIAL);
+            const BinaryMatrixHeader* header = static_cast<const BinaryMatrixHeader*>(addr);
+            size_t data_bytes = static_cast<size_t>(header->rows) * header->cols * sizeof(double);
+            if (BinaryIO::valid_header(*header) && header->header_size + data_bytes <= bytes) {
+                matrix = Matrix::uninitialized(static_cast<int>(header->rows), static_cast<int>(header->cols));
+                std::memcpy(matrix.data(), static_cast<const char*>(addr) + header->header_size, data_bytes);
+                ok = true;
+            }
+            munmap(addr, bytes);
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+} // namespace
+
+void run_benchmark(const Config& config) {
+    int N = config.matrix_size;
+    const std::string& path = config.io_file;
+    std::string csv_path = path + ".csv";
+
+    Matrix M(N, N);
+    M.randomize(-1.0, 1.0);
+    std::cout << "\nAsynchronous binary loader, " << N << "x" << N << " ("
+              << std::fixed << std::setprecision(1)
+              << static_cast<double>(N) * N * sizeof(double) / (1024.0 * 1024.0) << " MB of doubles), "
+              << path << "\n";
+    if (!BinaryIO::write_matrix(path, M) || !CsvIO::write_matrix(csv_path, M)) {
+        std::cerr << "Error: Could not write the benchmark files\n";
+        return;
+    }
+
+    struct Method {
+        std::string name;
+        std::string file;
+        bool exact;
+        std::function<bool(Matrix&, AsyncReadStats&)> read;
+    };
+    auto async = [&](AsyncBackend backend, bool direct) {
+        return [backend, direct, &path, &config](Matrix& R, AsyncReadStats& s) {
+            AsyncReadOptions options;
+            options.backend = backend;
+            options.direct = direct;
+            options.queue_depth = config.io_depth;
+            return AsyncIO::read_matrix(path, R, options, &s);
+        };
+    };
+    std::vector<Method> methods = {
+        {"CsvIO", csv_path, false, [&](Matrix& R, AsyncReadStats&) { return CsvIO::read_matrix(csv_path, R); }},
+        {"ifstream", path, true, [&](Matrix& R, AsyncReadStats&) { return BinaryIO::read_matrix(path, R); }},
+        {"mmap + copy", path, true, [&](Matrix& R, AsyncReadStats&) { return read_mmap(path, R); }},
+        {"Thread pool", path, true, async(AsyncBackend::THREADS, false)},
+        {"Thread pool+DIO", path, true, async(AsyncBackend::THREADS, true)},
+    };
+    if (AsyncIO::io_uring_available()) {
+        methods.push_back({"io_uring", path, true, async(AsyncBackend::IO_URING, false)});
+        methods.push_back({"io_uring+DIO", path, true, async(AsyncBackend::IO_URING, true)});
+    } else {
+        std::cout << "io_uring is not available; skipping it\n";
+    }
+
+    std::cout << "Cold reads (pages dropped before each), " << config.io_depth << " reads in flight\n\n";
+    std::cout << std::left << std::setw(18) << "  Method" << std::right << std::setw(10) << "Time (s)"
+              << std::setw(10) << "GB/s" << std::setw(12) << "Cached" << std::setw(12) << "Bounced"
+              << std::setw(10) << "Check" << "\n";
+    std::cout << "  " << std::string(70, '-') << "\n";
+
+    for (const Method& m : methods) {
+        evict(m.file);
+        Matrix R;
+        AsyncReadStats s;
+        Timer timer;
+        timer.start();
+        bool ok = m.read(R, s);
+        timer.stop();
+        double seconds = timer.elapsed_seconds();
+
+        std::string check = "FAILED";
+        if (ok && R.rows() == N && R.cols() == N) {
+            size_t bytes = static_cast<size_t>(N) * N * sizeof(double);
+            check = m.exact ? (std::memcmp(R.data(), M.data(), bytes) == 0 ? "exact" : "MISMATCH")
+                            : (R.equals(M, 1e-6) ? "1e-6" : "MISMATCH");
+        }
+        std::string bounced = s.chunks > 0 ? std::to_string(s.bounced) + "/" + std::to_string(s.chunks) : "-";
+        if (s.chunks > 0 && m.name.find("DIO") != std::string::npos && !s.direct) bounced += " (buffered)";
+
+        std::cout << "  " << std::left << std::setw(16) << m.name << std::right << std::fixed
+                  << std::setprecision(4) << std::setw(10) << seconds << std::setprecision(2)
+                  << std::setw(10) << file_bytes(m.file) / seconds / 1e9 << std::setprecision(1)
+                  << std::setw(11) << 100.0 * cached_fraction(m.file) << "%" << std::setw(12) << bounced
+                  << std::setw(10) << check << "\n";
+    }
+    std::cout << "\nGB/s counts the bytes of each method's file (the CSV is text, larger than the doubles)\n";
+
+    std::remove(path.c_str());
+    std::remove(csv_path.c_str());
+}
+
+} // namespace async_io
+
+} // namespace matmul
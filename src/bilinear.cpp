@@ -0,0 +1,218 @@
+#include "bilinear.hpp"
+#include "algorithms.hpp"
+#include "timer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace matmul {
+namespace bilinear {
+
+namespace detail {
+
+void combine(int rows, int cols, double* dst, int ldd, std::initializer_list<Term> terms) {
+    const Term* first = terms.begin();
+    for (int i = 0; i < rows; ++i) {
+        double* d = dst + static_cast<size_t>(i) * ldd;
+        const double* s0 = first->src + static_cast<size_t>(i) * first->ld;
+        double c0 = first->coef;
+        for (int j = 0; j < cols; ++j) {
+            d[j] = c0 * s0[j];
+        }
+        for (const Term* t = first + 1; t != terms.end(); ++t) {
+            const double* s = t->src + static_cast<size_t>(i) * t->ld;
+            double c = t->coef;
+            for (int j = 0; j < cols; ++j) {
+                d[j] += c * s[j];
+            }
+        }
+    }
+}
+
+void leaf_gemm(int m, int k, int n, const double* A, int lda, const double* B, int ldb,
+               double* C, int ldc) {
+    openblas::gemm(m, k, n, A, lda, B, ldb, C, ldc);
+}
+
+} // namespace detail
+
+namespace {
+
+const detail::GeneratedScheme& find_scheme(const std::string& name) {
+    for (int s = 0; s < detail::generated_scheme_count; ++s) {
+        if (name == detail::generated_schemes[s].name) return detail::generated_schemes[s];
+    }
+    throw std::runtime_error("Unknown bilinear scheme: " + name);
+}
+
+int ipow(int base, int exp) {
+    int result = 1;
+    while (exp-- > 0) result *= base;
+    return result;
+}
+
+int round_up(int value, int multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Copy of M into the top-left corner of a zeroed rows x cols matrix
+Matrix padded(const Matrix& M, int rows, int cols) {
+    if (M.rows() == rows && M.cols() == cols) return M;
+    Matrix P(rows, cols);
+    for (int i = 0; i < M.rows(); ++i) {
+        std::copy(&M(i, 0), &M(i, 0) + M.cols(), &P(i, 0));
+    }
+    return P;
+}
+
+} // namespace
+
+std::vector<SchemeInfo> catalog() {
+    std::vector<SchemeInfo> result;
+    for (int s = 0; s < detail::generated_scheme_count; ++s) {
+        const detail::GeneratedScheme& g = detail::generated_schemes[s];
+        result.push_back({g.name, g.m, g.k, g.n, g.rank, g.additions, g.cse_additions});
+    }
+    return result;
+}
+
+Matrix multiply(const std::string& scheme, const Matrix& A, const Matrix& B, int levels) {
+    if (A.cols() != B.rows()) {
+        throw std::runtime_error("Matrix dimensions incompatible for multiplication");
+    }
+    const detail::GeneratedScheme& s = find_scheme(scheme);
+
+    int m = round_up(A.rows(), ipow(s.m, levels));
+    int k = round_up(A.cols(), ipow(s.k, levels));
+    int n = round_up(B.cols(), ipow(s.n, levels));
+
+    if (m == A.rows() && k == A.cols() && n == B.cols()) {
+        Matrix C = Matrix::uninitialized(m, n);
+        s.step(A.data(), k, B.data(), n, C.data(), n, m, k, n, levels);
+        return C;
+    }
+
+    Matrix A_pad = padded(A, m, k);
+    Matrix B_pad = padded(B, k, n);
+    Matrix C_pad = Matrix::uninitialized(m, n);
+    s.step(A_pad.data(), k, B_pad.data(), n, C_pad.data(), n, m, k, n, levels);
+    return C_pad.submatrix(0, 0, A.rows(), B.cols());
+}
+
+namespace {
+
+struct Shape {
+    std::string label;
+    int m, k, n;
+};
+
+// Best of two runs (the first also warms the pool and BLAS)
+template <typename F>
+double time_best(F&& run) {
+    double best = 0.0;
+    for (int rep = 0; rep < 2; ++rep) {
+        Timer timer;
+        timer.start();
+        run();
+        timer.stop();
+        if (rep == 0 || timer.elapsed_seconds() < best) best = timer.elapsed_seconds();
+    }
+    return best;
+}
+
+double relative_error(const Matrix& C, const Matrix& reference) {
+    double diff = 0.0, scale = 0.0;
+    size_t count = static_cast<size_t>(C.rows()) * C.cols();
+    for (size_t i = 0; i < count; ++i) {
+        diff = std::max(diff, std::fabs(C.data()[i] - reference.data()[i]));
+        scale = std::max(scale, std::fabs(reference.data()[i]));
+    }
+    return scale > 0.0 ? diff / scale : diff;
+}
+
+} // namespace
+
+void run_benchmark(const Config& config) {
+    const int MIN_LEAF = 64;  // Smaller leaves are dominated by additions
+    int N = config.matrix_size;
+    int H = N + N / 2;
+
+    std::vector<Shape> shapes = {
+        {"square", N, N, N},
+        {"wide C", N, N, H},
+        {"long k", N, H, N},
+        {"tall C", H, N, N},
+        {"2x tall", 2 * N, N, N},
+    };
+
+    std::cout << "\nBilinear scheme catalog (block additions per step: as written / after CSE)\n";
+    for (const SchemeInfo& s : catalog()) {
+        std::cout << "  " << std::left << std::setw(10) << s.name << std::right << "<" << s.m << ","
+                  << s.k << "," << s.n << ";" << s.rank << ">  " << std::setw(4) << s.additions
+                  << " / " << s.cse_additions << "\n";
+    }
+
+    std::vector<std::string> best_lines;
+    for (const Shape& shape : shapes) {
+        Matrix A(shape.m, shape.k);
+        Matrix B(shape.k, shape.n);
+        A.randomize();
+        B.randomize();
+        double flops = 2.0 * shape.m * shape.k * shape.n;
+
+        Matrix reference;
+        double dgemm_seconds = time_best([&] { reference = openblas::multiply(A, B); });
+
+        std::cout << "\n" << shape.label << ": " << shape.m << "x" << shape.k << " * "
+                  << shape.k << "x" << shape.n << "\n";
+        std::cout << std::left << std::setw(12) << "  Scheme" << std::right << std::setw(8) << "Levels"
+                  << std::setw(14) << "Time (s)" << std::setw(12) << "GFLOP/s" << std::setw(10)
+                  << "Speedup" << std::setw(12) << "Rel. error" << "\n";
+        std::cout << "  " << std::string(66, '-') << "\n";
+
+        auto print_row = [&](const std::string& name, const std::string& levels, double seconds,
+                             double error) {
+            std::cout << "  " << std::left << std::setw(10) << name << std::right << std::setw(8)
+                      << levels << std::fixed << std::setprecision(4) << std::setw(14) << seconds
+                      << std::setprecision(2) << std::setw(12) << flops / seconds / 1e9
+                      << std::setw(9) << dgemm_seconds / seconds << "x" << std::scientific
+                      << std::setprecision(1) << std::setw(12) << error << std::fixed << "\n";
+        };
+        print_row("dgemm", "-", dgemm_seconds, 0.0);
+
+        std::string best_name = "dgemm";
+        double best_seconds = dgemm_seconds;
+        for (const SchemeInfo& s : catalog()) {
+            for (int levels = 1; levels <= 3; ++levels) {
+                // Skip depths whose leaves would fall below MIN_LEAF
+                if (shape.m / ipow(s.m, levels) < MIN_LEAF || shape.k / ipow(s.k, levels) < MIN_LEAF ||
+                    shape.n / ipow(s.n, levels) < MIN_LEAF) {
+                    break;
+                }
+                Matrix C;
+                double seconds = time_best([&] { C = multiply(s.name, A, B, levels); });
+                print_row(s.name, std::to_string(levels), seconds, relative_error(C, reference));
+                if (seconds < best_seconds) {
+                    best_seconds = seconds;
+                    best_name = s.name + " x" + std::to_string(levels);
+                }
+            }
+        }
+
+        std::ostringstream line;
+        line << "  " << std::left << std::setw(10) << shape.label << std::setw(22)
+             << (std::to_string(shape.m) + "x" + std::to_string(shape.k) + "x" + std::to_string(shape.n))
+             << std::setw(14) << best_name << std::right << std::fixed << std::setprecision(2)
+             << dgemm_seconds / best_seconds << "x vs dgemm";
+        best_lines.push_back(line.str());
+    }
+
+    std::cout << "\nBest scheme per shape (m x k x n):\n";
+    for (const std::string& line : best_lines) std::cout << line << "\n";
+}
+
+} // namespace bilinear
+} // namespace matmul
@@ -0,0 +1,153 @@
+#include "binary_io.hpp"
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace matmul {
+
+namespace {
+const char BINARY_MAGIC[8] = {'M', 'A', 'T', 'M', 'U', 'L', 'B', '1'};
+const uint32_t BINARY_VERSION = 1;
+}
+
+BinaryMatrixHeader BinaryIO::make_header(int rows, int cols) {
+    BinaryMatrixHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version = BINARY_VERSION;
+    header.header_size = sizeof(BinaryMatrixHeader);
+    header.rows = rows;
+    header.cols = cols;
+    return header;
+}
+
+bool BinaryIO::valid_header(const BinaryMatrixHeader& header) {
+    return std::memcmp(header.magic, BINARY_MAGIC, sizeof(header.magic)) == 0 &&
+           header.version == BINARY_VERSION &&
+           header.header_size >= sizeof(BinaryMatrixHeader) &&
+           header.rows > 0 && header.cols > 0 && header.rows < INT_MAX && header.cols < INT_MAX;
+}
+
+bool BinaryIO::read_matrix(const std::string& filename, Matrix& matrix) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file '" << filename << "'\n";
+        return false;
+    }
+
+    BinaryMatrixHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || !valid_header(header)) {
+        std::cerr << "Error: '" << filename << "' is not a binary matrix file\n";
+        return false;
+    }
+
+    matrix.resize(static_cast<int>(header.rows), static_cast<int>(header.cols));
+    file.seekg(header.header_size);
+    size_t bytes = static_cast<size_t>(header.rows) * header.cols * sizeof(double);
+    if (!file.read(reinterpret_cast<char*>(matrix.data()), bytes)) {
+        std::cerr << "Error: '" << filename << "' is truncated\n";
+        return false;
+    }
+
+    return true;
+}
+
+bool BinaryIO::write_matrix(const std::string& filename, const Matrix& matrix) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not create file '" << filename << "'\n";
+        return false;
+    }
+
+    BinaryMatrixHeader header = make_header(matrix.rows(), matrix.cols());
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(matrix.data()),
+               static_cast<size_t>(matrix.rows()) * matrix.cols() * sizeof(double));
+
+    return static_cast<bool>(file);
+}
+
+MappedMatrixFile::~MappedMatrixFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedMatrixFile::create(const std::string&, int, int) {
+    std::cerr << "Error: Memory-mapped output is not supported on this platform\n";
+    return false;
+}
+
+Matrix MappedMatrixFile::view() { return Matrix(); }
+bool MappedMatrixFile::close() { return true; }
+
+#else
+
+bool MappedMatrixFile::create(const std::string& filename, int rows, int cols) {
+    close();
+
+    fd_ = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "Error: Could not create file '" << filename << "'\n";
+        return false;
+    }
+
+    length_ = sizeof(BinaryMatrixHeader) + static_cast<size_t>(rows) * cols * sizeof(double);
+
+    // Reserve the blocks up front so page faults on the mapping never hit ENOSPC;
+    // fall back to a sparse file where preallocation isn't supported
+    int rc = posix_fallocate(fd_, 0, static_cast<off_t>(length_));
+    if (rc != 0 && ftruncate(fd_, static_cast<off_t>(length_)) != 0) {
+        std::cerr << "Error: Could not size '" << filename << "' to " << length_ << " bytes\n";
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    void* addr = mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        std::cerr << "Error: Could not map '" << filename << "'\n";
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    base_ = static_cast<char*>(addr);
+    rows_ = rows;
+    cols_ = cols;
+
+    BinaryMatrixHeader header = BinaryIO::make_header(rows, cols);
+    std::memcpy(base_, &header, sizeof(header));
+
+    return true;
+}
+
+Matrix MappedMatrixFile::view() {
+    double* data = reinterpret_cast<double*>(base_ + sizeof(BinaryMatrixHeader));
+    return Matrix::view(data, rows_, cols_);
+}
+
+bool MappedMatrixFile::close() {
+    bool ok = true;
+    if (base_ != nullptr) {
+        ok = msync(base_, length_, MS_SYNC) == 0;
+        munmap(base_, length_);
+        base_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ok = (::close(fd_) == 0) && ok;
+        fd_ = -1;
+    }
+    return ok;
+}
+
+#endif
+
+} // namespace matmul
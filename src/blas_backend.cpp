@@ -0,0 +1,399 @@
+#include "blas_backend.hpp"
+#include "matrix.hpp"
+#include "timer.hpp"
+#include <mpi.h>
+#include <omp.h>
+#include <dlfcn.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// The library find_package(BLAS) linked (LINKED backend)
+extern "C" {
+    void cblas_dgemm(const int Order, const int TransA, const int TransB,
+                     const int M, const int N, const int K,
+                     const double alpha, const double* A, const int lda,
+                     const double* B, const int ldb,
+                     const double beta, double* C, const int ldc);
+}
+
+namespace matmul {
+namespace blas {
+
+namespace {
+
+const int CblasRowMajor = 101;
+const int CblasNoTrans = 111;
+
+// mkl_rt defaults to Intel OpenMP, whose pool would run beside libgomp's;
+// MKL_Set_Threading_Layer must pick GNU OpenMP before any other MKL call
+const int MKL_THREADING_GNU = 3;
+
+using DgemmFn = void (*)(int, int, int, int, int, int, double, const double*, int,
+                         const double*, int, double, double*, int);
+using SetIntFn = void (*)(int);        // openblas_set_num_threads, MKL_Set_Num_Threads
+using GetIntFn = int (*)();
+using SetDimFn = void (*)(int64_t);    // BLIS dim_t (64-bit in default builds)
+using GetDimFn = int64_t (*)();
+using StringFn = const char* (*)();
+using MklVersionFn = void (*)(char*, int);
+using MklLayerFn = int (*)(int);
+
+struct Library {
+    BackendInfo info;
+    DgemmFn dgemm = nullptr;
+    SetIntFn set_int = nullptr;
+    GetIntFn get_int = nullptr;
+    SetDimFn set_dim = nullptr;
+    GetDimFn get_dim = nullptr;
+};
+
+template <typename Fn>
+Fn symbol(void* handle, const char* name) {
+    return reinterpret_cast<Fn>(dlsym(handle, name));
+}
+
+std::vector<std::string> sonames(BlasBackend backend) {
+    switch (backend) {
+        case BlasBackend::OPENBLAS: return {"libopenblas.so.0", "libopenblas.so"};
+        case BlasBackend::BLIS: return {"libblis.so.4", "libblis.so.3", "libblis.so"};
+        case BlasBackend::MKL: return {"libmkl_rt.so.2", "libmkl_rt.so.1", "libmkl_rt.so"};
+        case BlasBackend::REFERENCE: return {"libcblas.so.3", "libcblas.so", "libblas.so.3"};
+        default: return {};
+    }
+}
+
+// The word following `key` in s ("0.3.21" from "OpenBLAS 0.3.21 ...")
+std::string word_after(const std::string& s, const std::string& key) {
+    size_t start = s.find(key);
+    if (start == std::string::npos) return "";
+    start += key.size();
+    return s.substr(start, s.find(' ', start) - start);
+}
+
+// Identify the library by the extensions it exports and find its
+// thread-count controls. dlsym on a handle also searches its dependencies.
+void detect(void* handle, Library& lib) {
+    BackendInfo& info = lib.info;
+    if (MklLayerFn layer = symbol<MklLayerFn>(handle, "MKL_Set_Threading_Layer")) {
+        layer(MKL_THREADING_GNU);
+    }
+
+    if (MklVersionFn version = symbol<MklVersionFn>(handle, "MKL_Get_Version_String")) {
+        char text[256] = {};
+        version(text, sizeof(text));
+        info.vendor = "MKL";
+        info.version = word_after(text, "Version ");
+        lib.set_int = symbol<SetIntFn>(handle, "MKL_Set_Num_Threads");
+        lib.get_int = symbol<GetIntFn>(handle, "MKL_Get_Max_Threads");
+    } else if (StringFn version = symbol<StringFn>(handle, "bli_info_get_version_str")) {
+        info.vendor = "BLIS";
+        info.version = version();
+        lib.set_dim = symbol<SetDimFn>(handle, "bli_thread_set_num_threads");
+        lib.get_dim = symbol<GetDimFn>(handle, "bli_thread_get_num_threads");
+    } else if (StringFn config = symbol<StringFn>(handle, "openblas_get_config")) {
+        info.vendor = "OpenBLAS";
+        info.version = word_after(config(), "OpenBLAS ");
+        lib.set_int = symbol<SetIntFn>(handle, "openblas_set_num_threads");
+        lib.get_int = symbol<GetIntFn>(handle, "openblas_get_num_threads");
+    } else {
+        info.vendor = info.backend == BlasBackend::LINKED ? "Unknown" : "Reference";
+    }
+    info.thread_control = lib.set_int != nullptr || lib.set_dim != nullptr;
+}
+
+// Libraries are never closed: OpenBLAS and MKL keep thread pools that do
+// not survive dlclose
+bool open_library(BlasBackend backend, const std::string& path, Library& lib, std::string& error) {
+    lib = Library();
+    lib.info.backend = backend;
+
+    void* handle = nullptr;
+    if (backend == BlasBackend::LINKED) {
+        if (!path.empty()) {
+            error = "--blas-lib needs --blas <name>";
+            return false;
+        }
+        handle = dlopen(nullptr, RTLD_NOW);
+        lib.dgemm = &cblas_dgemm;
+    } else {
+        // RTLD_DEEPBIND puts the library's own symbols ahead of the global
+        // scope, so e.g. netlib CBLAS calls its own dgemm_ rather than the
+        // one the linked OpenBLAS exports
+        int flags = RTLD_NOW | RTLD_LOCAL;
+#ifdef RTLD_DEEPBIND
+        flags |= RTLD_DEEPBIND;
+#endif
+        std::vector<std::string> names = path.empty() ? sonames(backend) : std::vector<std::string>{path};
+        std::string tried;
+        for (const std::string& name : names) {
+            handle = dlopen(name.c_str(), flags);
+            if (handle != nullptr) break;
+            tried += (tried.empty() ? "" : ", ") + name;
+        }
+        if (handle == nullptr) {
+            error = "could not load " + tried;
+            return false;
+        }
+        lib.dgemm = symbol<DgemmFn>(handle, "cblas_dgemm");
+        if (lib.dgemm == nullptr) {
+            error = "no cblas_dgemm in " + (path.empty() ? blas_backend_to_string(backend) : path) +
+                    " (built without CBLAS?)";
+            return false;
+        }
+    }
+
+    Dl_info where;
+    if (dladdr(reinterpret_cast<void*>(lib.dgemm), &where) != 0 && where.dli_fname != nullptr) {
+        char* real = realpath(where.dli_fname, nullptr);
+        lib.info.library = real != nullptr ? real : where.dli_fname;
+        std::free(real);
+    }
+    detect(handle, lib);
+    return true;
+}
+
+bool apply_threads(Library& lib, int threads) {
+    if (lib.set_int != nullptr) {
+        lib.set_int(threads);
+    } else if (lib.set_dim != nullptr) {
+        lib.set_dim(threads);
+    } else {
+        lib.info.threads = 1;
+        return false;
+    }
+    // The library may cap the request (OpenBLAS at its build's MAX_THREADS)
+    if (lib.get_int != nullptr) {
+        lib.info.threads = lib.get_int();
+    } else if (lib.get_dim != nullptr) {
+        lib.info.threads = static_cast<int>(lib.get_dim());
+    } else {
+        lib.info.threads = threads;
+    }
+    return true;
+}
+
+Library& active_library() {
+    static Library lib = [] {
+        Library linked;
+        std::string error;
+        open_library(BlasBackend::LINKED, "", linked, error);
+        return linked;
+    }();
+    return lib;
+}
+
+int node_ranks = 1;   // Ranks sharing this node, from configure()
+
+int count_node_ranks() {
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+    int ranks;
+    MPI_Comm_size(node_comm, &ranks);
+    MPI_Comm_free(&node_comm);
+    return ranks;
+}
+
+// libblas.so.3 is often an alternatives link to an optimized library
+void warn_if_not_reference(const Library& lib) {
+    if (lib.info.backend == BlasBackend::REFERENCE && lib.info.vendor != "Reference") {
+        std::cerr << "Warning: " << lib.info.library << " is " << lib.info.vendor
+                  << ", not reference BLAS (check the system's BLAS alternatives)\n";
+    }
+}
+
+std::string describe(const BackendInfo& info) {
+    std::string text = info.vendor;
+    if (!info.version.empty()) text += " " + info.version;
+    return text;
+}
+
+} // namespace
+
+bool load(BlasBackend backend, const std::string& path) {
+    Library lib;
+    std::string error;
+    if (!open_library(backend, path, lib, error)) {
+        std::cerr << "Error: BLAS backend " << blas_backend_to_string(backend) << ": " << error << "\n";
+        return false;
+    }
+    warn_if_not_reference(lib);
+    active_library() = lib;
+    return true;
+}
+
+bool set_threads(int threads) {
+    return apply_threads(active_library(), std::max(1, threads));
+}
+
+int threads_for(const Config& config, int ranks_per_node) {
+    if (config.blas_threads > 0) return config.blas_threads;
+    switch (config.mode) {
+        case ExecutionMode::SEQUENTIAL:
+            return 1;
+        case ExecutionMode::OPENMP:
+        case ExecutionMode::HYBRID:
+            return std::max(1, config.num_threads);
+        case ExecutionMode::MPI:
+            return std::max(1, omp_get_num_procs() / std::max(1, ranks_per_node));
+    }
+    return 1;
+}
+
+bool configure(const Config& config) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    bool ok = true;
+    if (config.blas_backend != BlasBackend::LINKED || !config.blas_library.empty()) {
+        // Rank 0 reports its own failure; other ranks only a failure rank 0 did not see
+        Library lib;
+        std::string error;
+        ok = open_library(config.blas_backend, config.blas_library, lib, error);
+        if (ok) {
+            if (rank == 0) warn_if_not_reference(lib);
+            active_library() = lib;
+        } else if (rank == 0) {
+            std::cerr << "Error: BLAS backend " << blas_backend_to_string(config.blas_backend)
+                      << ": " << error << "\n";
+        }
+    }
+
+    int failed = ok ? 0 : 1;
+    int rank0_failed = rank == 0 ? failed : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Bcast(&rank0_failed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (failed != 0) {
+        if (rank == 0 && rank0_failed == 0) {
+            std::cerr << "Error: BLAS backend " << blas_backend_to_string(config.blas_backend)
+                      << " failed to load on some ranks\n";
+        }
+        return false;
+    }
+
+    node_ranks = count_node_ranks();
+    set_threads(threads_for(config, node_ranks));
+    return true;
+}
+
+const BackendInfo& active() {
+    return active_library().info;
+}
+
+void dgemm(int m, int k, int n, const double* A, int lda, const double* B, int ldb,
+           double* C, int ldc) {
+    active_library().dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k,
+                           1.0, A, lda, B, ldb, 0.0, C, ldc);
+}
+
+void run_benchmark(const Config& config) {
+    int threads = threads_for(config, node_ranks);
+    const double BUDGET_SECONDS = 30.0;   // Skip a size a library is expected to exceed
+
+    std::cout << "\nBLAS backends, " << threads << " thread(s) requested ("
+              << mode_to_string(config.mode) << ", " << node_ranks << " rank(s) on this node)\n\n";
+
+    std::vector<Library> libs;
+    const BlasBackend backends[] = {BlasBackend::LINKED, BlasBackend::OPENBLAS, BlasBackend::BLIS,
+                                    BlasBackend::MKL, BlasBackend::REFERENCE};
+    for (BlasBackend backend : backends) {
+        Library lib;
+        std::string error;
+        std::string path = backend == config.blas_backend ? config.blas_library : "";
+        std::cout << "  " << std::left << std::setw(11) << blas_backend_to_string(backend) << std::right;
+        if (!open_library(backend, path, lib, error)) {
+            std::cout << "not available (" << error << ")\n";
+            continue;
+        }
+
+        // One file reached under two names (the linked OpenBLAS, or
+        // libblas.so.3 pointing at it) is timed once
+        auto same = std::find_if(libs.begin(), libs.end(), [&lib](const Library& other) {
+            return other.info.library == lib.info.library;
+        });
+        if (same != libs.end()) {
+            std::cout << "same library as " << blas_backend_to_string(same->info.backend) << " ("
+                      << lib.info.library << ")\n";
+            continue;
+        }
+
+        apply_threads(lib, threads);
+        std::cout << describe(lib.info) << ", " << lib.info.library << ", ";
+        if (lib.info.thread_control) std::cout << lib.info.threads << " thread(s)\n";
+        else std::cout << "no thread control\n";
+
+        // Start the library's thread pool outside the timings
+        Matrix warm(64, 64), out(64, 64);
+        lib.dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, 64, 64, 64,
+                  1.0, warm.data(), 64, warm.data(), 64, 0.0, out.data(), 64);
+        libs.push_back(lib);
+    }
+    if (libs.empty()) return;
+
+    std::vector<int> sizes;
+    for (int s = 256; s < config.matrix_size; s *= 2) sizes.push_back(s);
+    sizes.push_back(config.matrix_size);
+
+    std::cout << "\n" << std::setw(8) << "Size";
+    for (const Library& lib : libs) std::cout << std::setw(14) << blas_backend_to_string(lib.info.backend);
+    std::cout << std::setw(14) << "Max diff" << "   (GFLOP/s)\n";
+    std::cout << "  " << std::string(6 + 14 * libs.size() + 14, '-') << "\n";
+
+    std::vector<double> last_seconds(libs.size(), 0.0);
+    int last_size = 0;
+    bool skipped = false;
+    for (int N : sizes) {
+        Matrix A(N, N), B(N, N);
+        A.randomize(-1.0, 1.0);
+        B.randomize(-1.0, 1.0);
+        double flops = 2.0 * N * static_cast<double>(N) * N;
+        int reps = N <= 2048 ? 2 : 1;   // Best of two where a run is cheap
+
+        Matrix reference;
+        double max_diff = 0.0;
+        std::cout << std::setw(8) << N << std::fixed << std::setprecision(2);
+        for (size_t l = 0; l < libs.size(); ++l) {
+            double growth = last_size > 0 ? std::pow(static_cast<double>(N) / last_size, 3.0) : 0.0;
+            if (last_seconds[l] < 0.0 || last_seconds[l] * growth > BUDGET_SECONDS) {
+                last_seconds[l] = -1.0;
+                skipped = true;
+                std::cout << std::setw(14) << "-";
+                continue;
+            }
+
+            Matrix C(N, N);   // Zeroed, so first-touch faults stay out of the timing
+            double best = 0.0;
+            for (int rep = 0; rep < reps; ++rep) {
+                Timer timer;
+                timer.start();
+                libs[l].dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, N, N, N,
+                              1.0, A.data(), N, B.data(), N, 0.0, C.data(), N);
+                timer.stop();
+                if (rep == 0 || timer.elapsed_seconds() < best) best = timer.elapsed_seconds();
+            }
+            last_seconds[l] = best;
+            std::cout << std::setw(14) << flops / best / 1e9;
+
+            if (reference.rows() == 0) {
+                reference = std::move(C);
+            } else {
+                const double* r = reference.data();
+                const double* c = C.data();
+                for (size_t i = 0; i < static_cast<size_t>(N) * N; ++i) {
+                    max_diff = std::max(max_diff, std::abs(c[i] - r[i]));
+                }
+            }
+        }
+        std::cout << std::scientific << std::setprecision(2) << std::setw(14) << max_diff << "\n";
+        last_size = N;
+    }
+    std::cout << std::defaultfloat;
+    if (skipped) std::cout << "\n'-': skipped, expected to take over " << BUDGET_SECONDS << " s\n";
+}
+
+} // namespace blas
+} // namespace matmul
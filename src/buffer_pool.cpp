@@ -0,0 +1,230 @@
+#include "buffer_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace matmul {
+namespace pool {
+
+namespace {
+
+const size_t ALIGNMENT = 64;
+const size_t MIN_CLASS_DOUBLES = 16;
+const int NUM_CLASSES = 128;
+const size_t THREAD_LIST_BLOCKS = 8;          // Per class, per thread
+const size_t DEFAULT_LIMIT = size_t(1) << 30;
+
+// Size class index and its size in doubles: 16, then four steps per power of two
+int class_of(size_t count) {
+    if (count <= MIN_CLASS_DOUBLES) return 0;
+    int k = 0;
+    while ((size_t(1) << (k + 1)) < count) ++k;   // 2^k < count <= 2^(k+1)
+    size_t base = size_t(1) << k;
+    size_t step = base / 4;
+    size_t sub = (count - base + step - 1) / step; // 1..4
+    return (k - 4) * 4 + static_cast<int>(sub);
+}
+
+size_t class_doubles(int cls) {
+    if (cls == 0) return MIN_CLASS_DOUBLES;
+    int k = (cls - 1) / 4 + 4;
+    size_t sub = (cls - 1) % 4 + 1;
+    size_t base = size_t(1) << k;
+    return base + sub * (base / 4);
+}
+
+size_t class_bytes(int cls) {
+    size_t bytes = class_doubles(cls) * sizeof(double);
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+struct Counters {
+    std::atomic<uint64_t> local_hits{0};
+    std::atomic<uint64_t> global_hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<size_t> idle_bytes{0};
+    std::atomic<size_t> peak_idle_bytes{0};
+    std::atomic<size_t> limit{DEFAULT_LIMIT};
+};
+
+struct SharedLists {
+    std::mutex mutex;
+    std::vector<double*> lists[NUM_CLASSES];
+};
+
+// Never destroyed: thread caches may flush into it during static destruction
+Counters& counters() {
+    static Counters* c = new Counters();
+    return *c;
+}
+
+SharedLists& shared() {
+    static SharedLists* s = new SharedLists();
+    return *s;
+}
+
+void system_free(double* ptr) {
+    std::free(ptr);
+}
+
+// Account for a buffer entering the free lists; false if over the limit
+bool admit(size_t bytes) {
+    Counters& c = counters();
+    size_t idle = c.idle_bytes.load(std::memory_order_relaxed);
+    do {
+        if (idle + bytes > c.limit.load(std::memory_order_relaxed)) return false;
+    } while (!c.idle_bytes.compare_exchange_weak(idle, idle + bytes, std::memory_order_relaxed));
+
+    size_t peak = c.peak_idle_bytes.load(std::memory_order_relaxed);
+    while (idle + bytes > peak &&
+           !c.peak_idle_bytes.compare_exchange_weak(peak, idle + bytes, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+void push_shared(double* ptr, int cls) {
+    SharedLists& s = shared();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.lists[cls].push_back(ptr);
+}
+
+struct ThreadLists {
+    std::vector<double*> lists[NUM_CLASSES];
+
+    // Buffers of an exiting thread go to the shared lists
+    ~ThreadLists() {
+        for (int cls = 0; cls < NUM_CLASSES; ++cls) {
+            for (double* ptr : lists[cls]) push_shared(ptr, cls);
+        }
+    }
+};
+
+ThreadLists& thread_lists() {
+    thread_local ThreadLists lists;
+    return lists;
+}
+
+} // namespace
+
+double* allocate(size_t count) {
+    if (count == 0) return nullptr;
+
+    int cls = class_of(count);
+    Counters& c = counters();
+
+    if (cls < NUM_CLASSES) {
+        std::vector<double*>& local = thread_lists().lists[cls];
+        if (!local.empty()) {
+            double* ptr = local.back();
+            local.pop_back();
+            c.idle_bytes.fetch_sub(class_bytes(cls), std::memory_order_relaxed);
+            c.local_hits.fetch_add(1, std::memory_order_relaxed);
+            return ptr;
+        }
+
+        SharedLists& s = shared();
+        std::unique_lock<std::mutex> lock(s.mutex);
+        if (!s.lists[cls].empty()) {
+            double* ptr = s.lists[cls].back();
+            s.lists[cls].pop_back();
+            lock.unlock();
+            c.idle_bytes.fetch_sub(class_bytes(cls), std::memory_order_relaxed);
+            c.global_hits.fetch_add(1, std::memory_order_relaxed);
+            return ptr;
+        }
+    }
+
+    c.misses.fetch_add(1, std::memory_order_relaxed);
+    size_t bytes = cls < NUM_CLASSES
+        ? class_bytes(cls)
+        : (count * sizeof(double) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    void* ptr = std::aligned_alloc(ALIGNMENT, bytes);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return static_cast<double*>(ptr);
+}
+
+double* allocate(size_t count, size_t alignment) {
+    if (alignment <= ALIGNMENT || count == 0) return allocate(count);
+
+    // Rounded up to the size class, so the buffer can serve that class later
+    int cls = class_of(count);
+    size_t bytes = cls < NUM_CLASSES ? class_bytes(cls) : count * sizeof(double);
+    bytes = (bytes + alignment - 1) / alignment * alignment;
+    counters().misses.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::aligned_alloc(alignment, bytes);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return static_cast<double*>(ptr);
+}
+
+void release(double* ptr, size_t count) {
+    if (ptr == nullptr) return;
+
+    int cls = class_of(count);
+    if (cls >= NUM_CLASSES || !admit(class_bytes(cls))) {
+        counters().dropped.fetch_add(1, std::memory_order_relaxed);
+        system_free(ptr);
+        return;
+    }
+
+    std::vector<double*>& local = thread_lists().lists[cls];
+    if (local.size() < THREAD_LIST_BLOCKS) {
+        local.push_back(ptr);
+    } else {
+        push_shared(ptr, cls);
+    }
+}
+
+void set_limit(size_t bytes) {
+    counters().limit.store(bytes, std::memory_order_relaxed);
+    if (counters().idle_bytes.load(std::memory_order_relaxed) > bytes) trim();
+}
+
+size_t limit() {
+    return counters().limit.load(std::memory_order_relaxed);
+}
+
+Stats stats() {
+    Counters& c = counters();
+    Stats s;
+    s.local_hits = c.local_hits.load(std::memory_order_relaxed);
+    s.global_hits = c.global_hits.load(std::memory_order_relaxed);
+    s.misses = c.misses.load(std::memory_order_relaxed);
+    s.dropped = c.dropped.load(std::memory_order_relaxed);
+    s.idle_bytes = c.idle_bytes.load(std::memory_order_relaxed);
+    s.peak_idle_bytes = c.peak_idle_bytes.load(std::memory_order_relaxed);
+    return s;
+}
+
+void reset_stats() {
+    Counters& c = counters();
+    c.local_hits = 0;
+    c.global_hits = 0;
+    c.misses = 0;
+    c.dropped = 0;
+    c.peak_idle_bytes = c.idle_bytes.load();
+}
+
+void trim() {
+    Counters& c = counters();
+    auto drain = [&c](std::vector<double*>& list, int cls) {
+        for (double* ptr : list) {
+            c.idle_bytes.fetch_sub(class_bytes(cls), std::memory_order_relaxed);
+            system_free(ptr);
+        }
+        list.clear();
+    };
+
+    ThreadLists& local = thread_lists();
+    for (int cls = 0; cls < NUM_CLASSES; ++cls) drain(local.lists[cls], cls);
+
+    SharedLists& s = shared();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (int cls = 0; cls < NUM_CLASSES; ++cls) drain(s.lists[cls], cls);
+}
+
+} // namespace pool
+} // namespace matmul
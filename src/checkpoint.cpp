@@ -0,0 +1,514 @@
+#include "checkpoint.hpp"
+#include "timer.hpp"
+#include <mpi.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace matmul {
+namespace checkpoint {
+
+namespace {
+
+const char META_MAGIC[8] = {'M', 'M', 'C', 'K', 'P', 'T', '0', '2'};
+
+// Followed by `ranges` pairs of int32 global rows [begin, end)
+struct MetaHeader {
+    char magic[8];
+    uint64_t fingerprint;
+    int32_t total_rows;
+    int32_t cols;
+    int32_t tile_rows;
+    int32_t ranges;
+};
+
+const uint64_t FNV_BASIS = 14695981039346656037ULL;
+
+// Tiles queued for the writer before submit() blocks
+const size_t MAX_PENDING_TILES = 4;
+
+uint64_t fnv1a(uint64_t hash, const void* data, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// ~64 evenly spaced rows of A plus the last one, each hashed on its own
+// (global index and ~64 elements) and combined with XOR
+uint64_t hash_rows(const Matrix& A_local, int row_offset, int total_rows) {
+    int cols = A_local.cols();
+    int row_stride = std::max(1, total_rows / 64);
+    int col_stride = std::max(1, cols / 64);
+    uint64_t combined = 0;
+    for (int i = 0; i < A_local.rows(); ++i) {
+        int64_t row = row_offset + i;
+        if (row % row_stride != 0 && row != total_rows - 1) continue;
+        const double* data = A_local.data() + static_cast<size_t>(i) * cols;
+        uint64_t hash = fnv1a(FNV_BASIS, &row, sizeof(row));
+        for (int j = 0; j < cols; j += col_stride) {
+            hash = fnv1a(hash, &data[j], sizeof(double));
+        }
+        if (cols > 0) hash = fnv1a(hash, &data[cols - 1], sizeof(double));
+        combined ^= hash;
+    }
+    return combined;
+}
+
+uint64_t hash_sample(uint64_t hash, const Matrix& M) {
+    size_t count = static_cast<size_t>(M.rows()) * M.cols();
+    const double* data = M.data();
+    // ~4096 evenly spaced elements plus the last one
+    size_t stride = std::max<size_t>(1, count / 4096);
+    for (size_t i = 0; i < count; i += stride) {
+        hash = fnv1a(hash, &data[i], sizeof(double));
+    }
+    if (count > 0) {
+        hash = fnv1a(hash, &data[count - 1], sizeof(double));
+    }
+    return hash;
+}
+
+std::string format_seconds(double seconds) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3) << seconds << " s";
+    return oss.str();
+}
+
+std::string meta_path(const std::string& dir, int rank) {
+    return dir + "/rank" + std::to_string(rank) + ".meta";
+}
+
+bool file_exists(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return file.good();
+}
+
+} // namespace
+
+uint64_t fingerprint(const Matrix& A_local, int row_offset, int total_rows, const Matrix& B,
+                     int tile_rows) {
+    uint64_t rows_hash = hash_rows(A_local, row_offset, total_rows);
+    MPI_Allreduce(MPI_IN_PLACE, &rows_hash, 1, MPI_UINT64_T, MPI_BXOR, MPI_COMM_WORLD);
+
+    int64_t dims[5] = {total_rows, A_local.cols(), B.rows(), B.cols(), tile_rows};
+    uint64_t hash = fnv1a(FNV_BASIS, dims, sizeof(dims));
+    hash = fnv1a(hash, &rows_hash, sizeof(rows_hash));
+    hash = hash_sample(hash, B);
+    return hash;
+}
+
+#ifndef _WIN32
+
+TileCheckpoint::TileCheckpoint(const std::string& dir, int rank, int row_offset, int local_rows,
+                               int total_rows, int cols, int tile_rows, uint64_t fingerprint,
+                               double interval_seconds, bool resume)
+    : row_offset_(row_offset), local_rows_(local_rows), total_rows_(total_rows), cols_(cols),
+      tile_rows_(tile_rows), num_tiles_(0), fingerprint_(fingerprint),
+      interval_seconds_(interval_seconds) {
+    data_path_ = dir + "/c.tiles";
+    meta_path_ = meta_path(dir, rank);
+
+    // Pieces: the global grid's tiles clipped to this stripe
+    bounds_.push_back(0);
+    for (int row = row_offset; row < row_offset + local_rows;) {
+        int next = std::min((row / tile_rows + 1) * tile_rows, row_offset + local_rows);
+        bounds_.push_back(next - row_offset);
+        row = next;
+    }
+    num_tiles_ = static_cast<int>(bounds_.size()) - 1;
+    done_.assign(num_tiles_, 0);
+    written_.assign(num_tiles_, 0);
+    stats_.tiles_total = num_tiles_;
+
+    if (resume) load_progress(dir, rank == 0);
+
+    // Ranks write disjoint pieces of the one file; contents outside the
+    // recorded ranges are never trusted, so it is sized but not truncated
+    data_fd_ = open(data_path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (data_fd_ < 0) {
+        std::cerr << "Error: Could not open checkpoint file '" << data_path_ << "': "
+                  << std::strerror(errno) << "\n";
+        return;
+    }
+    off_t data_bytes = static_cast<off_t>(total_rows_) * cols_ * sizeof(double);
+    if (ftruncate(data_fd_, data_bytes) != 0) {
+        std::cerr << "Error: Could not size checkpoint file '" << data_path_ << "'\n";
+        return;
+    }
+
+    ok_ = true;
+    writer_ = std::thread(&TileCheckpoint::writer_loop, this);
+}
+
+// Union of the ranges in every rank<R>.meta of the same problem (the earlier
+// run may have had a different rank count or split); a piece counts as done
+// when the union covers it
+void TileCheckpoint::load_progress(const std::string& dir, bool report) {
+    std::vector<std::pair<int, int>> ranges;
+    bool mismatch = false;
+    for (int r = 0; file_exists(meta_path(dir, r)); ++r) {
+        std::ifstream meta(meta_path(dir, r), std::ios::binary);
+        MetaHeader header;
+        bool match = meta.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+                     std::memcmp(header.magic, META_MAGIC, sizeof(header.magic)) == 0 &&
+                     header.fingerprint == fingerprint_ && header.total_rows == total_rows_ &&
+                     header.cols == cols_ && header.tile_rows == tile_rows_ && header.ranges >= 0;
+        std::vector<int32_t> raw(2 * static_cast<size_t>(match ? header.ranges : 0));
+        if (match && !meta.read(reinterpret_cast<char*>(raw.data()), raw.size() * sizeof(int32_t))) {
+            match = false;
+        }
+        if (!match) {
+            mismatch = true;
+            continue;
+        }
+        for (size_t i = 0; i < raw.size(); i += 2) {
+            if (raw[i] >= 0 && raw[i] < raw[i + 1] && raw[i + 1] <= total_rows_) {
+                ranges.emplace_back(raw[i], raw[i + 1]);
+            }
+        }
+    }
+    if (mismatch && report) {
+        std::cerr << "Warning: Some checkpoint records in " << dir
+                  << " do not match this run; their tiles are recomputed\n";
+    }
+
+    std::sort(ranges.begin(), ranges.end());
+    for (int tile = 0; tile < num_tiles_; ++tile) {
+        int begin = row_offset_ + bounds_[tile];
+        int end = row_offset_ + bounds_[tile + 1];
+        // Walk the sorted ranges, extending the covered prefix of the piece
+        for (const std::pair<int, int>& range : ranges) {
+            if (range.first > begin) break;
+            begin = std::max(begin, range.second);
+            if (begin >= end) break;
+        }
+        done_[tile] = begin >= end ? 1 : 0;
+    }
+}
+
+off_t TileCheckpoint::file_offset(int tile) const {
+    return static_cast<off_t>(row_offset_ + bounds_[tile]) * cols_ * sizeof(double);
+}
+
+TileCheckpoint::~TileCheckpoint() {
+    finish();
+    if (data_fd_ >= 0) {
+        close(data_fd_);
+    }
+}
+
+int TileCheckpoint::restore(Matrix& C_local) {
+    size_t row_bytes = static_cast<size_t>(cols_) * sizeof(double);
+    int restored = 0;
+
+    for (int tile = 0; tile < num_tiles_; ++tile) {
+        if (!done_[tile]) continue;
+
+        int row_begin = bounds_[tile];
+        int row_end = bounds_[tile + 1];
+        size_t bytes = (row_end - row_begin) * row_bytes;
+        char* dst = reinterpret_cast<char*>(C_local.data() + static_cast<size_t>(row_begin) * cols_);
+        off_t offset = file_offset(tile);
+
+        size_t done = 0;
+        while (done < bytes) {
+            ssize_t n = pread(data_fd_, dst + done, bytes - done, offset + done);
+            if (n <= 0) break;
+            done += n;
+        }
+        if (done != bytes) {
+            done_[tile] = 0;  // Recompute rather than trust a short read
+            continue;
+        }
+        ++restored;
+    }
+
+    stats_.tiles_resumed = restored;
+    return restored;
+}
+
+void TileCheckpoint::submit(int tile, const Matrix& C_local) {
+    Timer timer;
+    timer.start();
+
+    int row_begin = bounds_[tile];
+    int row_end = bounds_[tile + 1];
+    const double* src = C_local.data() + static_cast<size_t>(row_begin) * cols_;
+
+    PendingTile pending;
+    pending.tile = tile;
+    pending.rows.assign(src, src + static_cast<size_t>(row_end - row_begin) * cols_);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_cv_.wait(lock, [this] { return queue_.size() < MAX_PENDING_TILES; });
+        queue_.push_back(std::move(pending));
+    }
+    cv_.notify_one();
+
+    timer.stop();
+    stats_.submit_seconds += timer.elapsed_seconds();
+}
+
+void TileCheckpoint::finish() {
+    if (!writer_.joinable()) return;
+
+    Timer timer;
+    timer.start();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    writer_.join();
+    timer.stop();
+
+    // Draining the queue at the end stalls compute just like a blocked submit
+    stats_.submit_seconds += timer.elapsed_seconds();
+}
+
+void TileCheckpoint::writer_loop() {
+    using Clock = std::chrono::steady_clock;
+    auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(interval_seconds_));
+    auto next_flush = Clock::now() + interval;
+    bool dirty = false;
+
+    while (true) {
+        PendingTile pending{};
+        bool have_tile = false;
+        bool stop = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_until(lock, next_flush, [this] { return !queue_.empty() || stopping_; });
+            if (!queue_.empty()) {
+                pending = std::move(queue_.front());
+                queue_.pop_front();
+                have_tile = true;
+            }
+            stop = stopping_ && queue_.empty();
+        }
+
+        Timer timer;
+        timer.start();
+
+        if (have_tile) {
+            space_cv_.notify_one();
+
+            const char* src = reinterpret_cast<const char*>(pending.rows.data());
+            size_t bytes = pending.rows.size() * sizeof(double);
+            off_t offset = file_offset(pending.tile);
+            size_t done = 0;
+            while (done < bytes) {
+                ssize_t n = pwrite(data_fd_, src + done, bytes - done, offset + done);
+                if (n <= 0) break;
+                done += n;
+            }
+            if (done == bytes) {
+                written_[pending.tile] = 1;
+                stats_.tiles_written++;
+                stats_.bytes_written += bytes;
+                dirty = true;
+            } else {
+                std::cerr << "Warning: Failed to write checkpoint tile " << pending.tile
+                          << " to " << data_path_ << "\n";
+            }
+        }
+
+        if (dirty && (stop || Clock::now() >= next_flush)) {
+            flush_progress();
+            dirty = false;
+        }
+        if (Clock::now() >= next_flush) {
+            next_flush = Clock::now() + interval;
+        }
+
+        timer.stop();
+        stats_.writer_seconds += timer.elapsed_seconds();
+
+        if (stop) break;
+    }
+}
+
+void TileCheckpoint::flush_progress() {
+    // Data first: a tile may only appear in the bitmap once it is on disk
+    if (fdatasync(data_fd_) != 0) {
+        std::cerr << "Warning: fdatasync failed on " << data_path_ << "\n";
+        return;
+    }
+    for (int tile = 0; tile < num_tiles_; ++tile) {
+        if (written_[tile]) done_[tile] = 1;
+    }
+
+    // Completed pieces as global row ranges, adjacent ones merged
+    std::vector<int32_t> ranges;
+    for (int tile = 0; tile < num_tiles_; ++tile) {
+        if (!done_[tile]) continue;
+        int32_t begin = row_offset_ + bounds_[tile];
+        int32_t end = row_offset_ + bounds_[tile + 1];
+        if (!ranges.empty() && ranges.back() == begin) {
+            ranges.back() = end;
+        } else {
+            ranges.push_back(begin);
+            ranges.push_back(end);
+        }
+    }
+
+    MetaHeader header;
+    std::memcpy(header.magic, META_MAGIC, sizeof(header.magic));
+    header.fingerprint = fingerprint_;
+    header.total_rows = total_rows_;
+    header.cols = cols_;
+    header.tile_rows = tile_rows_;
+    header.ranges = static_cast<int32_t>(ranges.size() / 2);
+    ssize_t range_bytes = static_cast<ssize_t>(ranges.size() * sizeof(int32_t));
+
+    // Write-then-rename keeps the previous record valid until the new one is complete
+    std::string tmp_path = meta_path_ + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Warning: Could not write " << tmp_path << "\n";
+        return;
+    }
+    bool ok = write(fd, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header)) &&
+              write(fd, ranges.data(), range_bytes) == range_bytes &&
+              fsync(fd) == 0;
+    close(fd);
+    if (ok && rename(tmp_path.c_str(), meta_path_.c_str()) == 0) {
+        stats_.flushes++;
+    } else {
+        std::cerr << "Warning: Could not update " << meta_path_ << "\n";
+    }
+}
+
+#else
+
+TileCheckpoint::TileCheckpoint(const std::string&, int, int row_offset, int local_rows, int total_rows,
+                               int cols, int tile_rows, uint64_t fingerprint, double interval_seconds, bool)
+    : row_offset_(row_offset), local_rows_(local_rows), total_rows_(total_rows), cols_(cols),
+      tile_rows_(tile_rows), num_tiles_(local_rows > 0 ? 1 : 0), bounds_{0, local_rows},
+      fingerprint_(fingerprint), interval_seconds_(interval_seconds),
+      done_(num_tiles_, 0), written_(num_tiles_, 0) {
+    std::cerr << "Warning: Checkpointing is not supported on this platform\n";
+}
+
+TileCheckpoint::~TileCheckpoint() {}
+int TileCheckpoint::restore(Matrix&) { return 0; }
+void TileCheckpoint::submit(int, const Matrix&) {}
+void TileCheckpoint::finish() {}
+void TileCheckpoint::writer_loop() {}
+void TileCheckpoint::flush_progress() {}
+void TileCheckpoint::load_progress(const std::string&, bool) {}
+off_t TileCheckpoint::file_offset(int) const { return 0; }
+
+#endif
+
+int compute_tiles(Matrix& C_local, const Matrix& A_local, const Matrix& B,
+                   int row_offset, int tile_rows, const DistributedOptions& dist,
+                   const std::function<void(int, int)>& compute_rows) {
+    int local_rows = C_local.rows();
+
+    if (dist.checkpoint_dir.empty()) {
+        if (local_rows > 0) compute_rows(0, local_rows);
+        return local_rows;
+    }
+
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+#ifndef _WIN32
+    mkdir(dist.checkpoint_dir.c_str(), 0755);  // EEXIST is fine
+#endif
+
+    // A fresh run drops every earlier record first: its pieces are about to
+    // be overwritten, and a resume must not trust them afterwards
+    if (!dist.resume && rank == 0) {
+        for (int r = 0; file_exists(meta_path(dist.checkpoint_dir, r)); ++r) {
+            std::remove(meta_path(dist.checkpoint_dir, r).c_str());
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    tile_rows = std::max(1, tile_rows);
+    int total_rows = local_rows;
+    MPI_Allreduce(MPI_IN_PLACE, &total_rows, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    uint64_t problem = fingerprint(A_local, row_offset, total_rows, B, tile_rows);
+    TileCheckpoint ckpt(dist.checkpoint_dir, rank, row_offset, local_rows, total_rows, C_local.cols(),
+                        tile_rows, problem, dist.checkpoint_interval, dist.resume);
+
+    Timer total;
+    total.start();
+
+    int computed = 0;
+    if (!ckpt.ok()) {
+        if (local_rows > 0) compute_rows(0, local_rows);
+        computed = local_rows;
+    } else {
+        if (dist.resume) {
+            ckpt.restore(C_local);
+        }
+        for (int tile = 0; tile < ckpt.num_tiles(); ++tile) {
+            if (ckpt.tile_done(tile)) continue;
+            compute_rows(ckpt.tile_begin(tile), ckpt.tile_end(tile));
+            computed += ckpt.tile_end(tile) - ckpt.tile_begin(tile);
+            ckpt.submit(tile, C_local);
+        }
+        ckpt.finish();
+    }
+
+    total.stop();
+
+    // Combine per-rank statistics; overhead is judged by the slowest rank
+    const TileCheckpoint::Stats& st = ckpt.stats();
+    double local_max[3] = {st.submit_seconds, st.writer_seconds, total.elapsed_seconds()};
+    double global_max[3];
+    double local_sum[4] = {static_cast<double>(st.tiles_total), static_cast<double>(st.tiles_resumed),
+                           static_cast<double>(st.tiles_written), static_cast<double>(st.bytes_written)};
+    double global_sum[4];
+    MPI_Reduce(local_max, global_max, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(local_sum, global_sum, 4, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (rank == 0 && dist.report != nullptr) {
+        std::ostringstream tiles;
+        tiles << static_cast<long long>(global_sum[2]) << " written, "
+              << static_cast<long long>(global_sum[1]) << " resumed, "
+              << static_cast<long long>(global_sum[0]) << " total ("
+              << tile_rows << " rows each)";
+
+        std::ostringstream data;
+        data << std::fixed << std::setprecision(2) << (global_sum[3] / (1024.0 * 1024.0))
+             << " MB, interval " << dist.checkpoint_interval << " s";
+
+        std::ostringstream overhead;
+        double stall = global_max[0];
+        double elapsed = global_max[2];
+        overhead << format_seconds(stall) << " compute stall ("
+                 << std::fixed << std::setprecision(2)
+                 << (elapsed > 0.0 ? 100.0 * stall / elapsed : 0.0) << "%), writer busy "
+                 << format_seconds(global_max[1]);
+
+        dist.report->add("Checkpoint", dist.checkpoint_dir);
+        dist.report->add("Ckpt Tiles", tiles.str());
+        dist.report->add("Ckpt Data", data.str());
+        dist.report->add("Ckpt Overhead", overhead.str());
+    }
+    return computed;
+}
+
+} // namespace checkpoint
+} // namespace matmul
@@ -83,7 +83,7 @@ bool CliMenu::run(Config& config) {
             // Step 5: Show summary and confirm
             display_config_summary(config);
         } else {
-            // Naive/Strassen workflow with full configuration
+            // Naive/Strassen/Winograd workflow with full configuration
             // Step 3: Select execution mode
             config.mode = select_execution_mode();
 
@@ -122,12 +122,14 @@ Algorithm CliMenu::select_algorithm() {
     std::vector<std::string> options = {
         "Naive Matrix Multiplication",
         "Strassen Algorithm",
-        "OpenBLAS (Reference)"
+        "OpenBLAS (Reference)",
+        "Winograd Inner Product"
     };
     std::vector<Algorithm> values = {
         Algorithm::NAIVE,
         Algorithm::STRASSEN,
-        Algorithm::OPENBLAS
+        Algorithm::OPENBLAS,
+        Algorithm::WINOGRAD
     };
 
     return select_from_menu("Select Algorithm", options, values);
@@ -272,12 +274,14 @@ std::vector<Algorithm> CliMenu::select_algorithms_to_verify() {
     std::vector<std::string> options = {
         "Naive",
         "Strassen",
-        "OpenBLAS"
+        "OpenBLAS",
+        "Winograd"
     };
     std::vector<Algorithm> values = {
         Algorithm::NAIVE,
         Algorithm::STRASSEN,
-        Algorithm::OPENBLAS
+        Algorithm::OPENBLAS,
+        Algorithm::WINOGRAD
     };
 
     prompts::display_info("Select at least 2 algorithms to compare");
@@ -0,0 +1,594 @@
+#include "comm.hpp"
+#include "compression.hpp"
+#include "timer.hpp"
+#include <omp.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace matmul {
+namespace comm {
+
+namespace {
+
+// Payloads below this size are always sent as-is
+const size_t MIN_COMPRESS_BYTES = 1 << 20;
+
+// Doubles per pipelined segment of a compressed broadcast
+const size_t SEGMENT_DOUBLES = 1 << 20;
+
+// Values per block of the SPLIT format; a block's lo parts are sent only
+// if one of them is nonzero (values not exactly representable as float)
+const size_t SPLIT_BLOCK = 1024;
+
+// Link bandwidth probe: broadcast this many bytes, best of PROBE_REPS
+const int PROBE_BYTES = 4 << 20;
+const int PROBE_REPS = 3;
+
+Stats g_stats;
+
+// Adds the wall time of the enclosing wrapper call to g_stats.seconds
+struct ScopedCommTime {
+    double start = MPI_Wtime();
+    ~ScopedCommTime() { g_stats.seconds += MPI_Wtime() - start; }
+};
+
+std::string format_rate(double bytes_per_second) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << bytes_per_second / 1e9 << " GB/s";
+    return oss.str();
+}
+
+// Measure broadcast bandwidth once per process (collective)
+double link_bandwidth(MPI_Comm comm) {
+    if (g_stats.link_bandwidth > 0.0) return g_stats.link_bandwidth;
+
+    // The same buffer is broadcast every repetition, so set the request up once
+    std::vector<char> probe(PROBE_BYTES, 1);
+    PersistentBcast probe_bcast(probe.data(), PROBE_BYTES, MPI_BYTE, 0, comm);
+    double best = 0.0;
+    for (int rep = 0; rep < PROBE_REPS; ++rep) {
+        MPI_Barrier(comm);
+        double start = MPI_Wtime();
+        probe_bcast.start();
+        probe_bcast.wait();
+        MPI_Barrier(comm);
+        double elapsed = MPI_Wtime() - start;
+        MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, comm);
+        if (rep == 0 || elapsed < best) best = elapsed;
+    }
+
+    g_stats.link_bandwidth = PROBE_BYTES / std::max(best, 1e-9);
+    return g_stats.link_bandwidth;
+}
+
+// Compression ratio and parallel codec throughput, measured on one chunk
+// per thread so the codec runs as wide as it does on the real payload
+struct CodecSample {
+    double ratio = 1.0;
+    double encode_rate = 0.0;   // bytes/s, all threads
+    double decode_rate = 0.0;
+};
+
+CodecSample sample_codec(const double* data, size_t count) {
+    CodecSample sample;
+    size_t threads = static_cast<size_t>(omp_get_max_threads());
+    size_t len = std::min(count, compression::CHUNK_DOUBLES * threads);
+    if (len == 0) return sample;
+
+    std::vector<uint8_t> encoded;
+    std::vector<double> decoded(len);
+    size_t bytes = len * sizeof(double);
+
+    compression::encode(data, len, encoded);  // Warm-up: buffers and thread pool
+
+    Timer timer;
+    timer.start();
+    compression::encode(data, len, encoded);
+    timer.stop();
+    sample.encode_rate = bytes / std::max(timer.elapsed_seconds(), 1e-9);
+
+    timer.start();
+    compression::decode(encoded.data(), encoded.size(), decoded.data(), len);
+    timer.stop();
+    sample.decode_rate = bytes / std::max(timer.elapsed_seconds(), 1e-9);
+
+    sample.ratio = static_cast<double>(encoded.size()) / bytes;
+    return sample;
+}
+
+// AUTO rule: compress when encode + reduced transfer + decode beats the plain transfer
+bool profitable(double bytes, double bandwidth, const CodecSample& s) {
+    std::ostringstream why;
+    double plain = bytes / bandwidth;
+    double compressed = bytes / s.encode_rate + bytes * s.ratio / bandwidth + bytes / s.decode_rate;
+    bool on = compressed < plain;
+
+    why << (on ? "on" : "off") << ": link " << format_rate(bandwidth)
+        << ", ratio " << std::fixed << std::setprecision(3) << s.ratio
+        << ", codec " << format_rate(std::min(s.encode_rate, s.decode_rate));
+    g_stats.last_decision = why.str();
+    return on;
+}
+
+// Plain broadcast, split so each call's count fits in an int
+void plain_bcast(double* data, size_t count, int root, MPI_Comm comm) {
+    const size_t max_count = INT_MAX / 2;
+    for (size_t offset = 0; offset < count; offset += max_count) {
+        int len = static_cast<int>(std::min(max_count, count - offset));
+        MPI_Bcast(data + offset, len, MPI_DOUBLE, root, comm);
+    }
+}
+
+// Reduced-precision wire formats
+//   FP32:  float[count]
+//   SPLIT: uint8 has_lo[blocks] (padded to 4 bytes), float hi[count],
+//          float lo[SPLIT_BLOCK] for each flagged block
+void pack_precision(const double* data, size_t count, CommPrecision precision,
+                    std::vector<uint8_t>& out) {
+    if (precision == CommPrecision::FP32) {
+        out.resize(count * sizeof(float));
+        float* values = reinterpret_cast<float*>(out.data());
+        #pragma omp parallel for schedule(static)
+        for (long long i = 0; i < static_cast<long long>(count); ++i) {
+            values[i] = static_cast<float>(data[i]);
+        }
+        return;
+    }
+
+    size_t blocks = (count + SPLIT_BLOCK - 1) / SPLIT_BLOCK;
+    size_t flags_bytes = (blocks + 3) & ~static_cast<size_t>(3);
+    std::vector<float> lo(count);
+    out.assign(flags_bytes + count * sizeof(float), 0);
+    uint8_t* has_lo = out.data();
+    float* hi = reinterpret_cast<float*>(out.data() + flags_bytes);
+
+    #pragma omp parallel for schedule(static)
+    for (long long b = 0; b < static_cast<long long>(blocks); ++b) {
+        size_t begin = b * SPLIT_BLOCK;
+        size_t end = std::min(begin + SPLIT_BLOCK, count);
+        bool any = false;
+        for (size_t i = begin; i < end; ++i) {
+            hi[i] = static_cast<float>(data[i]);
+            lo[i] = static_cast<float>(data[i] - static_cast<double>(hi[i]));
+            any = any || lo[i] != 0.0f;
+        }
+        has_lo[b] = any ? 1 : 0;
+    }
+
+    size_t lo_blocks = 0;
+    for (size_t b = 0; b < blocks; ++b) lo_blocks += has_lo[b];
+    std::vector<uint8_t> flags(has_lo, has_lo + blocks);
+
+    // Append the lo parts of the flagged blocks (resizing invalidates has_lo/hi)
+    size_t pos = out.size();
+    out.resize(pos + lo_blocks * SPLIT_BLOCK * sizeof(float));
+    for (size_t b = 0; b < blocks; ++b) {
+        if (!flags[b]) continue;
+        size_t begin = b * SPLIT_BLOCK;
+        size_t len = std::min(SPLIT_BLOCK, count - begin);
+        std::memcpy(out.data() + pos, lo.data() + begin, len * sizeof(float));
+        pos += len * sizeof(float);
+    }
+    out.resize(pos);
+}
+
+bool unpack_precision(const uint8_t* in, size_t bytes, double* data, size_t count,
+                      CommPrecision precision) {
+    if (precision == CommPrecision::FP32) {
+        if (bytes != count * sizeof(float)) return false;
+        const float* values = reinterpret_cast<const float*>(in);
+        #pragma omp parallel for schedule(static)
+        for (long long i = 0; i < static_cast<long long>(count); ++i) {
+            data[i] = values[i];
+        }
+        return true;
+    }
+
+    size_t blocks = (count + SPLIT_BLOCK - 1) / SPLIT_BLOCK;
+    size_t flags_bytes = (blocks + 3) & ~static_cast<size_t>(3);
+    if (bytes < flags_bytes + count * sizeof(float)) return false;
+    const uint8_t* has_lo = in;
+    const float* hi = reinterpret_cast<const float*>(in + flags_bytes);
+
+    // Offset of each flagged block's lo values
+    std::vector<size_t> lo_offset(blocks);
+    size_t pos = flags_bytes + count * sizeof(float);
+    for (size_t b = 0; b < blocks; ++b) {
+        lo_offset[b] = pos;
+        if (has_lo[b]) pos += std::min(SPLIT_BLOCK, count - b * SPLIT_BLOCK) * sizeof(float);
+    }
+    if (pos != bytes) return false;
+
+    #pragma omp parallel for schedule(static)
+    for (long long b = 0; b < static_cast<long long>(blocks); ++b) {
+        size_t begin = b * SPLIT_BLOCK;
+        size_t end = std::min(begin + SPLIT_BLOCK, count);
+        const float* lo = reinterpret_cast<const float*>(in + lo_offset[b]);
+        for (size_t i = begin; i < end; ++i) {
+            data[i] = static_cast<double>(hi[i]);
+            if (has_lo[b]) data[i] += static_cast<double>(lo[i - begin]);
+        }
+    }
+    return true;
+}
+
+// Decode what the sender packed and record how far the received values will
+// be from the exact ones (the sender is the only rank that has both)
+void record_rounding(const double* exact, size_t count, const std::vector<uint8_t>& packed,
+                     CommPrecision precision) {
+    std::vector<double> received(count);
+    if (!unpack_precision(packed.data(), packed.size(), received.data(), count, precision)) return;
+    double max_abs = 0.0;
+    double max_rel = 0.0;
+    #pragma omp parallel for schedule(static) reduction(max : max_abs, max_rel)
+    for (long long i = 0; i < static_cast<long long>(count); ++i) {
+        double diff = std::abs(received[i] - exact[i]);
+        max_abs = std::max(max_abs, diff);
+        if (exact[i] != 0.0) max_rel = std::max(max_rel, diff / std::abs(exact[i]));
+    }
+    g_stats.max_abs_error = std::max(g_stats.max_abs_error, max_abs);
+    g_stats.max_rel_error = std::max(g_stats.max_rel_error, max_rel);
+}
+
+// Broadcast a byte buffer whose size only the root knows
+void bcast_bytes(std::vector<uint8_t>& buf, int root, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    unsigned long long bytes = buf.size();
+    MPI_Bcast(&bytes, 1, MPI_UNSIGNED_LONG_LONG, root, comm);
+    if (rank != root) buf.resize(bytes);
+
+    const size_t max_count = INT_MAX;
+    for (size_t offset = 0; offset < bytes; offset += max_count) {
+        int len = static_cast<int>(std::min<size_t>(max_count, bytes - offset));
+        MPI_Bcast(buf.data() + offset, len, MPI_BYTE, root, comm);
+    }
+}
+
+// All-gather one variable-size byte buffer per rank into all (rank i's at offsets[i])
+void allgather_bytes(const std::vector<uint8_t>& mine, std::vector<uint8_t>& all,
+                     std::vector<int>& sizes, std::vector<int>& offsets, MPI_Comm comm) {
+    int size;
+    MPI_Comm_size(comm, &size);
+
+    int my_bytes = static_cast<int>(mine.size());
+    sizes.assign(size, 0);
+    offsets.assign(size, 0);
+    MPI_Allgather(&my_bytes, 1, MPI_INT, sizes.data(), 1, MPI_INT, comm);
+    int offset = 0;
+    for (int i = 0; i < size; ++i) {
+        offsets[i] = offset;
+        offset += sizes[i];
+    }
+
+    all.resize(offset);
+    MPI_Allgatherv(mine.data(), my_bytes, MPI_BYTE,
+                   all.data(), sizes.data(), offsets.data(), MPI_BYTE, comm);
+}
+
+} // namespace
+
+Stats& stats() {
+    return g_stats;
+}
+
+void reset_stats() {
+    double bandwidth = g_stats.link_bandwidth;  // The link doesn't change between runs
+    g_stats = Stats();
+    g_stats.link_bandwidth = bandwidth;
+}
+
+void bcast(double* data, size_t count, int root, MPI_Comm comm,
+           const DistributedOptions& dist) {
+    ScopedCommTime scoped_time;
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    size_t bytes = count * sizeof(double);
+
+    if (size > 1 && dist.precision != CommPrecision::FP64) {
+        // Reduced precision: the root keeps its exact values
+        std::vector<uint8_t> packed;
+        Timer timer;
+        if (rank == root) {
+            timer.start();
+            pack_precision(data, count, dist.precision, packed);
+            timer.stop();
+            g_stats.encode_seconds += timer.elapsed_seconds();
+            g_stats.raw_bytes += bytes;
+            g_stats.wire_bytes += packed.size();
+            g_stats.reduced_messages++;
+            record_rounding(data, count, packed, dist.precision);
+        }
+        bcast_bytes(packed, root, comm);
+        if (rank != root) {
+            timer.start();
+            bool ok = unpack_precision(packed.data(), packed.size(), data, count, dist.precision);
+            timer.stop();
+            g_stats.decode_seconds += timer.elapsed_seconds();
+            if (!ok) {
+                throw std::runtime_error("Malformed reduced-precision MPI payload");
+            }
+        }
+        return;
+    }
+
+    bool compress = size > 1 && bytes >= MIN_COMPRESS_BYTES &&
+                    dist.compression != CompressionMode::OFF;
+
+    if (compress && dist.compression == CompressionMode::AUTO) {
+        double bandwidth = link_bandwidth(comm);
+        int decision = 0;
+        if (rank == root) {
+            decision = profitable(bytes, bandwidth, sample_codec(data, count)) ? 1 : 0;
+        }
+        MPI_Bcast(&decision, 1, MPI_INT, root, comm);
+        compress = decision != 0;
+    }
+
+    if (rank == root) {
+        g_stats.raw_bytes += bytes;
+    }
+
+    if (!compress) {
+        plain_bcast(data, count, root, comm);
+        if (rank == root) {
+            g_stats.wire_bytes += bytes;
+            g_stats.plain_messages++;
+        }
+        return;
+    }
+
+    // Pipeline: the root encodes segment s+1 while segment s is in flight,
+    // receivers decode segment s-1 while receiving segment s
+    size_t segments = (count + SEGMENT_DOUBLES - 1) / SEGMENT_DOUBLES;
+    std::vector<uint8_t> buffers[2];
+    Timer timer;
+
+    auto segment_range = [&](size_t s, size_t& begin, size_t& len) {
+        begin = s * SEGMENT_DOUBLES;
+        len = std::min(SEGMENT_DOUBLES, count - begin);
+    };
+
+    auto decode_segment = [&](size_t s) {
+        size_t begin, len;
+        segment_range(s, begin, len);
+        const std::vector<uint8_t>& buf = buffers[s % 2];
+        timer.start();
+        bool ok = compression::decode(buf.data(), buf.size(), data + begin, len);
+        timer.stop();
+        g_stats.decode_seconds += timer.elapsed_seconds();
+        if (!ok) {
+            throw std::runtime_error("Corrupt compressed MPI payload");
+        }
+    };
+
+    auto encode_segment = [&](size_t s) {
+        size_t begin, len;
+        segment_range(s, begin, len);
+        timer.start();
+        compression::encode(data + begin, len, buffers[s % 2]);
+        timer.stop();
+        g_stats.encode_seconds += timer.elapsed_seconds();
+    };
+
+    if (rank == root) encode_segment(0);
+
+    // Every segment is announced by its encoded size from the same variable
+    unsigned long long seg_bytes = 0;
+    PersistentBcast size_bcast(&seg_bytes, 1, MPI_UNSIGNED_LONG_LONG, root, comm);
+
+    for (size_t s = 0; s < segments; ++s) {
+        std::vector<uint8_t>& buf = buffers[s % 2];
+        if (rank == root) seg_bytes = buf.size();
+        size_bcast.start();
+        size_bcast.wait();
+        if (rank != root) buf.resize(seg_bytes);
+
+        MPI_Request request;
+        MPI_Ibcast(buf.data(), static_cast<int>(seg_bytes), MPI_BYTE, root, comm, &request);
+
+        if (rank == root) {
+            g_stats.wire_bytes += seg_bytes;
+            if (s + 1 < segments) encode_segment(s + 1);
+        } else if (s > 0) {
+            decode_segment(s - 1);
+        }
+
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+    }
+
+    if (rank != root && segments > 0) {
+        decode_segment(segments - 1);
+    }
+    if (rank == root) {
+        g_stats.compressed_messages++;
+    }
+}
+
+void allgatherv(const double* send, int send_count, double* recv,
+                const std::vector<int>& counts, const std::vector<int>& displs,
+                MPI_Comm comm, const DistributedOptions& dist) {
+    ScopedCommTime scoped_time;
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    size_t total = 0;
+    for (int c : counts) total += c;
+
+    bool reduced = size > 1 && dist.precision != CommPrecision::FP64;
+    bool compress = !reduced && size > 1 && total * sizeof(double) >= MIN_COMPRESS_BYTES &&
+                    dist.compression != CompressionMode::OFF;
+
+    if (compress && dist.compression == CompressionMode::AUTO) {
+        // Every rank samples its own stripe; decide on the worst case. A rank
+        // with nothing to send has no codec cost and must not veto the rest.
+        double bandwidth = link_bandwidth(comm);
+        CodecSample sample = sample_codec(send, send_count);
+        if (send_count == 0) {
+            sample.ratio = 0.0;
+            sample.encode_rate = std::numeric_limits<double>::max();
+            sample.decode_rate = std::numeric_limits<double>::max();
+        }
+        MPI_Allreduce(MPI_IN_PLACE, &sample.ratio, 1, MPI_DOUBLE, MPI_MAX, comm);
+        MPI_Allreduce(MPI_IN_PLACE, &sample.encode_rate, 1, MPI_DOUBLE, MPI_MIN, comm);
+        MPI_Allreduce(MPI_IN_PLACE, &sample.decode_rate, 1, MPI_DOUBLE, MPI_MIN, comm);
+        compress = profitable(total * sizeof(double), bandwidth, sample);
+    }
+
+    g_stats.raw_bytes += static_cast<uint64_t>(send_count) * sizeof(double);
+
+    if (!reduced && !compress) {
+        MPI_Allgatherv(send, send_count, MPI_DOUBLE,
+                       recv, counts.data(), displs.data(), MPI_DOUBLE, comm);
+        g_stats.wire_bytes += static_cast<uint64_t>(send_count) * sizeof(double);
+        g_stats.plain_messages++;
+        return;
+    }
+
+    // Encode the own stripe, exchange the encoded stripes, decode the others
+    Timer timer;
+    timer.start();
+    std::vector<uint8_t> encoded;
+    if (reduced) {
+        pack_precision(send, send_count, dist.precision, encoded);
+        g_stats.reduced_messages++;
+    } else {
+        compression::encode(send, send_count, encoded);
+        g_stats.compressed_messages++;
+    }
+    timer.stop();
+    g_stats.encode_seconds += timer.elapsed_seconds();
+    g_stats.wire_bytes += encoded.size();
+    if (reduced) record_rounding(send, send_count, encoded, dist.precision);
+
+    std::vector<uint8_t> gathered;
+    std::vector<int> byte_counts;
+    std::vector<int> byte_displs;
+    allgather_bytes(encoded, gathered, byte_counts, byte_displs, comm);
+
+    timer.start();
+    bool ok = true;
+    for (int i = 0; i < size; ++i) {
+        if (i == rank) {
+            std::memcpy(recv + displs[i], send, static_cast<size_t>(send_count) * sizeof(double));
+        } else if (counts[i] > 0) {
+            const uint8_t* blob = gathered.data() + byte_displs[i];
+            ok = (reduced ? unpack_precision(blob, byte_counts[i], recv + displs[i], counts[i], dist.precision)
+                          : compression::decode(blob, byte_counts[i], recv + displs[i], counts[i])) && ok;
+        }
+    }
+    timer.stop();
+    g_stats.decode_seconds += timer.elapsed_seconds();
+
+    if (!ok) {
+        throw std::runtime_error("Corrupt encoded MPI payload");
+    }
+}
+
+PersistentBcast::PersistentBcast(void* buf, int count, MPI_Datatype type, int root,
+                                 MPI_Comm comm) {
+#if MPI_VERSION >= 4
+    requests_.resize(1);
+    MPI_Bcast_init(buf, count, type, root, comm, MPI_INFO_NULL, &requests_[0]);
+    native_ = true;
+#else
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    if (rank == root) {
+        for (int peer = 0; peer < size; ++peer) {
+            if (peer == root) continue;
+            requests_.emplace_back();
+            MPI_Send_init(buf, count, type, peer, 0, comm, &requests_.back());
+        }
+    } else {
+        requests_.emplace_back();
+        MPI_Recv_init(buf, count, type, root, 0, comm, &requests_.back());
+    }
+#endif
+}
+
+PersistentBcast::~PersistentBcast() {
+    for (MPI_Request& request : requests_) {
+        MPI_Request_free(&request);
+    }
+}
+
+void PersistentBcast::start() {
+    if (!requests_.empty()) {
+        MPI_Startall(static_cast<int>(requests_.size()), requests_.data());
+    }
+}
+
+void PersistentBcast::wait() {
+    if (!requests_.empty()) {
+        MPI_Waitall(static_cast<int>(requests_.size()), requests_.data(), MPI_STATUSES_IGNORE);
+    }
+}
+
+void report(const DistributedOptions& dist) {
+    if (dist.compression == CompressionMode::OFF && dist.precision == CommPrecision::FP64) return;
+
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    double sums[5] = {static_cast<double>(g_stats.raw_bytes), static_cast<double>(g_stats.wire_bytes),
+                      static_cast<double>(g_stats.compressed_messages),
+                      static_cast<double>(g_stats.reduced_messages),
+                      static_cast<double>(g_stats.plain_messages)};
+    double maxes[4] = {g_stats.encode_seconds, g_stats.decode_seconds, g_stats.max_abs_error,
+                       g_stats.max_rel_error};
+    MPI_Reduce(rank == 0 ? MPI_IN_PLACE : sums, sums, 5, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(rank == 0 ? MPI_IN_PLACE : maxes, maxes, 4, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rank != 0 || dist.report == nullptr) return;
+
+    if (dist.precision != CommPrecision::FP64) {
+        dist.report->add("Comm Precision", precision_to_string(dist.precision) + " (compute FP64)");
+    } else {
+        std::ostringstream mode;
+        mode << compression_to_string(dist.compression);
+        if (dist.compression == CompressionMode::AUTO && !g_stats.last_decision.empty()) {
+            mode << " (" << g_stats.last_decision << ")";
+        }
+        dist.report->add("Compression", mode.str());
+    }
+
+    double saved = sums[0] > 0.0 ? 100.0 * (1.0 - sums[1] / sums[0]) : 0.0;
+    if (std::abs(saved) < 0.05) saved = 0.0;  // Header/flag overhead only
+    std::ostringstream traffic;
+    traffic << std::fixed << std::setprecision(2)
+            << sums[0] / (1024.0 * 1024.0) << " MB sent as "
+            << sums[1] / (1024.0 * 1024.0) << " MB (" << std::setprecision(1)
+            << saved << "% saved; "
+            << static_cast<int>(sums[2]) << " compressed, "
+            << static_cast<int>(sums[3]) << " reduced, "
+            << static_cast<int>(sums[4]) << " plain messages)";
+
+    std::ostringstream codec;
+    codec << std::fixed << std::setprecision(3) << "encode " << maxes[0]
+          << " s, decode " << maxes[1] << " s (slowest rank)";
+
+    dist.report->add("MPI Traffic", traffic.str());
+    if (dist.precision != CommPrecision::FP64) {
+        // What the reduced formats did to the transferred A, B and C values
+        std::ostringstream error;
+        error << std::scientific << std::setprecision(3) << "max abs " << maxes[2]
+              << ", max rel " << maxes[3] << " (received vs. exact values)";
+        dist.report->add("Wire Error", error.str());
+    }
+    dist.report->add("Codec Time", codec.str());
+}
+
+} // namespace comm
+} // namespace matmul
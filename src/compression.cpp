@@ -0,0 +1,235 @@
+#include "compression.hpp"
+#include <omp.h>
+#include <algorithm>
+#include <cstring>
+
+namespace matmul {
+namespace compression {
+
+namespace {
+
+// Plane storage modes
+const uint8_t PLANE_RAW = 0;
+const uint8_t PLANE_CONSTANT = 1;
+const uint8_t PLANE_SPARSE = 2;
+
+// Chunk header: element count, plane modes, encoded plane sizes
+struct ChunkHeader {
+    uint32_t count;
+    uint8_t modes[8];
+    uint32_t plane_bytes[8];
+};
+
+size_t num_chunks(size_t count) {
+    return (count + CHUNK_DOUBLES - 1) / CHUNK_DOUBLES;
+}
+
+size_t max_chunk_size(size_t count) {
+    return sizeof(ChunkHeader) + 8 * count;
+}
+
+// Encode one chunk; returns bytes written to out
+size_t encode_chunk(const double* data, size_t count, uint8_t* out, std::vector<uint8_t>& planes) {
+    planes.resize(8 * count);
+
+    // XOR predictor + byte-plane shuffle
+    uint64_t prev = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t bits;
+        std::memcpy(&bits, &data[i], sizeof(bits));
+        uint64_t residual = bits ^ prev;
+        prev = bits;
+        for (int p = 0; p < 8; ++p) {
+            planes[p * count + i] = static_cast<uint8_t>(residual >> (8 * p));
+        }
+    }
+
+    ChunkHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.count = static_cast<uint32_t>(count);
+    uint8_t* dst = out + sizeof(ChunkHeader);
+    size_t bitmap_bytes = (count + 7) / 8;
+
+    for (int p = 0; p < 8; ++p) {
+        const uint8_t* plane = &planes[p * count];
+
+        size_t nonzero = 0;
+        bool constant = true;
+        for (size_t i = 0; i < count; ++i) {
+            nonzero += plane[i] != 0;
+            constant &= plane[i] == plane[0];
+        }
+
+        if (constant) {
+            header.modes[p] = PLANE_CONSTANT;
+            header.plane_bytes[p] = 1;
+            dst[0] = plane[0];
+            dst += 1;
+        } else if (bitmap_bytes + nonzero < count) {
+            header.modes[p] = PLANE_SPARSE;
+            header.plane_bytes[p] = static_cast<uint32_t>(bitmap_bytes + nonzero);
+            uint8_t* bitmap = dst;
+            uint8_t* values = dst + bitmap_bytes;
+            std::memset(bitmap, 0, bitmap_bytes);
+            for (size_t i = 0; i < count; ++i) {
+                if (plane[i] != 0) {
+                    bitmap[i >> 3] |= static_cast<uint8_t>(1u << (i & 7));
+                    *values++ = plane[i];
+                }
+            }
+            dst += header.plane_bytes[p];
+        } else {
+            header.modes[p] = PLANE_RAW;
+            header.plane_bytes[p] = static_cast<uint32_t>(count);
+            std::memcpy(dst, plane, count);
+            dst += count;
+        }
+    }
+
+    std::memcpy(out, &header, sizeof(header));
+    return dst - out;
+}
+
+// Decode one chunk of exactly count doubles; false if malformed
+bool decode_chunk(const uint8_t* in, size_t bytes, double* data, size_t count,
+                  std::vector<uint8_t>& planes) {
+    ChunkHeader header;
+    if (bytes < sizeof(header)) return false;
+    std::memcpy(&header, in, sizeof(header));
+    if (header.count != count) return false;
+
+    planes.resize(8 * count);
+    const uint8_t* src = in + sizeof(header);
+    const uint8_t* end = in + bytes;
+    size_t bitmap_bytes = (count + 7) / 8;
+
+    for (int p = 0; p < 8; ++p) {
+        uint8_t* plane = &planes[p * count];
+        if (header.plane_bytes[p] > static_cast<size_t>(end - src)) return false;
+
+        switch (header.modes[p]) {
+            case PLANE_CONSTANT:
+                if (header.plane_bytes[p] != 1) return false;
+                std::memset(plane, src[0], count);
+                break;
+            case PLANE_SPARSE: {
+                // The bitmap alone must fit in the plane before any of it is read
+                if (header.plane_bytes[p] < bitmap_bytes) return false;
+                const uint8_t* bitmap = src;
+                const uint8_t* values = src + bitmap_bytes;
+                const uint8_t* values_end = src + header.plane_bytes[p];
+                for (size_t i = 0; i < count; ++i) {
+                    if (bitmap[i >> 3] & (1u << (i & 7))) {
+                        if (values >= values_end) return false;
+                        plane[i] = *values++;
+                    } else {
+                        plane[i] = 0;
+                    }
+                }
+                break;
+            }
+            case PLANE_RAW:
+                if (header.plane_bytes[p] != count) return false;
+                std::memcpy(plane, src, count);
+                break;
+            default:
+                return false;
+        }
+        src += header.plane_bytes[p];
+    }
+
+    // Unshuffle + undo the XOR predictor
+    uint64_t prev = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t residual = 0;
+        for (int p = 0; p < 8; ++p) {
+            residual |= static_cast<uint64_t>(planes[p * count + i]) << (8 * p);
+        }
+        uint64_t bits = residual ^ prev;
+        prev = bits;
+        std::memcpy(&data[i], &bits, sizeof(bits));
+    }
+
+    return true;
+}
+
+} // namespace
+
+size_t max_encoded_size(size_t count) {
+    size_t chunks = num_chunks(count);
+    return sizeof(uint32_t) * (1 + chunks) + chunks * sizeof(ChunkHeader) + 8 * count;
+}
+
+void encode(const double* data, size_t count, std::vector<uint8_t>& out) {
+    // Layout: [num_chunks][chunk sizes...][chunk 0][chunk 1]...
+    size_t chunks = num_chunks(count);
+    std::vector<std::vector<uint8_t>> encoded(chunks);
+    std::vector<uint32_t> sizes(chunks);
+
+    #pragma omp parallel
+    {
+        std::vector<uint8_t> planes;
+
+        #pragma omp for schedule(dynamic)
+        for (long long c = 0; c < static_cast<long long>(chunks); ++c) {
+            size_t begin = c * CHUNK_DOUBLES;
+            size_t len = std::min(CHUNK_DOUBLES, count - begin);
+            encoded[c].resize(max_chunk_size(len));
+            sizes[c] = static_cast<uint32_t>(encode_chunk(data + begin, len, encoded[c].data(), planes));
+        }
+    }
+
+    size_t total = sizeof(uint32_t) * (1 + chunks);
+    for (uint32_t size : sizes) total += size;
+
+    out.resize(total);
+    uint32_t num = static_cast<uint32_t>(chunks);
+    std::memcpy(out.data(), &num, sizeof(num));
+    std::memcpy(out.data() + sizeof(num), sizes.data(), chunks * sizeof(uint32_t));
+
+    uint8_t* dst = out.data() + sizeof(uint32_t) * (1 + chunks);
+    for (size_t c = 0; c < chunks; ++c) {
+        std::memcpy(dst, encoded[c].data(), sizes[c]);
+        dst += sizes[c];
+    }
+}
+
+bool decode(const uint8_t* in, size_t bytes, double* data, size_t count) {
+    size_t chunks = num_chunks(count);
+    size_t dir_bytes = sizeof(uint32_t) * (1 + chunks);
+    if (bytes < dir_bytes) return false;
+
+    uint32_t num;
+    std::memcpy(&num, in, sizeof(num));
+    if (num != chunks) return false;
+
+    std::vector<uint32_t> sizes(chunks);
+    std::memcpy(sizes.data(), in + sizeof(num), chunks * sizeof(uint32_t));
+
+    std::vector<size_t> offsets(chunks);
+    size_t offset = dir_bytes;
+    for (size_t c = 0; c < chunks; ++c) {
+        offsets[c] = offset;
+        offset += sizes[c];
+    }
+    if (offset > bytes) return false;
+
+    bool ok = true;
+
+    #pragma omp parallel
+    {
+        std::vector<uint8_t> planes;
+
+        #pragma omp for schedule(dynamic) reduction(&& : ok)
+        for (long long c = 0; c < static_cast<long long>(chunks); ++c) {
+            size_t begin = c * CHUNK_DOUBLES;
+            size_t len = std::min(CHUNK_DOUBLES, count - begin);
+            ok = decode_chunk(in + offsets[c], sizes[c], data + begin, len, planes) && ok;
+        }
+    }
+
+    return ok;
+}
+
+} // namespace compression
+} // namespace matmul
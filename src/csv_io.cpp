@@ -2,8 +2,20 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
 #include <sys/stat.h>
 
+#ifdef _WIN32
+    #include <vector>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
 namespace matmul {
 
 bool CsvIO::read_matrix(const std::string& filename, Matrix& matrix) {
@@ -63,6 +75,190 @@ bool CsvIO::read_matrix(const std::string& filename, Matrix& matrix) {
     return true;
 }
 
+namespace {
+
+// Read-only view of a whole file: mmap on POSIX, a plain read elsewhere
+class FileView {
+public:
+    explicit FileView(const std::string& filename) {
+#ifdef _WIN32
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) return;
+        buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        ok_ = true;
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            size_ = static_cast<size_t>(st.st_size);
+            if (size_ == 0) {
+                ok_ = true;
+            } else {
+                void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr != MAP_FAILED) {
+                    madvise(addr, size_, MADV_SEQUENTIAL);
+                    data_ = static_cast<const char*>(addr);
+                    ok_ = true;
+                }
+            }
+        }
+        close(fd);
+#endif
+    }
+
+    ~FileView() {
+#ifndef _WIN32
+        if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+
+    bool ok() const { return ok_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool ok_ = false;
+#ifdef _WIN32
+    std::vector<char> buffer_;
+#endif
+};
+
+// Parse one CSV line in [begin, end) and append its values to out
+// Returns the number of values, or -1 on a malformed number
+int parse_csv_line(const char* begin, const char* end, std::vector<double>& out) {
+    int count = 0;
+    const char* p = begin;
+
+    // A trailing comma ends the line, matching std::getline-based read_matrix
+    while (true) {
+        const char* field_end = p;
+        while (field_end < end && *field_end != ',') ++field_end;
+
+        // Trim whitespace (same set as CsvIO::trim) and an optional leading '+'
+        const char* b = p;
+        const char* e = field_end;
+        while (b < e && (*b == ' ' || *b == '\t' || *b == '\r' || *b == '\f' || *b == '\v')) ++b;
+        while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r' || e[-1] == '\f' || e[-1] == '\v')) --e;
+        if (b < e && *b == '+') ++b;
+
+        double value;
+        auto res = std::from_chars(b, e, value);
+        if (res.ec != std::errc() || res.ptr != e) {
+            std::cerr << "Error: Invalid number in CSV: '" << std::string(p, field_end) << "'\n";
+            return -1;
+        }
+        out.push_back(value);
+        ++count;
+
+        if (field_end >= end || field_end + 1 == end) break;
+        p = field_end + 1;
+    }
+
+    return count;
+}
+
+} // namespace
+
+bool CsvIO::read_matrix_stripe(const std::string& filename, Matrix& stripe,
+                               int& row_offset, int& total_rows, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    FileView file(filename);
+    int local_ok = file.ok() ? 1 : 0;
+    int all_ok = 0;
+    MPI_Allreduce(&local_ok, &all_ok, 1, MPI_INT, MPI_MIN, comm);
+    if (!all_ok) {
+        if (!local_ok) {
+            std::cerr << "Error: Rank " << rank << " could not open file '" << filename << "'\n";
+        }
+        return false;
+    }
+
+    // Equal byte ranges; a row belongs to the rank whose range holds its first byte
+    const char* data = file.data();
+    size_t file_size = file.size();
+    size_t begin = file_size * rank / size;
+    size_t end = file_size * (rank + 1) / size;
+
+    if (rank > 0) {
+        while (begin < file_size && begin > 0 && data[begin - 1] != '\n') ++begin;
+    }
+    while (end < file_size && end > 0 && data[end - 1] != '\n') ++end;
+    if (end < begin) end = begin;
+
+    std::vector<double> values;
+    values.reserve((end - begin) / 4);
+    int local_rows = 0;
+    int cols = -1;
+    bool parse_ok = true;
+
+    size_t pos = begin;
+    while (pos < end && parse_ok) {
+        const char* line = data + pos;
+        const char* line_end = static_cast<const char*>(memchr(line, '\n', end - pos));
+        if (line_end == nullptr) line_end = data + end;
+        pos = (line_end - data) + 1;
+
+        // Skip empty lines (including a lone '\r')
+        const char* content_end = line_end;
+        if (content_end > line && content_end[-1] == '\r') --content_end;
+        if (content_end == line) continue;
+
+        int row_cols = parse_csv_line(line, content_end, values);
+        if (row_cols < 0) {
+            parse_ok = false;
+        } else if (cols >= 0 && row_cols != cols) {
+            std::cerr << "Error: CSV rows have inconsistent column counts\n";
+            parse_ok = false;
+        } else {
+            cols = row_cols;
+            ++local_rows;
+        }
+    }
+
+    // Agree on success and column count across ranks (empty ranks don't vote)
+    int stats_local[3] = {parse_ok ? 0 : 1,
+                          local_rows > 0 ? cols : INT_MIN,
+                          local_rows > 0 ? -cols : INT_MIN};
+    int stats[3];
+    MPI_Allreduce(stats_local, stats, 3, MPI_INT, MPI_MAX, comm);
+    int max_cols = stats[1];
+    int min_cols = -stats[2];
+
+    if (stats[0] != 0) {
+        return false;
+    }
+    if (max_cols == INT_MIN) {
+        if (rank == 0) std::cerr << "Error: CSV file is empty\n";
+        return false;
+    }
+    if (min_cols != max_cols) {
+        if (rank == 0) std::cerr << "Error: CSV rows have inconsistent column counts\n";
+        return false;
+    }
+
+    // Global row offset from an exclusive prefix sum of row counts
+    row_offset = 0;
+    MPI_Exscan(&local_rows, &row_offset, 1, MPI_INT, MPI_SUM, comm);
+    if (rank == 0) row_offset = 0;  // MPI_Exscan leaves rank 0's result undefined
+    MPI_Allreduce(&local_rows, &total_rows, 1, MPI_INT, MPI_SUM, comm);
+
+    stripe.resize(local_rows, max_cols);
+    std::copy(values.begin(), values.end(), stripe.data());
+
+    return true;
+}
+
 bool CsvIO::write_matrix(const std::string& filename, const Matrix& matrix) {
     std::ofstream file(filename);
     if (!file.is_open()) {
@@ -0,0 +1,275 @@
+#include "gemv_batch.hpp"
+#include "algorithms.hpp"
+#include "timer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace matmul {
+namespace gemv {
+
+GemvQueue::GemvQueue(const Matrix& A, const Config& config, int max_batch, double deadline_seconds)
+    : A_(A), config_(config), max_batch_(static_cast<size_t>(std::max(max_batch, 1))),
+      deadline_(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(std::max(deadline_seconds, 0.0)))) {
+    if (config_.mode == ExecutionMode::MPI) config_.mode = ExecutionMode::SEQUENTIAL;
+    if (config_.mode == ExecutionMode::HYBRID) config_.mode = ExecutionMode::OPENMP;
+    if (config_.algorithm == Algorithm::STRASSEN) config_.algorithm = Algorithm::NAIVE;
+    worker_ = std::thread(&GemvQueue::worker, this);
+}
+
+GemvQueue::~GemvQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_one();
+    worker_.join();
+}
+
+void GemvQueue::submit(std::vector<double> x, Callback done) {
+    if (static_cast<int>(x.size()) != A_.cols()) {
+        throw std::runtime_error("GEMV vector length does not match the matrix");
+    }
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back({std::move(x), std::move(done), Clock::now()});
+        // The worker sleeps until the deadline of the oldest vector, so only
+        // the first vector (which sets that deadline) or a full batch wakes it
+        wake = pending_.size() == 1 || pending_.size() >= max_batch_;
+    }
+    if (wake) {
+        ready_.notify_one();
+    }
+}
+
+std::future<std::vector<double>> GemvQueue::submit(std::vector<double> x) {
+    auto promise = std::make_shared<std::promise<std::vector<double>>>();
+    std::future<std::vector<double>> result = promise->get_future();
+    submit(std::move(x), [promise](std::vector<double>&& y) { promise->set_value(std::move(y)); });
+    return result;
+}
+
+void GemvQueue::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_.notify_one();
+    idle_.wait(lock, [this] { return pending_.empty() && !busy_; });
+}
+
+GemvQueue::Stats GemvQueue::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void GemvQueue::worker() {
+    std::vector<Pending> batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        ready_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+        if (pending_.empty()) break;  // Stopping with nothing left
+
+        // Hold the batch open until it fills or the oldest vector is due
+        Clock::time_point due = pending_.front().arrival + deadline_;
+        ready_.wait_until(lock, due, [this] {
+            return stopping_ || pending_.size() >= max_batch_;
+        });
+
+        size_t count = std::min(pending_.size(), max_batch_);
+        batch.clear();
+        for (size_t i = 0; i < count; ++i) {
+            batch.push_back(std::move(pending_.front()));
+            pending_.pop_front();
+        }
+
+        busy_ = true;
+        lock.unlock();
+        Timer timer;
+        timer.start();
+        run_batch(batch);
+        timer.stop();
+        lock.lock();
+
+        stats_.vectors += count;
+        stats_.batches++;
+        stats_.gemm_seconds += timer.elapsed_seconds();
+        busy_ = false;
+        if (pending_.empty()) idle_.notify_all();
+    }
+}
+
+void GemvQueue::run_batch(std::vector<Pending>& batch) {
+    int k = A_.cols();
+    int m = A_.rows();
+    int b = static_cast<int>(batch.size());
+
+    // Gather: vector j becomes column j of X
+    Matrix X = Matrix::uninitialized(k, b);
+    for (int j = 0; j < b; ++j) {
+        const std::vector<double>& x = batch[j].x;
+        for (int i = 0; i < k; ++i) {
+            X(i, j) = x[i];
+        }
+    }
+
+    Matrix Y = multiply(A_, X, config_);
+
+    // Scatter: column j of Y back to its caller
+    for (int j = 0; j < b; ++j) {
+        std::vector<double> y(m);
+        for (int i = 0; i < m; ++i) {
+            y[i] = Y(i, j);
+        }
+        batch[j].done(std::move(y));
+    }
+}
+
+namespace {
+
+struct Trial {
+    double throughput;   // Vectors per second, first arrival to last completion
+    double mean_batch;
+    double p50_ms;
+    double p99_ms;
+};
+
+double percentile(std::vector<double> values, double p) {
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[index];
+}
+
+// Offer vectors at a fixed rate and time each from arrival to its result
+Trial run_trial(const Matrix& A, const Config& config, const std::vector<std::vector<double>>& xs,
+                int max_batch, double deadline, double rate) {
+    using Clock = std::chrono::steady_clock;
+    size_t count = xs.size();
+    std::vector<Clock::time_point> arrival(count);
+    std::vector<Clock::time_point> completion(count);
+    GemvQueue::Stats stats;
+
+    {
+        GemvQueue queue(A, config, max_batch, deadline);
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            Clock::time_point when = start + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(i / rate));
+            std::this_thread::sleep_until(when);
+            arrival[i] = Clock::now();
+            Clock::time_point* done_at = &completion[i];
+            queue.submit(xs[i], [done_at](std::vector<double>&&) { *done_at = Clock::now(); });
+        }
+        queue.flush();
+        stats = queue.stats();
+    }
+
+    std::vector<double> latency(count);
+    Clock::time_point last = completion[0];
+    for (size_t i = 0; i < count; ++i) {
+        latency[i] = std::chrono::duration<double, std::milli>(completion[i] - arrival[i]).count();
+        last = std::max(last, completion[i]);
+    }
+
+    Trial trial;
+    trial.throughput = count / std::chrono::duration<double>(last - arrival[0]).count();
+    trial.mean_batch = static_cast<double>(stats.vectors) / stats.batches;
+    trial.p50_ms = percentile(latency, 0.50);
+    trial.p99_ms = percentile(latency, 0.99);
+    return trial;
+}
+
+} // namespace
+
+void run_benchmark(const Config& config) {
+    int n = config.matrix_size;
+    int max_batch = config.gemv_batch;
+
+    Matrix A(n, n);
+    A.randomize();
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    auto random_vector = [&]() {
+        std::vector<double> x(n);
+        for (double& v : x) v = dist(gen);
+        return x;
+    };
+
+    // Capacity with and without batching: one vector, then a full batch
+    double single_seconds, batch_seconds;
+    double max_error = 0.0;
+    {
+        std::vector<std::vector<double>> xs(max_batch);
+        for (auto& x : xs) x = random_vector();
+
+        GemvQueue unbatched(A, config, 1, 0.0);
+        unbatched.submit(xs[0]).get();  // Warm up
+        Timer timer;
+        timer.start();
+        std::vector<double> y0 = unbatched.submit(xs[0]).get();
+        timer.stop();
+        single_seconds = timer.elapsed_seconds();
+
+        GemvQueue batched(A, config, max_batch, 1.0);
+        std::vector<std::future<std::vector<double>>> results;
+        timer.start();
+        for (auto& x : xs) results.push_back(batched.submit(x));
+        for (auto& r : results) r.wait();
+        timer.stop();
+        batch_seconds = timer.elapsed_seconds() / max_batch;
+
+        std::vector<double> y = results[0].get();
+        for (int i = 0; i < n; ++i) {
+            max_error = std::max(max_error, std::fabs(y[i] - y0[i]));
+        }
+    }
+
+    // Default offered load: geometric mean of the two capacities, i.e. more
+    // than one-at-a-time can sustain but well within batched capacity
+    double rate = config.gemv_rate > 0.0 ? config.gemv_rate
+                                         : std::sqrt(1.0 / single_seconds * 1.0 / batch_seconds);
+    size_t count = static_cast<size_t>(std::min(std::max(rate * 1.0, 100.0), 5000.0));
+
+    std::vector<std::vector<double>> xs(count);
+    for (auto& x : xs) x = random_vector();
+
+    std::cout << "\nGEMV batching, A " << n << "x" << n << ", " << algorithm_to_string(config.algorithm)
+              << " / " << mode_to_string(config.mode) << "\n";
+    std::cout << std::fixed << std::setprecision(1)
+              << "  One vector:       " << single_seconds * 1e6 << " us ("
+              << 1.0 / single_seconds << " vectors/s)\n"
+              << std::left << std::setw(20) << ("  Batch of " + std::to_string(max_batch) + ":")
+              << std::right << batch_seconds * 1e6 << " us per vector (" << 1.0 / batch_seconds << " vectors/s)\n"
+              << "  Offered load:     " << rate << " vectors/s, " << count << " vectors per row\n"
+              << std::scientific << std::setprecision(2)
+              << "  Batched vs single max |diff|: " << max_error << "\n\n";
+
+    std::cout << std::left << std::setw(14) << "Deadline" << std::right
+              << std::setw(12) << "Mean batch" << std::setw(16) << "Vectors/s"
+              << std::setw(14) << "p50 (ms)" << std::setw(14) << "p99 (ms)" << "\n";
+    std::cout << std::string(70, '-') << "\n";
+
+    auto print_row = [](const std::string& label, const Trial& t) {
+        std::cout << std::left << std::setw(14) << label << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(12) << t.mean_batch
+                  << std::setw(16) << t.throughput << std::setprecision(3)
+                  << std::setw(14) << t.p50_ms << std::setw(14) << t.p99_ms << "\n";
+    };
+
+    print_row("unbatched", run_trial(A, config, xs, 1, 0.0, rate));
+    const double deadlines_ms[] = {0.0, 0.1, 0.25, 0.5, 1.0, 2.0, 5.0, 10.0};
+    for (double deadline_ms : deadlines_ms) {
+        std::ostringstream label;
+        label << std::fixed << std::setprecision(2) << deadline_ms << " ms";
+        print_row(label.str(), run_trial(A, config, xs, max_batch, deadline_ms * 1e-3, rate));
+    }
+    std::cout << "\nLatency runs from submit to result. A deadline of 0 still batches\n"
+              << "whatever queued up while the previous batch ran.\n";
+}
+
+} // namespace gemv
+} // namespace matmul
@@ -0,0 +1,126 @@
+#include "lu.hpp"
+#include "algorithms.hpp"
+#include "comm.hpp"
+#include "timer.hpp"
+#include <mpi.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace matmul {
+namespace lu {
+
+namespace {
+
+double norm_inf(const Matrix& M) {
+    double result = 0.0;
+    for (int i = 0; i < M.rows(); ++i) {
+        double sum = 0.0;
+        for (int j = 0; j < M.cols(); ++j) sum += std::fabs(M(i, j));
+        result = std::max(result, sum);
+    }
+    return result;
+}
+
+double norm_frobenius(const Matrix& M) {
+    double sum = 0.0;
+    for (int i = 0; i < M.rows(); ++i) {
+        for (int j = 0; j < M.cols(); ++j) sum += M(i, j) * M(i, j);
+    }
+    return std::sqrt(sum);
+}
+
+// ||P A - L U||_F, with the product through OpenBLAS as the reference
+double factor_residual(const Matrix& A, const Factorization& f) {
+    int N = A.rows();
+    Matrix L(N, N), U(N, N);
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            if (j < i) L(i, j) = f.lu(i, j);
+            else U(i, j) = f.lu(i, j);
+        }
+        L(i, i) = 1.0;
+    }
+    Matrix R = openblas::multiply(L, U);
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) R(i, j) -= A(f.pivots[i], j);
+    }
+    return norm_frobenius(R);
+}
+
+} // namespace
+
+void run(const Config& config, int rank) {
+    bool distributed = config.mode == ExecutionMode::MPI || config.mode == ExecutionMode::HYBRID;
+    if (!distributed && rank != 0) return;
+
+    int N = config.matrix_size;
+    int nrhs = config.lu_rhs;
+    Matrix A(N, N), B(N, nrhs);
+    if (rank == 0) {
+        A.randomize(-1.0, 1.0);
+        B.randomize(-1.0, 1.0);
+    }
+    if (distributed) {
+        // Every rank runs the same recursion; only the updates are distributed
+        comm::bcast(A.data(), static_cast<size_t>(N) * N, 0, MPI_COMM_WORLD, config.distributed);
+        comm::bcast(B.data(), static_cast<size_t>(N) * nrhs, 0, MPI_COMM_WORLD, config.distributed);
+    }
+
+    Stats factor_stats, solve_stats;
+    Timer timer;
+    timer.start();
+    Factorization f = factor(A, config, 32, &factor_stats);
+    timer.stop();
+    double factor_seconds = timer.elapsed_seconds();
+
+    timer.start();
+    Matrix X = solve(f, B, config, &solve_stats);
+    timer.stop();
+    double solve_seconds = timer.elapsed_seconds();
+
+    if (rank != 0) return;
+
+    double factor_flops = 2.0 / 3.0 * N * static_cast<double>(N) * N;
+    double solve_flops = 2.0 * N * static_cast<double>(N) * nrhs;
+
+    // Residuals: R = A X - B, and the HPL scaling of its norm
+    Matrix R = openblas::multiply(A, X);
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < nrhs; ++j) R(i, j) -= B(i, j);
+    }
+    double eps = std::numeric_limits<double>::epsilon();
+    double r_norm = norm_inf(R);
+    double scaled = r_norm / (eps * (norm_inf(A) * norm_inf(X) + norm_inf(B)) * N);
+    double lu_error = factor_residual(A, f) / norm_frobenius(A);
+
+    std::cout << "\nLU factorization, " << N << "x" << N << ", " << nrhs << " right-hand side(s), "
+              << algorithm_to_string(config.algorithm) << " / " << mode_to_string(config.mode) << "\n";
+    std::cout << "========================================\n";
+    std::cout << std::fixed << std::setprecision(6)
+              << std::left << std::setw(17) << "Factor:" << factor_seconds << " s ("
+              << std::setprecision(2) << factor_flops / factor_seconds / 1e9 << " GFLOP/s)\n"
+              << std::setprecision(6)
+              << std::setw(17) << "  GEMM updates:" << factor_stats.gemm_seconds << " s, "
+              << factor_stats.gemm_calls << " calls, " << std::setprecision(2)
+              << 100.0 * factor_stats.gemm_flops / factor_flops << "% of the flops, "
+              << (factor_stats.gemm_seconds > 0.0 ? factor_stats.gemm_flops / factor_stats.gemm_seconds / 1e9 : 0.0)
+              << " GFLOP/s\n"
+              << std::setprecision(6)
+              << std::setw(17) << "Solve:" << solve_seconds << " s (" << std::setprecision(2)
+              << solve_flops / solve_seconds / 1e9 << " GFLOP/s)\n";
+    std::cout << "========================================\n";
+    std::cout << std::scientific << std::setprecision(3)
+              << std::setw(17) << "||AX - B||_inf:" << r_norm << "\n"
+              << std::setw(17) << "||PA - LU||_F:" << lu_error << " (relative to ||A||_F)\n"
+              << std::setw(17) << "Scaled residual:" << scaled
+              << "  (||AX - B|| / (eps (||A|| ||X|| + ||B||) N), "
+              << (scaled < 16.0 ? "PASSED" : "FAILED") << " below 16)\n"
+              << std::fixed << std::right;
+    std::cout << "========================================\n";
+}
+
+} // namespace lu
+} // namespace matmul
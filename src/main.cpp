@@ -5,8 +5,25 @@
 #include "timer.hpp"
 #include "config.hpp"
 #include "verification.hpp"
+#include "binary_io.hpp"
+#include "buffer_pool.hpp"
+#include "comm.hpp"
+#include "mpi_bench.hpp"
+#include "simulator.hpp"
+#include "gemv_batch.hpp"
+#include "sparse.hpp"
+#include "bilinear.hpp"
+#include "winograd.hpp"
+#include "tensor.hpp"
+#include "lu.hpp"
+#include "stream_io.hpp"
+#include "async_io.hpp"
+#include "blas_backend.hpp"
+#include "partition.hpp"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <mpi.h>
 #include <cstring>
 
@@ -31,9 +48,9 @@ Matrix matmul::multiply(const Matrix& A, const Matrix& B, const Config& config)
                 case ExecutionMode::OPENMP:
                     return naive::openmp(A, B, config.optimization, config.num_threads);
                 case ExecutionMode::MPI:
-                    return naive::mpi(A, B, config.optimization);
+                    return naive::mpi(A, B, config.optimization, config.distributed);
                 case ExecutionMode::HYBRID:
-                    return naive::hybrid(A, B, config.optimization, config.num_threads);
+                    return naive::hybrid(A, B, config.optimization, config.num_threads, config.distributed);
             }
             break;
 
@@ -44,19 +61,58 @@ Matrix matmul::multiply(const Matrix& A, const Matrix& B, const Config& config)
                 case ExecutionMode::OPENMP:
                     return strassen::openmp(A, B, config.optimization, config.num_threads);
                 case ExecutionMode::MPI:
-                    return strassen::mpi(A, B, config.optimization);
+                    return strassen::mpi(A, B, config.optimization, config.distributed);
                 case ExecutionMode::HYBRID:
-                    return strassen::hybrid(A, B, config.optimization, config.num_threads);
+                    return strassen::hybrid(A, B, config.optimization, config.num_threads, config.distributed);
             }
             break;
 
         case Algorithm::OPENBLAS:
             return openblas::multiply(A, B);
+
+        // Shared-memory only: under MPI/Hybrid every rank computes the whole
+        // product, as with OpenBLAS
+        case Algorithm::WINOGRAD:
+            switch (config.mode) {
+                case ExecutionMode::SEQUENTIAL:
+                case ExecutionMode::MPI:
+                    return winograd::sequential(A, B);
+                case ExecutionMode::OPENMP:
+                case ExecutionMode::HYBRID:
+                    return winograd::openmp(A, B, config.num_threads);
+            }
+            break;
     }
 
     throw std::runtime_error("Invalid algorithm/mode combination");
 }
 
+void matmul::multiply_into(const Matrix& A, const Matrix& B, const Config& config, Matrix& C) {
+    if (C.rows() != partition::global_rows(A, config.distributed) || C.cols() != B.cols()) {
+        throw std::runtime_error("Output matrix has the wrong dimensions");
+    }
+
+    if (config.algorithm == Algorithm::OPENBLAS) {
+        openblas::gemm(A.rows(), A.cols(), B.cols(), A.data(), A.cols(), B.data(), B.cols(),
+                       C.data(), C.cols());
+        return;
+    }
+
+    bool naive_rows = config.algorithm == Algorithm::NAIVE &&
+                      (config.mode == ExecutionMode::SEQUENTIAL || config.mode == ExecutionMode::OPENMP);
+    if (!naive_rows) {
+        Matrix result = multiply(A, B, config);
+        std::copy(result.data(), result.data() + static_cast<size_t>(C.rows()) * C.cols(), C.data());
+        return;
+    }
+
+    if (config.mode == ExecutionMode::SEQUENTIAL) {
+        naive::sequential_rows(A, B, config.optimization, C, 0, A.rows());
+    } else {
+        naive::openmp_rows(A, B, config.optimization, C, 0, A.rows(), config.num_threads);
+    }
+}
+
 // Parse command-line arguments into Config
 // Returns true if arguments were parsed successfully, false if help was shown or error occurred
 bool parse_arguments(int argc, char** argv, Config& config) {
@@ -124,6 +180,31 @@ bool parse_arguments(int argc, char** argv, Config& config) {
                 throw std::runtime_error("--block-size requires an argument");
             }
         }
+        // Packed kernel and its write-back/prefetch variants
+        else if (arg == "--packed") {
+            config.optimization.packed = true;
+        }
+        else if (arg == "--nt-stores") {
+            config.optimization.packed = true;
+            config.optimization.streaming_stores = true;
+        }
+        else if (arg == "--prefetch") {
+            if (i + 1 < argc) {
+                config.optimization.prefetch_distance = std::stoi(argv[++i]);
+                if (config.optimization.prefetch_distance < 0) {
+                    throw std::runtime_error("Prefetch distance must not be negative");
+                }
+                config.optimization.packed = true;
+            } else {
+                throw std::runtime_error("--prefetch requires an argument");
+            }
+        }
+        else if (arg == "--writeback-bench") {
+            config.writeback_bench = true;
+        }
+        else if (arg == "--blas-bench") {
+            config.blas_bench = true;
+        }
         // Input file
         else if (arg == "-i" || arg == "--input") {
             if (i + 1 < argc) {
@@ -133,15 +214,302 @@ bool parse_arguments(int argc, char** argv, Config& config) {
                 throw std::runtime_error("--input requires an argument");
             }
         }
+        // Memory-mapped binary output
+        else if (arg == "--binary-output") {
+            if (i + 1 < argc) {
+                config.binary_output_file = argv[++i];
+            } else {
+                throw std::runtime_error("--binary-output requires an argument");
+            }
+        }
+        // Parallel CSV ingestion across MPI ranks
+        else if (arg == "--parallel-read") {
+            config.parallel_read = true;
+        }
+        // Checkpoint/restart
+        else if (arg == "--checkpoint") {
+            if (i + 1 < argc) {
+                config.distributed.checkpoint_dir = argv[++i];
+            } else {
+                throw std::runtime_error("--checkpoint requires an argument");
+            }
+        }
+        else if (arg == "--checkpoint-interval") {
+            if (i + 1 < argc) {
+                config.distributed.checkpoint_interval = std::atof(argv[++i]);
+                if (config.distributed.checkpoint_interval <= 0.0) {
+                    throw std::runtime_error("Checkpoint interval must be positive");
+                }
+            } else {
+                throw std::runtime_error("--checkpoint-interval requires an argument");
+            }
+        }
+        else if (arg == "--resume") {
+            config.distributed.resume = true;
+        }
+        // Heterogeneity-aware row partitioning
+        else if (arg == "--balance") {
+            if (i + 1 < argc) {
+                config.distributed.balance = parse_balance(argv[++i]);
+            } else {
+                throw std::runtime_error("--balance requires an argument");
+            }
+        }
+        else if (arg == "--balance-file") {
+            if (i + 1 < argc) {
+                config.distributed.balance_file = argv[++i];
+            } else {
+                throw std::runtime_error("--balance-file requires an argument");
+            }
+        }
+        // Lossless compression of large MPI payloads
+        else if (arg == "--compress") {
+            if (i + 1 < argc) {
+                config.distributed.compression = parse_compression(argv[++i]);
+            } else {
+                throw std::runtime_error("--compress requires an argument");
+            }
+        }
+        else if (arg == "--comm-thread") {
+            config.distributed.comm_thread = true;
+        }
+        else if (arg == "--comm-precision") {
+            if (i + 1 < argc) {
+                config.distributed.precision = parse_precision(argv[++i]);
+            } else {
+                throw std::runtime_error("--comm-precision requires an argument");
+            }
+        }
         // Validation
         else if (arg == "--validate") {
             config.validate_against_openblas = true;
         }
+        else if (arg == "--dist-validate") {
+            if (i + 1 < argc) {
+                config.dist_validation = parse_dist_validation(argv[++i]);
+            } else {
+                throw std::runtime_error("--dist-validate requires an argument");
+            }
+        }
+        // BLAS library and its threads
+        else if (arg == "--blas") {
+            if (i + 1 < argc) {
+                config.blas_backend = parse_blas_backend(argv[++i]);
+            } else {
+                throw std::runtime_error("--blas requires an argument");
+            }
+        }
+        else if (arg == "--blas-lib") {
+            if (i + 1 < argc) {
+                config.blas_library = argv[++i];
+            } else {
+                throw std::runtime_error("--blas-lib requires an argument");
+            }
+        }
+        else if (arg == "--blas-threads") {
+            if (i + 1 < argc) {
+                config.blas_threads = std::stoi(argv[++i]);
+                if (config.blas_threads < 1) {
+                    throw std::runtime_error("BLAS threads must be positive");
+                }
+            } else {
+                throw std::runtime_error("--blas-threads requires an argument");
+            }
+        }
+        // Cap on idle Matrix buffers kept by the pool
+        else if (arg == "--pool-limit") {
+            if (i + 1 < argc) {
+                config.pool_limit_mb = std::atoi(argv[++i]);
+                if (config.pool_limit_mb < 0) {
+                    throw std::runtime_error("Pool limit must be non-negative");
+                }
+            } else {
+                throw std::runtime_error("--pool-limit requires an argument");
+            }
+        }
+        // MPI transfer micro-benchmark
+        else if (arg == "--transfer-bench") {
+            config.transfer_bench = true;
+        }
+        else if (arg == "--commbench") {
+            config.commbench = true;
+        }
+        else if (arg == "--simulate") {
+            config.simulate = true;
+        }
+        else if (arg == "--gemv-bench") {
+            config.gemv_bench = true;
+        }
+        else if (arg == "--gemv-batch") {
+            if (i + 1 < argc) {
+                config.gemv_batch = std::stoi(argv[++i]);
+                if (config.gemv_batch < 1) {
+                    throw std::runtime_error("GEMV batch size must be positive");
+                }
+            } else {
+                throw std::runtime_error("--gemv-batch requires an argument");
+            }
+        }
+        else if (arg == "--gemv-rate") {
+            if (i + 1 < argc) {
+                config.gemv_rate = std::stod(argv[++i]);
+                if (config.gemv_rate < 0.0) {
+                    throw std::runtime_error("GEMV rate must be non-negative");
+                }
+            } else {
+                throw std::runtime_error("--gemv-rate requires an argument");
+            }
+        }
+        else if (arg == "--spgemm") {
+            config.spgemm = true;
+        }
+        else if (arg == "--sparse-a" || arg == "--sparse-b" || arg == "--sparse-output") {
+            if (i + 1 < argc) {
+                std::string& target = arg == "--sparse-a" ? config.sparse_a_file
+                                    : arg == "--sparse-b" ? config.sparse_b_file
+                                                          : config.sparse_output_file;
+                target = argv[++i];
+            } else {
+                throw std::runtime_error(arg + " requires an argument");
+            }
+        }
+        else if (arg == "--bilinear-bench") {
+            config.bilinear_bench = true;
+        }
+        else if (arg == "--winograd-bench") {
+            config.winograd_bench = true;
+        }
+        else if (arg == "--einsum") {
+            if (i + 1 < argc) {
+                config.einsum = argv[++i];
+            } else {
+                throw std::runtime_error("--einsum requires an argument");
+            }
+        }
+        else if (arg == "--tensor-a" || arg == "--tensor-b" || arg == "--tensor-output") {
+            if (i + 1 < argc) {
+                std::string& target = arg == "--tensor-a" ? config.tensor_a_file
+                                    : arg == "--tensor-b" ? config.tensor_b_file
+                                                          : config.tensor_output_file;
+                target = argv[++i];
+            } else {
+                throw std::runtime_error(arg + " requires an argument");
+            }
+        }
+        else if (arg == "--lu") {
+            config.lu = true;
+        }
+        else if (arg == "--stream") {
+            if (i + 1 < argc) {
+                config.stream_b_file = argv[++i];
+            } else {
+                throw std::runtime_error("--stream requires an argument");
+            }
+        }
+        else if (arg == "--stream-block") {
+            if (i + 1 < argc) {
+                config.stream_block = std::stoi(argv[++i]);
+                if (config.stream_block < 1) {
+                    throw std::runtime_error("Stream block must be positive");
+                }
+            } else {
+                throw std::runtime_error("--stream-block requires an argument");
+            }
+        }
+        else if (arg == "--io-bench") {
+            config.io_bench = true;
+        }
+        else if (arg == "--io-file") {
+            if (i + 1 < argc) {
+                config.io_file = argv[++i];
+            } else {
+                throw std::runtime_error("--io-file requires an argument");
+            }
+        }
+        else if (arg == "--io-depth") {
+            if (i + 1 < argc) {
+                config.io_depth = std::stoi(argv[++i]);
+                if (config.io_depth < 1) {
+                    throw std::runtime_error("I/O depth must be positive");
+                }
+            } else {
+                throw std::runtime_error("--io-depth requires an argument");
+            }
+        }
+        else if (arg == "--lu-rhs") {
+            if (i + 1 < argc) {
+                config.lu_rhs = std::stoi(argv[++i]);
+                if (config.lu_rhs < 1) {
+                    throw std::runtime_error("Right-hand sides must be positive");
+                }
+            } else {
+                throw std::runtime_error("--lu-rhs requires an argument");
+            }
+        }
+        else if (arg == "--tensor-extent") {
+            if (i + 1 < argc) {
+                config.tensor_extent = std::stoi(argv[++i]);
+                if (config.tensor_extent < 1) {
+                    throw std::runtime_error("Tensor extent must be positive");
+                }
+            } else {
+                throw std::runtime_error("--tensor-extent requires an argument");
+            }
+        }
+        else if (arg == "--bsr") {
+            config.bsr = true;
+        }
+        else if (arg == "--bsr-block") {
+            if (i + 1 < argc) {
+                config.bsr_block = std::stoi(argv[++i]);
+                if (config.bsr_block < 1) {
+                    throw std::runtime_error("BSR block size must be positive");
+                }
+            } else {
+                throw std::runtime_error("--bsr-block requires an argument");
+            }
+        }
+        else if (arg == "--bsr-fill" || arg == "--bsr-threshold") {
+            if (i + 1 < argc) {
+                double value = std::stod(argv[++i]);
+                if (value < 0.0 || value > 1.0) {
+                    throw std::runtime_error(arg + " must be between 0 and 1");
+                }
+                (arg == "--bsr-fill" ? config.bsr_fill : config.bsr_threshold) = value;
+            } else {
+                throw std::runtime_error(arg + " requires an argument");
+            }
+        }
+        else if (arg == "--nnz-per-row") {
+            if (i + 1 < argc) {
+                config.nnz_per_row = std::stoi(argv[++i]);
+                if (config.nnz_per_row < 1) {
+                    throw std::runtime_error("Nonzeros per row must be positive");
+                }
+            } else {
+                throw std::runtime_error("--nnz-per-row requires an argument");
+            }
+        }
+        else if (arg == "--sim-params") {
+            if (i + 1 < argc) {
+                config.sim_params_file = argv[++i];
+            } else {
+                throw std::runtime_error("--sim-params requires an argument");
+            }
+        }
+        else if (arg == "--comm-model") {
+            if (i + 1 < argc) {
+                config.comm_model_file = argv[++i];
+            } else {
+                throw std::runtime_error("--comm-model requires an argument");
+            }
+        }
         // Verification mode
         else if (arg == "--verify") {
             config.verification_mode = true;
             // Default: verify all algorithms
-            config.verify_algorithms = {Algorithm::NAIVE, Algorithm::STRASSEN, Algorithm::OPENBLAS};
+            config.verify_algorithms = {Algorithm::NAIVE, Algorithm::STRASSEN, Algorithm::OPENBLAS,
+                                        Algorithm::WINOGRAD};
         }
         // Unknown argument
         else {
@@ -149,6 +517,10 @@ bool parse_arguments(int argc, char** argv, Config& config) {
         }
     }
 
+    if (config.distributed.balance == LoadBalance::HISTORY && config.distributed.balance_file.empty()) {
+        throw std::runtime_error("--balance history requires --balance-file");
+    }
+
     // Set defaults for OpenMP/Hybrid modes if not specified
     if ((config.mode == ExecutionMode::OPENMP || config.mode == ExecutionMode::HYBRID) &&
         config.num_threads == 1) {
@@ -158,6 +530,16 @@ bool parse_arguments(int argc, char** argv, Config& config) {
     return true;
 }
 
+// Broadcast a string from rank 0 to all processes
+void broadcast_string(std::string& str) {
+    int len = str.length();
+    MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    str.resize(len);
+    if (len > 0) {
+        MPI_Bcast(&str[0], len, MPI_CHAR, 0, MPI_COMM_WORLD);
+    }
+}
+
 void print_results(const Config& config, int rank) {
     if (rank != 0) return;  // Only rank 0 prints
 
@@ -174,13 +556,27 @@ void print_results(const Config& config, int rank) {
 
     std::cout << "Matrix Size:     " << config.matrix_size << "x" << config.matrix_size << "\n";
 
-    if (config.optimization.cache_friendly) {
+    if (config.optimization.packed) {
+        std::cout << "Optimization:    Packed kernel";
+        if (config.optimization.streaming_stores) std::cout << ", NT stores";
+        if (config.optimization.prefetch_distance > 0) {
+            std::cout << ", prefetch " << config.optimization.prefetch_distance;
+        }
+        std::cout << "\n";
+    } else if (config.optimization.cache_friendly) {
         std::cout << "Optimization:    Cache-friendly (block size: "
                   << config.optimization.block_size << ")\n";
     } else {
         std::cout << "Optimization:    None\n";
     }
 
+    if (config.algorithm == Algorithm::OPENBLAS || config.blas_backend != BlasBackend::LINKED) {
+        const blas::BackendInfo& blas_info = blas::active();
+        std::cout << "BLAS:            " << blas_info.vendor;
+        if (!blas_info.version.empty()) std::cout << " " << blas_info.version;
+        std::cout << " (" << blas_info.library << "), " << blas_info.threads << " thread(s)\n";
+    }
+
     if (!config.input_file.empty()) {
         std::cout << "Input File:      " << config.input_file << "\n";
         std::cout << "Output File:     " << config.output_file << "\n";
@@ -188,16 +584,30 @@ void print_results(const Config& config, int rank) {
         std::cout << "Input:           Random matrices\n";
     }
 
+    if (!config.binary_output_file.empty()) {
+        std::cout << "Binary Output:   " << config.binary_output_file << " (memory-mapped)\n";
+    }
+
     std::cout << "========================================\n";
     std::cout << "Execution Time:  " << std::fixed << std::setprecision(6)
               << config.execution_time << " seconds\n";
     std::cout << "========================================\n";
+
+    if (!config.report.entries.empty()) {
+        for (const auto& entry : config.report.entries) {
+            std::cout << std::left << std::setw(17) << (entry.first + ":")
+                      << std::right << entry.second << "\n";
+        }
+        std::cout << "========================================\n";
+    }
     std::cout << "\n";
 }
 
 int main(int argc, char** argv) {
-    // Initialize MPI
-    MPI_Init(&argc, &argv);
+    // Initialize MPI; the hybrid communication thread needs FUNNELED
+    // (only the master thread of an OpenMP team calls MPI)
+    int thread_support = MPI_THREAD_SINGLE;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &thread_support);
 
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -207,6 +617,10 @@ int main(int argc, char** argv) {
 
     try {
         bool use_interactive = false;
+        // Set by rank 0 when the run ends before any work (help, bad
+        // arguments, cancelled menu); every rank then leaves through
+        // MPI_Finalize so buffered output is flushed
+        int exit_status = -1;
 
         // Determine if we should use interactive mode or argument parsing
         if (argc > 1) {
@@ -214,8 +628,7 @@ int main(int argc, char** argv) {
             if (rank == 0) {
                 if (!parse_arguments(argc, argv, config)) {
                     // Help was shown or parsing failed
-                    MPI_Abort(MPI_COMM_WORLD, 0);
-                    return 0;
+                    exit_status = 0;
                 }
             }
         } else {
@@ -228,74 +641,188 @@ int main(int argc, char** argv) {
                     std::cerr << "Usage: " << argv[0] << " [OPTIONS]\n";
                     std::cerr << "Run '" << argv[0] << " --help' for more information.\n\n";
                     std::cerr << "NOTE: When using MPI (mpirun), you must provide command-line arguments.\n";
-                    MPI_Abort(MPI_COMM_WORLD, 1);
-                    return 1;
-                }
-
-                // Run interactive CLI menu
-                CliMenu menu;
-                if (!menu.run(config)) {
-                    std::cout << "Operation cancelled.\n";
-                    MPI_Abort(MPI_COMM_WORLD, 0);
-                    return 0;
+                    exit_status = 1;
+                } else {
+                    // Run interactive CLI menu
+                    CliMenu menu;
+                    if (!menu.run(config)) {
+                        std::cout << "Operation cancelled.\n";
+                        exit_status = 0;
+                    }
                 }
             }
             use_interactive = true;
         }
 
+        MPI_Bcast(&exit_status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (exit_status >= 0) {
+            std::cout.flush();
+            MPI_Finalize();
+            return exit_status;
+        }
+
         // Broadcast configuration to all processes
         MPI_Bcast(&config.algorithm, sizeof(Algorithm), MPI_BYTE, 0, MPI_COMM_WORLD);
         MPI_Bcast(&config.mode, sizeof(ExecutionMode), MPI_BYTE, 0, MPI_COMM_WORLD);
         MPI_Bcast(&config.optimization, sizeof(OptimizationOptions), MPI_BYTE, 0, MPI_COMM_WORLD);
         MPI_Bcast(&config.num_threads, 1, MPI_INT, 0, MPI_COMM_WORLD);
         MPI_Bcast(&config.matrix_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
-
-        // Broadcast input_file length and content
-        int filename_len = config.input_file.length();
-        MPI_Bcast(&filename_len, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        if (filename_len > 0) {
-            if (rank != 0) {
-                config.input_file.resize(filename_len);
-            }
-            MPI_Bcast(&config.input_file[0], filename_len, MPI_CHAR, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.parallel_read, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+
+        // Broadcast file names
+        broadcast_string(config.input_file);
+        broadcast_string(config.output_file);
+
+        // Broadcast distributed engine options
+        broadcast_string(config.distributed.checkpoint_dir);
+        MPI_Bcast(&config.distributed.checkpoint_interval, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.distributed.resume, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.distributed.balance, sizeof(LoadBalance), MPI_BYTE, 0, MPI_COMM_WORLD);
+        broadcast_string(config.distributed.balance_file);
+        MPI_Bcast(&config.distributed.compression, sizeof(CompressionMode), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.distributed.precision, sizeof(CommPrecision), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.distributed.comm_thread, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        config.distributed.thread_support = thread_support;
+        config.distributed.report = &config.report;
+        MPI_Bcast(&config.transfer_bench, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.commbench, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        broadcast_string(config.comm_model_file);
+        MPI_Bcast(&config.simulate, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        broadcast_string(config.sim_params_file);
+        MPI_Bcast(&config.gemv_bench, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.spgemm, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.bsr, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.bilinear_bench, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.winograd_bench, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        broadcast_string(config.einsum);
+        MPI_Bcast(&config.lu, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.lu_rhs, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        broadcast_string(config.stream_b_file);
+        MPI_Bcast(&config.io_bench, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.writeback_bench, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.dist_validation, sizeof(DistValidation), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.blas_backend, sizeof(BlasBackend), MPI_BYTE, 0, MPI_COMM_WORLD);
+        broadcast_string(config.blas_library);
+        MPI_Bcast(&config.blas_threads, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.blas_bench, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&config.pool_limit_mb, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        pool::set_limit(static_cast<size_t>(config.pool_limit_mb) << 20);
+        comm::reset_stats();
+        if (!blas::configure(config)) {
+            MPI_Finalize();
+            return 1;
         }
 
-        // Broadcast output_file length and content
-        int output_filename_len = config.output_file.length();
-        MPI_Bcast(&output_filename_len, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        if (output_filename_len > 0) {
-            if (rank != 0) {
-                config.output_file.resize(output_filename_len);
-            }
-            MPI_Bcast(&config.output_file[0], output_filename_len, MPI_CHAR, 0, MPI_COMM_WORLD);
+        if (config.transfer_bench || config.commbench || config.simulate || config.gemv_bench ||
+            config.spgemm || config.bsr || config.bilinear_bench ||
+            config.winograd_bench || !config.einsum.empty() || config.lu ||
+            !config.stream_b_file.empty() || config.io_bench || config.writeback_bench ||
+            config.blas_bench) {
+            int status = 0;
+            if (config.transfer_bench) mpi_bench::run_transfer_overheads(config);
+            if (config.commbench) mpi_bench::run_commbench(config);
+            if (config.simulate) simulator::run(config);
+            if (config.gemv_bench && rank == 0) gemv::run_benchmark(config);
+            if (config.spgemm && rank == 0) sparse::run_spgemm(config);
+            if (config.bsr && rank == 0) sparse::run_bsr(config);
+            if (config.bilinear_bench && rank == 0) bilinear::run_benchmark(config);
+            if (config.winograd_bench && rank == 0) winograd::run_benchmark(config);
+            if (!config.einsum.empty() && rank == 0) tensor::run_einsum(config);
+            if (config.lu) lu::run(config, rank);
+            if (config.io_bench && rank == 0) async_io::run_benchmark(config);
+            if (config.writeback_bench && rank == 0) naive::run_writeback_benchmark(config);
+            if (config.blas_bench && rank == 0) blas::run_benchmark(config);
+            // stdin reaches rank 0 only under mpirun
+            if (!config.stream_b_file.empty() && rank == 0 && !stream::run(config)) status = 1;
+            MPI_Finalize();
+            return status;
         }
 
-        // Load or generate matrices (rank 0 does this, then broadcasts)
+        // Load or generate matrices
         Matrix A(config.matrix_size);
         Matrix B(config.matrix_size);
 
-        if (rank == 0) {
-            if (!config.input_file.empty()) {
-                std::cout << "Loading matrices from " << config.input_file << "...\n";
-                // For simplicity, assume input file contains both matrices
-                // In practice, you'd need two files or a specific format
-                if (!CsvIO::read_matrix(config.input_file, A)) {
-                    std::cerr << "Error: Failed to load matrix A\n";
-                    MPI_Abort(MPI_COMM_WORLD, 1);
-                    return 1;
-                }
-                // For now, use the same matrix as B or generate random B
-                B = A;
+        if (!config.input_file.empty() && config.parallel_read) {
+            // Every rank parses its own byte range of the file. The row-striped
+            // engines keep each stripe as that rank's rows of A, so only B (the
+            // same matrix in this input format) is all-gathered; other engines
+            // need all of A everywhere and get a copy of the gathered matrix
+            if (rank == 0) {
+                std::cout << "Loading matrices from " << config.input_file
+                          << " (parallel read, " << size << " ranks)...\n";
+            }
+
+            Matrix stripe;
+            int row_offset = 0;
+            int total_rows = 0;
+            if (!CsvIO::read_matrix_stripe(config.input_file, stripe, row_offset, total_rows)) {
+                if (rank == 0) std::cerr << "Error: Failed to load matrix A\n";
+                MPI_Abort(MPI_COMM_WORLD, 1);
+                return 1;
+            }
+
+            int cols = stripe.cols();
+            MPI_Allreduce(MPI_IN_PLACE, &cols, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+            std::vector<int> recvcounts(size);
+            std::vector<int> displs(size);
+            int local_count = stripe.rows() * cols;
+            int local_displ = row_offset * cols;
+            MPI_Allgather(&local_count, 1, MPI_INT, recvcounts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+            MPI_Allgather(&local_displ, 1, MPI_INT, displs.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+            // The input is gathered at full precision: with --comm-precision
+            // rank 0's copy would otherwise be rounded, unlike the broadcast path
+            DistributedOptions gather_options = config.distributed;
+            gather_options.precision = CommPrecision::FP64;
+            B.resize(total_rows, cols);
+            comm::allgatherv(stripe.data(), local_count, B.data(), recvcounts, displs,
+                             MPI_COMM_WORLD, gather_options);
+            config.matrix_size = total_rows;
+
+            bool striped = (config.mode == ExecutionMode::MPI || config.mode == ExecutionMode::HYBRID) &&
+                           (config.algorithm == Algorithm::NAIVE || config.algorithm == Algorithm::STRASSEN) &&
+                           !config.verification_mode;
+            if (striped) {
+                std::vector<int>& rows = config.distributed.a_stripe_rows;
+                rows.resize(size);
+                int local_rows = stripe.rows();
+                if (local_rows == 0) stripe.resize(0, cols);  // An empty range parses no columns
+                MPI_Allgather(&local_rows, 1, MPI_INT, rows.data(), 1, MPI_INT, MPI_COMM_WORLD);
+                A = std::move(stripe);
             } else {
-                std::cout << "Generating random matrices...\n";
-                A.randomize(0.0, 10.0);
-                B.randomize(0.0, 10.0);
+                A = B;
+            }
+        } else {
+            // Rank 0 loads or generates the matrices, then broadcasts them
+            if (rank == 0) {
+                if (!config.input_file.empty()) {
+                    std::cout << "Loading matrices from " << config.input_file << "...\n";
+                    // For simplicity, assume input file contains both matrices
+                    // In practice, you'd need two files or a specific format
+                    if (!CsvIO::read_matrix(config.input_file, A)) {
+                        std::cerr << "Error: Failed to load matrix A\n";
+                        MPI_Abort(MPI_COMM_WORLD, 1);
+                        return 1;
+                    }
+                    // For now, use the same matrix as B or generate random B
+                    B = A;
+                } else {
+                    std::cout << "Generating random matrices...\n";
+                    A.randomize(0.0, 10.0);
+                    B.randomize(0.0, 10.0);
+                }
             }
+
+            // Broadcast matrices to all processes
+            size_t count = static_cast<size_t>(config.matrix_size) * config.matrix_size;
+            comm::bcast(A.data(), count, 0, MPI_COMM_WORLD, config.distributed);
+            comm::bcast(B.data(), count, 0, MPI_COMM_WORLD, config.distributed);
         }
 
-        // Broadcast matrices to all processes
-        MPI_Bcast(A.data(), config.matrix_size * config.matrix_size, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-        MPI_Bcast(B.data(), config.matrix_size * config.matrix_size, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        // The whole of A for the checks after the multiply: with striped
+        // --parallel-read A is this rank's stripe, and B the same matrix in full
+        const Matrix& A_full = config.distributed.a_stripe_rows.empty() ? A : B;
 
         if (config.verification_mode) {
             // Verification mode - only rank 0 runs this
@@ -308,13 +835,53 @@ int main(int argc, char** argv) {
                 std::cout << "Computing matrix multiplication...\n";
             }
 
+            // With --binary-output, rank 0 computes straight into the mapped file
+            // (declared before C so the mapping outlives the view). Other ranks
+            // take the normal path, which issues the same MPI collectives.
+            MappedMatrixFile mapped;
+            Matrix C;
+            bool to_mapped = rank == 0 && !config.binary_output_file.empty();
+
+            if (to_mapped) {
+                if (!mapped.create(config.binary_output_file, A_full.rows(), B.cols())) {
+                    MPI_Abort(MPI_COMM_WORLD, 1);
+                    return 1;
+                }
+                C = mapped.view();
+            }
+
+            phases::reset_all();
             Timer timer;
             timer.start();
 
-            Matrix C = multiply(A, B, config);
+            if (to_mapped) {
+                multiply_into(A, B, config, C);
+            } else {
+                C = multiply(A, B, config);
+            }
 
             timer.stop();
             config.execution_time = timer.elapsed_seconds();
+            // Snapshot before validation runs the reference kernels
+            std::vector<phases::PhaseTotal> phase_totals = phases::totals();
+
+            // Collective: reduces the communication statistics onto rank 0
+            comm::report(config.distributed);
+            bool distributed = config.mode == ExecutionMode::MPI || config.mode == ExecutionMode::HYBRID;
+            if (distributed && !config.comm_model_file.empty()) {
+                mpi_bench::report_prediction(config);
+            }
+
+            // Collective: every rank checks its own stripe, the statistics are
+            // reduced onto rank 0
+            if (config.dist_validation != DistValidation::OFF) {
+                bool valid = verification::validate_distributed(C, A_full, B, config, rank, size);
+                config.validation_performed = true;
+                config.validation_passed = valid;
+                if (rank == 0 && !valid) {
+                    std::cerr << "\nWARNING: Distributed validation failed!\n";
+                }
+            }
 
             // Only rank 0 handles validation and output
             if (rank == 0) {
@@ -322,9 +889,10 @@ int main(int argc, char** argv) {
                 if (config.validate_against_openblas) {
                     std::cout << "\n";
                     bool valid = verification::validate_against_reference(
-                        C, A, B, config.algorithm, config);
+                        C, A_full, B, config.algorithm, config);
                     config.validation_performed = true;
-                    config.validation_passed = valid;
+                    config.validation_passed =
+                        valid && (config.dist_validation == DistValidation::OFF || config.validation_passed);
 
                     if (!valid) {
                         std::cerr << "\nWARNING: Validation failed! Results differ from OpenBLAS reference.\n";
@@ -339,6 +907,30 @@ int main(int argc, char** argv) {
                     }
                 }
 
+                if (to_mapped && !mapped.close()) {
+                    std::cerr << "Warning: Failed to flush " << config.binary_output_file << "\n";
+                }
+
+                // Buffer pool activity of this rank over the whole run
+                pool::Stats ps = pool::stats();
+                uint64_t hits = ps.local_hits + ps.global_hits;
+                std::ostringstream pool_line;
+                pool_line << hits << " hits (" << ps.global_hits << " shared), " << ps.misses
+                          << " misses, " << std::fixed << std::setprecision(1)
+                          << (hits + ps.misses > 0 ? 100.0 * hits / (hits + ps.misses) : 0.0)
+                          << "% reuse, peak idle " << ps.peak_idle_bytes / (1024.0 * 1024.0) << " MB";
+                config.report.add("Buffer Pool", pool_line.str());
+
+                // Where the multiply spent its time, summed over this rank's threads
+                config.report.add("Timer", CycleClock::description());
+                for (const auto& phase : phase_totals) {
+                    std::ostringstream phase_line;
+                    phase_line << std::fixed << std::setprecision(6) << phase.seconds << " s, "
+                               << phase.calls << " calls, " << std::setprecision(2)
+                               << phase.seconds * 1e6 / phase.calls << " us/call";
+                    config.report.add(phase.name, phase_line.str());
+                }
+
                 // Print results
                 print_results(config, rank);
 
@@ -1,4 +1,6 @@
 #include "matrix.hpp"
+#include "buffer_pool.hpp"
+#include "timer.hpp"
 #include <iostream>
 #include <iomanip>
 #include <cmath>
@@ -7,65 +9,134 @@
 
 namespace matmul {
 
+// Phases the Strassen engines spend outside the base-case kernel
+static PhaseAccumulator copy_phase("Matrix copy");
+static PhaseAccumulator add_phase("Matrix add/sub");
+
 // Constructors
-Matrix::Matrix() : rows_(0), cols_(0) {}
+Matrix::Matrix() : rows_(0), cols_(0), owned_(nullptr), ptr_(nullptr) {}
 
-Matrix::Matrix(int size) : rows_(size), cols_(size), data_(size * size, 0.0) {}
+Matrix::Matrix(int size) : Matrix(size, size) {}
 
-Matrix::Matrix(int rows, int cols) : rows_(rows), cols_(cols), data_(rows * cols, 0.0) {}
+Matrix::Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
+    owned_ = pool::allocate(count());
+    ptr_ = owned_;
+    std::fill(ptr_, ptr_ + count(), 0.0);
+}
 
-Matrix::Matrix(const Matrix& other)
-    : rows_(other.rows_), cols_(other.cols_), data_(other.data_) {}
+Matrix::Matrix(const Matrix& other) : rows_(other.rows_), cols_(other.cols_) {
+    owned_ = pool::allocate(count());
+    ptr_ = owned_;
+    std::copy(other.ptr_, other.ptr_ + count(), ptr_);
+}
 
 Matrix::Matrix(Matrix&& other) noexcept
-    : rows_(other.rows_), cols_(other.cols_), data_(std::move(other.data_)) {
+    : rows_(other.rows_), cols_(other.cols_), owned_(other.owned_), ptr_(other.ptr_),
+      shift_(other.shift_) {
     other.rows_ = 0;
     other.cols_ = 0;
+    other.owned_ = nullptr;
+    other.ptr_ = nullptr;
+    other.shift_ = 0;
+}
+
+Matrix::~Matrix() {
+    pool::release(owned_, allocated());
+}
+
+Matrix Matrix::view(double* data, int rows, int cols) {
+    Matrix m;
+    m.rows_ = rows;
+    m.cols_ = cols;
+    m.ptr_ = data;
+    return m;
 }
 
-Matrix::~Matrix() = default;
+// The only place read-only storage enters a Matrix; matrix_ is never handed
+// out as non-const
+ConstMatrixView::ConstMatrixView(const double* data, int rows, int cols)
+    : matrix_(Matrix::view(const_cast<double*>(data), rows, cols)) {}
+
+Matrix Matrix::uninitialized(int rows, int cols) {
+    Matrix m;
+    m.rows_ = rows;
+    m.cols_ = cols;
+    m.owned_ = pool::allocate(m.count());
+    m.ptr_ = m.owned_;
+    return m;
+}
+
+Matrix Matrix::uninitialized_aligned(int rows, int cols, size_t alignment, size_t phase) {
+    if (phase % sizeof(double) != 0 || phase >= std::max(alignment, sizeof(double))) {
+        throw std::runtime_error("Matrix phase must be a multiple of 8 below the alignment");
+    }
+    Matrix m;
+    m.rows_ = rows;
+    m.cols_ = cols;
+    if (m.count() == 0) return m;
+    m.shift_ = phase / sizeof(double);
+    m.owned_ = pool::allocate(m.allocated(), alignment);
+    m.ptr_ = m.owned_ + m.shift_;
+    return m;
+}
 
 // Assignment operators
 Matrix& Matrix::operator=(const Matrix& other) {
     if (this != &other) {
+        size_t n = other.count();
+        if (owned_ != nullptr && ptr_ == owned_ && count() == n) {
+            std::copy(other.ptr_, other.ptr_ + n, ptr_);   // Same size: reuse the buffer
+        } else {
+            double* fresh = pool::allocate(n);
+            std::copy(other.ptr_, other.ptr_ + n, fresh);
+            pool::release(owned_, allocated());
+            owned_ = fresh;
+            ptr_ = fresh;
+            shift_ = 0;
+        }
         rows_ = other.rows_;
         cols_ = other.cols_;
-        data_ = other.data_;
     }
     return *this;
 }
 
 Matrix& Matrix::operator=(Matrix&& other) noexcept {
     if (this != &other) {
+        pool::release(owned_, allocated());
         rows_ = other.rows_;
         cols_ = other.cols_;
-        data_ = std::move(other.data_);
+        owned_ = other.owned_;
+        ptr_ = other.ptr_;
+        shift_ = other.shift_;
         other.rows_ = 0;
         other.cols_ = 0;
+        other.owned_ = nullptr;
+        other.shift_ = 0;
+        other.ptr_ = nullptr;
     }
     return *this;
 }
 
 // Element access
 double& Matrix::operator()(int row, int col) {
-    return data_[index(row, col)];
+    return ptr_[index(row, col)];
 }
 
 const double& Matrix::operator()(int row, int col) const {
-    return data_[index(row, col)];
+    return ptr_[index(row, col)];
 }
 
 double* Matrix::data() {
-    return data_.data();
+    return ptr_;
 }
 
 const double* Matrix::data() const {
-    return data_.data();
+    return ptr_;
 }
 
 // Matrix operations
 void Matrix::fill(double value) {
-    std::fill(data_.begin(), data_.end(), value);
+    std::fill(ptr_, ptr_ + count(), value);
 }
 
 void Matrix::randomize(double min, double max) {
@@ -73,8 +144,8 @@ void Matrix::randomize(double min, double max) {
     static std::mt19937 gen(rd());
     std::uniform_real_distribution<double> dis(min, max);
 
-    for (auto& val : data_) {
-        val = dis(gen);
+    for (size_t i = 0; i < count(); ++i) {
+        ptr_[i] = dis(gen);
     }
 }
 
@@ -96,7 +167,8 @@ void Matrix::identity() {
 Matrix Matrix::submatrix(int row_start, int col_start, int row_end, int col_end) const {
     int sub_rows = row_end - row_start;
     int sub_cols = col_end - col_start;
-    Matrix result(sub_rows, sub_cols);
+    ScopedTimer timed(copy_phase);
+    Matrix result = uninitialized(sub_rows, sub_cols);
 
     for (int i = 0; i < sub_rows; ++i) {
         for (int j = 0; j < sub_cols; ++j) {
@@ -108,6 +180,7 @@ Matrix Matrix::submatrix(int row_start, int col_start, int row_end, int col_end)
 }
 
 void Matrix::set_submatrix(int row_start, int col_start, const Matrix& sub) {
+    ScopedTimer timed(copy_phase);
     for (int i = 0; i < sub.rows_; ++i) {
         for (int j = 0; j < sub.cols_; ++j) {
             (*this)(row_start + i, col_start + j) = sub(i, j);
@@ -120,10 +193,11 @@ Matrix Matrix::operator+(const Matrix& other) const {
     if (rows_ != other.rows_ || cols_ != other.cols_) {
         throw std::runtime_error("Matrix dimensions must match for addition");
     }
+    ScopedTimer timed(add_phase);
 
-    Matrix result(rows_, cols_);
-    for (size_t i = 0; i < data_.size(); ++i) {
-        result.data_[i] = data_[i] + other.data_[i];
+    Matrix result = uninitialized(rows_, cols_);
+    for (size_t i = 0; i < count(); ++i) {
+        result.ptr_[i] = ptr_[i] + other.ptr_[i];
     }
     return result;
 }
@@ -132,10 +206,11 @@ Matrix Matrix::operator-(const Matrix& other) const {
     if (rows_ != other.rows_ || cols_ != other.cols_) {
         throw std::runtime_error("Matrix dimensions must match for subtraction");
     }
+    ScopedTimer timed(add_phase);
 
-    Matrix result(rows_, cols_);
-    for (size_t i = 0; i < data_.size(); ++i) {
-        result.data_[i] = data_[i] - other.data_[i];
+    Matrix result = uninitialized(rows_, cols_);
+    for (size_t i = 0; i < count(); ++i) {
+        result.ptr_[i] = ptr_[i] - other.ptr_[i];
     }
     return result;
 }
@@ -144,9 +219,10 @@ Matrix& Matrix::operator+=(const Matrix& other) {
     if (rows_ != other.rows_ || cols_ != other.cols_) {
         throw std::runtime_error("Matrix dimensions must match for addition");
     }
+    ScopedTimer timed(add_phase);
 
-    for (size_t i = 0; i < data_.size(); ++i) {
-        data_[i] += other.data_[i];
+    for (size_t i = 0; i < count(); ++i) {
+        ptr_[i] += other.ptr_[i];
     }
     return *this;
 }
@@ -155,18 +231,35 @@ Matrix& Matrix::operator-=(const Matrix& other) {
     if (rows_ != other.rows_ || cols_ != other.cols_) {
         throw std::runtime_error("Matrix dimensions must match for subtraction");
     }
+    ScopedTimer timed(add_phase);
 
-    for (size_t i = 0; i < data_.size(); ++i) {
-        data_[i] -= other.data_[i];
+    for (size_t i = 0; i < count(); ++i) {
+        ptr_[i] -= other.ptr_[i];
     }
     return *this;
 }
 
 // Utility
 void Matrix::resize(int rows, int cols) {
+    if (is_view()) {
+        if (rows == rows_ && cols == cols_) return;
+        throw std::runtime_error("Cannot resize a matrix view");
+    }
+    size_t old_count = count();
+    size_t new_count = static_cast<size_t>(rows) * cols;
+    if (new_count != old_count) {
+        // Keep the leading elements and zero the rest, like std::vector::resize
+        double* fresh = pool::allocate(new_count);
+        size_t kept = std::min(old_count, new_count);
+        std::copy(ptr_, ptr_ + kept, fresh);
+        std::fill(fresh + kept, fresh + new_count, 0.0);
+        pool::release(owned_, old_count + shift_);
+        owned_ = fresh;
+        ptr_ = fresh;
+        shift_ = 0;
+    }
     rows_ = rows;
     cols_ = cols;
-    data_.resize(rows * cols);
 }
 
 void Matrix::print(int max_display) const {
@@ -195,8 +288,8 @@ bool Matrix::equals(const Matrix& other, double epsilon) const {
         return false;
     }
 
-    for (size_t i = 0; i < data_.size(); ++i) {
-        if (std::abs(data_[i] - other.data_[i]) > epsilon) {
+    for (size_t i = 0; i < count(); ++i) {
+        if (std::abs(ptr_[i] - other.ptr_[i]) > epsilon) {
             return false;
         }
     }
@@ -227,7 +320,7 @@ ComparisonResult Matrix::compare(const Matrix& other, double abs_tol, double rel
         return result;
     }
 
-    result.num_elements = data_.size();
+    result.num_elements = count();
 
     double sum_abs_error = 0.0;
     double sum_rel_error = 0.0;
@@ -0,0 +1,486 @@
+#include "mpi_bench.hpp"
+#include "comm.hpp"
+#include "matrix.hpp"
+#include <mpi.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace matmul {
+namespace mpi_bench {
+
+namespace {
+
+const int REPS = 20;
+
+// Committed datatype for a rows x cols block of a row-major matrix with
+// leading dimension ld. Free with MPI_Type_free.
+MPI_Datatype submatrix_type(int rows, int cols, int ld) {
+    MPI_Datatype type;
+    MPI_Type_vector(rows, cols, ld, MPI_DOUBLE, &type);
+    MPI_Type_commit(&type);
+    return type;
+}
+
+// Commbench sweep: message sizes grow by SIZE_STEP from 8 bytes
+const size_t SIZE_STEP = 4;
+const size_t MIN_SWEEP_BYTES = 4 << 20;
+const size_t REP_BYTES = 64 << 20;    // Repetitions per point: about this much traffic
+
+const CommOp ALL_OPS[] = {CommOp::BCAST, CommOp::ALLGATHERV, CommOp::SCATTERV, CommOp::SENDRECV};
+
+// Average seconds per call of body over REPS calls, slowest rank
+template <typename Body>
+double time_collective(Body body) {
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+    for (int rep = 0; rep < REPS; ++rep) {
+        body();
+    }
+    double elapsed = (MPI_Wtime() - start) / REPS;
+    MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return elapsed;
+}
+
+void print_row(const std::string& label, double old_seconds, double new_seconds) {
+    double saved = old_seconds > 0.0 ? 100.0 * (1.0 - new_seconds / old_seconds) : 0.0;
+    std::cout << std::left << std::setw(17) << label << std::right << std::fixed
+              << std::setprecision(4) << std::setw(11) << old_seconds * 1e3
+              << std::setw(11) << new_seconds * 1e3
+              << std::setprecision(1) << std::setw(9) << saved << "%\n";
+}
+
+// Run op on comm with a total payload of count doubles; returns seconds per
+// call (slowest rank)
+double time_op(CommOp op, size_t count, MPI_Comm comm, std::vector<double>& send,
+               std::vector<double>& recv) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // Equal split for the v-collectives, remainder to the first ranks
+    std::vector<int> counts(size);
+    std::vector<int> displs(size);
+    int offset = 0;
+    for (int i = 0; i < size; ++i) {
+        counts[i] = static_cast<int>(count / size + (static_cast<size_t>(i) < count % size ? 1 : 0));
+        displs[i] = offset;
+        offset += counts[i];
+    }
+
+    size_t bytes = std::max<size_t>(count * sizeof(double), 1);
+    int reps = static_cast<int>(std::max<size_t>(3, std::min<size_t>(50, REP_BYTES / bytes)));
+
+    auto run = [&]() {
+        switch (op) {
+            case CommOp::BCAST:
+                MPI_Bcast(recv.data(), static_cast<int>(count), MPI_DOUBLE, 0, comm);
+                break;
+            case CommOp::ALLGATHERV:
+                MPI_Allgatherv(send.data(), counts[rank], MPI_DOUBLE, recv.data(),
+                               counts.data(), displs.data(), MPI_DOUBLE, comm);
+                break;
+            case CommOp::SCATTERV:
+                MPI_Scatterv(send.data(), counts.data(), displs.data(), MPI_DOUBLE,
+                             recv.data(), counts[rank], MPI_DOUBLE, 0, comm);
+                break;
+            case CommOp::SENDRECV:
+                MPI_Sendrecv(send.data(), static_cast<int>(count), MPI_DOUBLE, (rank + 1) % size, 0,
+                             recv.data(), static_cast<int>(count), MPI_DOUBLE,
+                             (rank + size - 1) % size, 0, comm, MPI_STATUS_IGNORE);
+                break;
+        }
+    };
+
+    run();  // Warm-up (connection setup, registration)
+    MPI_Barrier(comm);
+    double start = MPI_Wtime();
+    for (int rep = 0; rep < reps; ++rep) {
+        run();
+    }
+    double elapsed = (MPI_Wtime() - start) / reps;
+    MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, comm);
+    return elapsed;
+}
+
+// Least squares fit of t = alpha + beta * bytes, weighted by 1/t^2 so the
+// small messages (which determine alpha) count as much as the large ones
+void fit_alpha_beta(const std::vector<double>& bytes, const std::vector<double>& seconds,
+                    double& alpha, double& beta) {
+    double sw = 0.0, sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        double w = 1.0 / std::max(seconds[i] * seconds[i], 1e-30);
+        sw += w;
+        sx += w * bytes[i];
+        sy += w * seconds[i];
+        sxx += w * bytes[i] * bytes[i];
+        sxy += w * bytes[i] * seconds[i];
+    }
+    double det = sw * sxx - sx * sx;
+    beta = det > 0.0 ? (sw * sxy - sx * sy) / det : 0.0;
+    alpha = (sy - beta * sx) / sw;
+
+    // Latency and bandwidth must be physical; refit the other term alone
+    if (beta < 0.0) {
+        beta = 0.0;
+        alpha = sy / sw;
+    }
+    if (alpha < 0.0) {
+        alpha = 0.0;
+        beta = sxy / sxx;
+    }
+}
+
+// Communication of one n x n multiply on the regular load path: main
+// broadcasts A and B, the engine all-gathers C
+double predict_multiply(const CommModel& model, int ranks, int n) {
+    double bytes = static_cast<double>(n) * n * sizeof(double);
+    return 2.0 * model.predict(CommOp::BCAST, ranks, bytes) +
+           model.predict(CommOp::ALLGATHERV, ranks, bytes);
+}
+
+std::string format_seconds(double seconds) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(6) << seconds << " s";
+    return oss.str();
+}
+
+} // namespace
+
+std::string op_to_string(CommOp op) {
+    switch (op) {
+        case CommOp::BCAST: return "bcast";
+        case CommOp::ALLGATHERV: return "allgatherv";
+        case CommOp::SCATTERV: return "scatterv";
+        case CommOp::SENDRECV: return "sendrecv";
+        default: return "unknown";
+    }
+}
+
+const CommModel::Fit* CommModel::find(CommOp op, int ranks) const {
+    const Fit* best = nullptr;
+    for (const Fit& fit : fits) {
+        if (fit.op != op) continue;
+        if (best == nullptr || std::abs(fit.ranks - ranks) < std::abs(best->ranks - ranks)) {
+            best = &fit;
+        }
+    }
+    return best;
+}
+
+double CommModel::predict(CommOp op, int ranks, double bytes) const {
+    const Fit* fit = find(op, ranks);
+    return fit != nullptr ? fit->alpha + fit->beta * bytes : 0.0;
+}
+
+bool CommModel::save(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << " for writing\n";
+        return false;
+    }
+    file << "commbench 1\n" << std::scientific << std::setprecision(9);
+    for (const Fit& fit : fits) {
+        file << op_to_string(fit.op) << " " << fit.ranks << " " << fit.alpha << " " << fit.beta << "\n";
+    }
+    return file.good();
+}
+
+bool CommModel::load(const std::string& filename) {
+    std::ifstream file(filename);
+    std::string magic;
+    int version = 0;
+    if (!file.is_open() || !(file >> magic >> version) || magic != "commbench" || version != 1) {
+        return false;
+    }
+
+    fits.clear();
+    std::string name;
+    Fit fit;
+    while (file >> name >> fit.ranks >> fit.alpha >> fit.beta) {
+        bool known = false;
+        for (CommOp op : ALL_OPS) {
+            if (op_to_string(op) == name) {
+                fit.op = op;
+                known = true;
+            }
+        }
+        if (known) fits.push_back(fit);
+    }
+    return !fits.empty();
+}
+
+void run_transfer_overheads(const Config& config) {
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    int n = config.matrix_size;
+    if (static_cast<int64_t>(n) * n > INT_MAX) {
+        if (rank == 0) {
+            std::cerr << "Error: --transfer-bench needs --size at most 46340 (n * n must fit an MPI count)\n";
+        }
+        return;
+    }
+    int stripe_rows = std::max(1, n / size);
+    int row_offset = std::min(rank * stripe_rows, n - stripe_rows);
+
+    Matrix A(n);
+    Matrix B(n);
+    A.randomize();
+    B.randomize();
+
+    // A stripe: the old element-wise copy vs. a view
+    double stripe_copy = time_collective([&]() {
+        Matrix A_local(stripe_rows, n);
+        for (int i = 0; i < stripe_rows; ++i) {
+            for (int j = 0; j < n; ++j) {
+                A_local(i, j) = A(row_offset + i, j);
+            }
+        }
+    });
+    double stripe_view = time_collective([&]() {
+        const ConstMatrixView A_local(A.data() + static_cast<size_t>(row_offset) * n, stripe_rows, n);
+        (void)A_local;
+    });
+
+    // B replica: copy vs. reference
+    double replica_copy = time_collective([&]() {
+        Matrix B_local = B;
+        (void)B_local;
+    });
+
+    // Column block (n x n/2 of a row-major matrix) from rank 0 to rank 1
+    int block_cols = std::max(1, n / 2);
+    double block_packed = 0.0;
+    double block_typed = 0.0;
+    if (size > 1) {
+        std::vector<double> buffer(static_cast<size_t>(n) * block_cols);
+        Matrix target(n);
+
+        block_packed = time_collective([&]() {
+            if (rank == 0) {
+                for (int i = 0; i < n; ++i) {
+                    std::copy(A.data() + static_cast<size_t>(i) * n,
+                              A.data() + static_cast<size_t>(i) * n + block_cols,
+                              buffer.begin() + static_cast<size_t>(i) * block_cols);
+                }
+                MPI_Send(buffer.data(), n * block_cols, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD);
+            } else if (rank == 1) {
+                MPI_Recv(buffer.data(), n * block_cols, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD,
+                         MPI_STATUS_IGNORE);
+                for (int i = 0; i < n; ++i) {
+                    std::copy(buffer.begin() + static_cast<size_t>(i) * block_cols,
+                              buffer.begin() + static_cast<size_t>(i + 1) * block_cols,
+                              target.data() + static_cast<size_t>(i) * n);
+                }
+            }
+        });
+
+        MPI_Datatype block = submatrix_type(n, block_cols, n);
+        block_typed = time_collective([&]() {
+            if (rank == 0) {
+                MPI_Send(A.data(), 1, block, 1, 0, MPI_COMM_WORLD);
+            } else if (rank == 1) {
+                MPI_Recv(target.data(), 1, block, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            }
+        });
+        MPI_Type_free(&block);
+    }
+
+    // Repeated panel broadcast: per-call collective vs. persistent request
+    int panel_count = stripe_rows * n;
+    std::vector<double> panel(panel_count, 1.0);
+    double bcast_plain = time_collective([&]() {
+        MPI_Bcast(panel.data(), panel_count, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    });
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double setup_start = MPI_Wtime();
+    comm::PersistentBcast persistent(panel.data(), panel_count, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    double setup = MPI_Wtime() - setup_start;
+    MPI_Allreduce(MPI_IN_PLACE, &setup, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+    double bcast_persistent = time_collective([&]() {
+        persistent.start();
+        persistent.wait();
+    });
+
+    if (rank != 0) return;
+
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "     MPI Transfer Overheads (" << n << "x" << n << ", " << size << " ranks)\n";
+    std::cout << "========================================\n";
+    std::cout << std::left << std::setw(17) << "Transfer" << std::right
+              << std::setw(11) << "Old (ms)" << std::setw(11) << "New (ms)"
+              << std::setw(10) << "Saved" << "\n";
+    print_row("A stripe", stripe_copy, stripe_view);
+    print_row("B replica", replica_copy, 0.0);
+    if (size > 1) {
+        print_row("Column block", block_packed, block_typed);
+    }
+    print_row("Panel bcast", bcast_plain, bcast_persistent);
+    std::cout << "========================================\n";
+    std::cout << "Average of " << REPS << " calls, slowest rank\n";
+    std::cout << "Panel bcast: " << stripe_rows << "x" << n << " doubles, "
+              << (persistent.native() ? "MPI_Bcast_init" : "MPI_Send_init/MPI_Recv_init fan-out")
+              << ", one-time setup " << std::fixed << std::setprecision(4) << setup * 1e3 << " ms\n";
+    if (size == 1) {
+        std::cout << "Column block transfer needs at least 2 ranks\n";
+    }
+    std::cout << "\n";
+}
+
+void run_commbench(const Config& config) {
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (size < 2) {
+        if (rank == 0) {
+            std::cerr << "Error: --commbench needs at least 2 MPI ranks\n";
+        }
+        return;
+    }
+
+    int n = config.matrix_size;
+    // The multiply measurement sends whole matrices as single MPI counts
+    int64_t elements = static_cast<int64_t>(n) * n;
+    if (elements > INT_MAX) {
+        if (rank == 0) {
+            std::cerr << "Error: --commbench needs --size at most 46340 (n * n must fit an MPI count)\n";
+        }
+        return;
+    }
+    size_t max_bytes = std::max(static_cast<size_t>(elements) * sizeof(double), MIN_SWEEP_BYTES);
+    size_t max_count = max_bytes / sizeof(double);
+    std::vector<double> send(max_count, 1.0);
+    std::vector<double> recv(max_count, 0.0);
+
+    std::vector<int> rank_counts;
+    for (int p = 2; p < size; p *= 2) rank_counts.push_back(p);
+    rank_counts.push_back(size);
+
+    if (rank == 0) {
+        std::cout << "\n";
+        std::cout << "========================================\n";
+        std::cout << "   MPI Communication Benchmark (" << size << " ranks)\n";
+        std::cout << "========================================\n";
+        std::cout << "Sizes 8 B .. " << max_bytes / 1024 << " KB, total payload per call\n\n";
+        std::cout << std::left << std::setw(12) << "Collective" << std::right << std::setw(6) << "Ranks"
+                  << std::setw(14) << "Latency (us)" << std::setw(14) << "BW (GB/s)"
+                  << std::setw(12) << "Max error" << "\n";
+    }
+
+    CommModel model;
+    for (int p : rank_counts) {
+        MPI_Comm sub;
+        MPI_Comm_split(MPI_COMM_WORLD, rank < p ? 0 : MPI_UNDEFINED, rank, &sub);
+
+        for (CommOp op : ALL_OPS) {
+            std::vector<double> bytes;
+            std::vector<double> seconds;
+            if (sub != MPI_COMM_NULL) {
+                for (size_t count = 1; count <= max_count; count *= SIZE_STEP) {
+                    bytes.push_back(static_cast<double>(count * sizeof(double)));
+                    seconds.push_back(time_op(op, count, sub, send, recv));
+                }
+            }
+
+            CommModel::Fit fit{op, p, 0.0, 0.0};
+            double max_error = 0.0;
+            if (rank == 0) {
+                fit_alpha_beta(bytes, seconds, fit.alpha, fit.beta);
+                for (size_t i = 0; i < bytes.size(); ++i) {
+                    double predicted = fit.alpha + fit.beta * bytes[i];
+                    max_error = std::max(max_error, std::abs(predicted - seconds[i]) / seconds[i]);
+                }
+                model.fits.push_back(fit);
+
+                std::cout << std::left << std::setw(12) << op_to_string(op) << std::right
+                          << std::setw(6) << p << std::fixed << std::setprecision(2)
+                          << std::setw(14) << fit.alpha * 1e6
+                          << std::setw(14) << (fit.beta > 0.0 ? 1e-9 / fit.beta : 0.0)
+                          << std::setprecision(1) << std::setw(11) << max_error * 100.0 << "%\n";
+            }
+        }
+
+        if (sub != MPI_COMM_NULL) MPI_Comm_free(&sub);
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    // Measure the communication of an n x n multiply the way main and the engines do it
+    std::vector<int> counts(size);
+    std::vector<int> displs(size);
+    int64_t offset = 0;
+    for (int i = 0; i < size; ++i) {
+        int64_t count = static_cast<int64_t>(n / size + (i < n % size ? 1 : 0)) * n;
+        counts[i] = static_cast<int>(count);
+        displs[i] = static_cast<int>(offset);
+        offset += count;
+    }
+    Matrix A(n);
+    Matrix B(n);
+    Matrix C(n);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+    MPI_Bcast(A.data(), static_cast<int>(elements), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(B.data(), static_cast<int>(elements), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Allgatherv(A.data(), counts[rank], MPI_DOUBLE, C.data(), counts.data(), displs.data(),
+                   MPI_DOUBLE, MPI_COMM_WORLD);
+    double actual = MPI_Wtime() - start;
+    MPI_Allreduce(MPI_IN_PLACE, &actual, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+    if (rank != 0) return;
+
+    std::string filename = config.comm_model_file.empty() ? "commbench.txt" : config.comm_model_file;
+    bool saved = model.save(filename);
+
+    std::cout << "========================================\n";
+    if (saved) {
+        std::cout << "Model saved to " << filename << "\n";
+    }
+    std::cout << "Multiply " << n << "x" << n << " (2 bcast + allgatherv): predicted "
+              << format_seconds(predict_multiply(model, size, n))
+              << ", actual " << format_seconds(actual) << "\n\n";
+}
+
+void report_prediction(Config& config) {
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // The slowest rank includes waiting for late ranks at the all-gather;
+    // the fastest (last to arrive) is close to the pure transfer time
+    double slowest = comm::stats().seconds;
+    double fastest = slowest;
+    MPI_Reduce(rank == 0 ? MPI_IN_PLACE : &slowest, &slowest, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(rank == 0 ? MPI_IN_PLACE : &fastest, &fastest, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+    if (rank != 0) return;
+
+    CommModel model;
+    if (!model.load(config.comm_model_file)) {
+        std::cerr << "Warning: No usable communication model in " << config.comm_model_file
+                  << " (run with --commbench first)\n";
+        return;
+    }
+
+    const CommModel::Fit* fit = model.find(CommOp::BCAST, size);
+    std::ostringstream predicted;
+    predicted << format_seconds(predict_multiply(model, size, config.matrix_size))
+              << " (alpha-beta, fitted at " << (fit != nullptr ? fit->ranks : 0) << " ranks)";
+    config.report.add("Comm Predicted", predicted.str());
+    config.report.add("Comm Actual", format_seconds(fastest) + " fastest rank, " +
+                                     format_seconds(slowest) + " slowest (incl. skew)");
+}
+
+} // namespace mpi_bench
+} // namespace matmul
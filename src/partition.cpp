@@ -0,0 +1,302 @@
+#include "partition.hpp"
+#include "algorithms.hpp"
+#include "timer.hpp"
+#include <mpi.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+namespace matmul {
+namespace partition {
+
+namespace {
+
+// Calibration problem size and minimum measured time
+const int CALIBRATION_SIZE = 128;
+const double CALIBRATION_SECONDS = 0.05;
+
+// Show every rank's share up to this many ranks, min/max beyond
+const int MAX_LISTED_RANKS = 8;
+
+std::string describe(const std::vector<double>& values, int precision) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(precision);
+    if (static_cast<int>(values.size()) <= MAX_LISTED_RANKS) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i > 0) oss << "/";
+            oss << values[i];
+        }
+    } else {
+        auto mm = std::minmax_element(values.begin(), values.end());
+        oss << "min " << *mm.first << ", max " << *mm.second;
+    }
+    return oss.str();
+}
+
+// Read per-rank rates written by record(); empty on any mismatch
+std::vector<double> read_rates(const std::string& filename, int size) {
+    std::ifstream file(filename);
+    if (!file.is_open()) return {};
+
+    std::vector<double> rates(size, 0.0);
+    std::string line;
+    int ranks = -1;
+    int seen = 0;
+
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        std::string key;
+        iss >> key;
+        if (key == "ranks") {
+            iss >> ranks;
+        } else {
+            int r = std::atoi(key.c_str());
+            double rate = 0.0;
+            if (iss >> rate && r >= 0 && r < size && rate > 0.0) {
+                rates[r] = rate;
+                ++seen;
+            }
+        }
+    }
+
+    if (ranks != size || seen != size) return {};
+    return rates;
+}
+
+} // namespace
+
+void RowPartition::counts(int n, std::vector<int>& sendcounts, std::vector<int>& displs) const {
+    sendcounts.resize(rows.size());
+    displs.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        sendcounts[i] = rows[i] * n;
+        displs[i] = offsets[i] * n;
+    }
+}
+
+RowPartition equal(int m, int size) {
+    RowPartition part;
+    part.rows.resize(size);
+    part.offsets.resize(size);
+
+    int rows_per_proc = m / size;
+    int remainder = m % size;
+    for (int i = 0; i < size; ++i) {
+        part.rows[i] = rows_per_proc + (i < remainder ? 1 : 0);
+        part.offsets[i] = i * rows_per_proc + std::min(i, remainder);
+    }
+    return part;
+}
+
+RowPartition weighted(int m, const std::vector<double>& weights) {
+    int size = weights.size();
+    double total = 0.0;
+    for (double w : weights) {
+        if (w > 0.0 && std::isfinite(w)) total += w;
+    }
+    if (total <= 0.0) {
+        return equal(m, size);
+    }
+
+    // Floor of each exact share, then hand out the leftover rows by largest remainder
+    RowPartition part;
+    part.rows.resize(size);
+    part.offsets.resize(size);
+    std::vector<std::pair<double, int>> fractions(size);
+    int assigned = 0;
+
+    for (int i = 0; i < size; ++i) {
+        double w = (weights[i] > 0.0 && std::isfinite(weights[i])) ? weights[i] : 0.0;
+        double exact = m * w / total;
+        part.rows[i] = static_cast<int>(std::floor(exact));
+        fractions[i] = {exact - part.rows[i], i};
+        assigned += part.rows[i];
+    }
+
+    std::sort(fractions.begin(), fractions.end(),
+              [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+                  return a.first != b.first ? a.first > b.first : a.second < b.second;
+              });
+    for (int i = 0; assigned < m; ++i, ++assigned) {
+        part.rows[fractions[i % size].second]++;
+    }
+
+    int offset = 0;
+    for (int i = 0; i < size; ++i) {
+        part.offsets[i] = offset;
+        offset += part.rows[i];
+    }
+    return part;
+}
+
+double calibrate(const OptimizationOptions& opt, int num_threads) {
+    int n = CALIBRATION_SIZE;
+    Matrix A(n, n);
+    Matrix B(n, n);
+    Matrix C(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            A(i, j) = 1.0 + ((i * 7 + j) % 13) * 0.125;
+            B(i, j) = 1.0 - ((i + j * 5) % 11) * 0.0625;
+        }
+    }
+
+    auto run = [&]() {
+        if (num_threads > 1) {
+            naive::openmp_rows(A, B, opt, C, 0, n, num_threads);
+        } else {
+            naive::sequential_rows(A, B, opt, C, 0, n);
+        }
+    };
+
+    run();  // Warm up caches and the thread pool
+
+    Timer timer;
+    timer.start();
+    int reps = 0;
+    do {
+        run();
+        ++reps;
+    } while (timer.elapsed_seconds() < CALIBRATION_SECONDS);
+    timer.stop();
+
+    return 2.0 * n * n * n * reps / timer.elapsed_seconds() / 1e9;
+}
+
+int global_rows(const Matrix& A, const DistributedOptions& dist) {
+    if (dist.a_stripe_rows.empty()) return A.rows();
+    return std::accumulate(dist.a_stripe_rows.begin(), dist.a_stripe_rows.end(), 0);
+}
+
+ConstMatrixView local_rows_of(const Matrix& A, const RowPartition& part, int rank,
+                           const DistributedOptions& dist) {
+    size_t offset = dist.a_stripe_rows.empty() ? static_cast<size_t>(part.row_offset(rank)) : 0;
+    return ConstMatrixView(A.data() + offset * A.cols(), part.local_rows(rank), A.cols());
+}
+
+RowPartition for_engine(int m, const OptimizationOptions& opt, int num_threads,
+                        const DistributedOptions& dist) {
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Each rank already holds the rows it read; moving them would undo the point
+    if (!dist.a_stripe_rows.empty()) {
+        if (rank == 0 && dist.balance != LoadBalance::EQUAL) {
+            std::cerr << "Warning: --parallel-read keeps the stripes as read; --balance is ignored\n";
+        }
+        RowPartition part;
+        part.rows = dist.a_stripe_rows;
+        part.offsets.resize(size);
+        std::partial_sum(part.rows.begin(), part.rows.end() - 1, part.offsets.begin() + 1);
+        return part;
+    }
+
+    if (dist.balance == LoadBalance::EQUAL) {
+        return equal(m, size);
+    }
+
+    std::vector<double> rates;
+    std::string source;
+
+    if (dist.balance == LoadBalance::HISTORY) {
+        int usable = 0;
+        if (rank == 0) {
+            rates = read_rates(dist.balance_file, size);
+            usable = rates.empty() ? 0 : 1;
+        }
+        MPI_Bcast(&usable, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (usable) {
+            rates.resize(size);
+            MPI_Bcast(rates.data(), size, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            source = "History (" + dist.balance_file + ")";
+        } else if (rank == 0) {
+            std::cerr << "Warning: No usable rates for " << size << " ranks in '"
+                      << dist.balance_file << "'; calibrating instead\n";
+        }
+    }
+
+    if (rates.empty()) {
+        double local_rate = calibrate(opt, num_threads);
+        rates.resize(size);
+        MPI_Allgather(&local_rate, 1, MPI_DOUBLE, rates.data(), 1, MPI_DOUBLE, MPI_COMM_WORLD);
+        source = "Calibrated";
+    }
+
+    RowPartition part = weighted(m, rates);
+
+    if (rank == 0 && dist.report != nullptr) {
+        std::vector<double> rows(part.rows.begin(), part.rows.end());
+        dist.report->add("Load Balance", source);
+        dist.report->add("Rank Rates", describe(rates, 2) + " GFLOP/s");
+        dist.report->add("Row Split", describe(rows, 0));
+    }
+
+    return part;
+}
+
+void record(int computed_rows, double local_seconds, int n, int k,
+            const DistributedOptions& dist) {
+    if (dist.balance == LoadBalance::EQUAL && dist.balance_file.empty()) {
+        return;
+    }
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    std::vector<double> seconds(size);
+    std::vector<int> rows(size);
+    MPI_Gather(&local_seconds, 1, MPI_DOUBLE, seconds.data(), 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Gather(&computed_rows, 1, MPI_INT, rows.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (rank != 0) return;
+
+    double max_t = *std::max_element(seconds.begin(), seconds.end());
+    double mean_t = std::accumulate(seconds.begin(), seconds.end(), 0.0) / size;
+
+    if (dist.report != nullptr) {
+        std::ostringstream imbalance;
+        imbalance << describe(seconds, 3) << " s (imbalance "
+                  << std::fixed << std::setprecision(1)
+                  << (mean_t > 0.0 ? 100.0 * (max_t / mean_t - 1.0) : 0.0) << "%)";
+        dist.report->add("Rank Compute", imbalance.str());
+    }
+
+    if (dist.balance_file.empty()) return;
+
+    // Rate = work / time; ranks without a measurable share get the mean rate
+    std::vector<double> rates(size, 0.0);
+    double sum = 0.0;
+    int measured = 0;
+    for (int i = 0; i < size; ++i) {
+        if (rows[i] > 0 && seconds[i] > 1e-6) {
+            rates[i] = 2.0 * rows[i] * n * k / seconds[i] / 1e9;
+            sum += rates[i];
+            ++measured;
+        }
+    }
+    if (measured == 0) return;
+    for (int i = 0; i < size; ++i) {
+        if (rates[i] <= 0.0) rates[i] = sum / measured;
+    }
+
+    std::ofstream file(dist.balance_file);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Could not write balance file '" << dist.balance_file << "'\n";
+        return;
+    }
+    file << "# matmul per-rank compute rates (GFLOP/s) from the last run\n";
+    file << "ranks " << size << "\n";
+    file << std::setprecision(9);
+    for (int i = 0; i < size; ++i) {
+        file << i << " " << rates[i] << "\n";
+    }
+}
+
+} // namespace partition
+} // namespace matmul
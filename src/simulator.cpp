@@ -0,0 +1,359 @@
+#include "simulator.hpp"
+#include "algorithms.hpp"
+#include "comm.hpp"
+#include "matrix.hpp"
+#include "mpi_bench.hpp"
+#include "timer.hpp"
+#include <mpi.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace matmul {
+namespace simulator {
+
+namespace {
+
+// Used when no --comm-model is given
+const double DEFAULT_LATENCY = 1e-6;
+const double DEFAULT_BANDWIDTH = 10e9;
+
+const int MAX_DEFAULT_RANKS = 512;
+const double RATE_SECONDS = 0.2;       // Minimum duration of the kernel rate measurement
+const int STRASSEN_THRESHOLD = 64;     // Same as strassen_seq.cpp
+
+const Engine ALL_ENGINES[] = {Engine::NAIVE_MPI, Engine::NAIVE_HYBRID, Engine::STRASSEN_MPI};
+
+int ceil_log2(int p) {
+    int levels = 0;
+    while ((1 << levels) < p) ++levels;
+    return levels;
+}
+
+// Measured fit for exactly p ranks (null if none)
+const mpi_bench::CommModel::Fit* exact_fit(mpi_bench::CommOp op, int p, const SimParams& params) {
+    const mpi_bench::CommModel::Fit* fit = params.measured.find(op, p);
+    return fit != nullptr && fit->ranks == p ? fit : nullptr;
+}
+
+// Binomial tree for small payloads, scatter + allgather (van de Geijn) for large
+double bcast_time(double bytes, int p, const SimParams& params) {
+    if (const mpi_bench::CommModel::Fit* fit = exact_fit(mpi_bench::CommOp::BCAST, p, params)) {
+        return fit->alpha + fit->beta * bytes;
+    }
+    double alpha = params.latency;
+    double beta = 1.0 / params.bandwidth;
+    double tree = ceil_log2(p) * (alpha + bytes * beta);
+    double scatter_allgather = (ceil_log2(p) + p - 1) * alpha + 2.0 * (p - 1) / p * bytes * beta;
+    return std::min(tree, scatter_allgather);
+}
+
+// Recursive doubling / Bruck for small payloads, ring for large (same volume)
+double allgather_time(double bytes, int p, const SimParams& params) {
+    if (const mpi_bench::CommModel::Fit* fit = exact_fit(mpi_bench::CommOp::ALLGATHERV, p, params)) {
+        return fit->alpha + fit->beta * bytes;
+    }
+    double alpha = params.latency;
+    double beta = 1.0 / params.bandwidth;
+    double volume = static_cast<double>(p - 1) / p * bytes * beta;
+    return std::min(ceil_log2(p) * alpha, (p - 1) * alpha) + volume;
+}
+
+// Flops of strassen::sequential: odd sizes are padded by one at each level,
+// 18 quarter-size additions per level, naive below the threshold
+double strassen_flops(int n) {
+    if (n <= STRASSEN_THRESHOLD) return 2.0 * n * n * static_cast<double>(n);
+    if (n % 2 != 0) return strassen_flops(n + 1);
+    double half = n / 2;
+    return 7.0 * strassen_flops(n / 2) + 18.0 * half * half;
+}
+
+// GFLOP/s of one core running the engines' row kernel at size n
+double measure_rate(int n, const OptimizationOptions& opt) {
+    int rows = static_cast<int>(std::max(1.0, std::min(static_cast<double>(n), 1e8 / (2.0 * n * n))));
+    Matrix A(rows, n);
+    Matrix B(n, n);
+    Matrix C(rows, n);
+    A.randomize();
+    B.randomize();
+
+    naive::sequential_rows(A, B, opt, C, 0, rows);  // Warm up
+
+    Timer timer;
+    timer.start();
+    int reps = 0;
+    do {
+        naive::sequential_rows(A, B, opt, C, 0, rows);
+        ++reps;
+    } while (timer.elapsed_seconds() < RATE_SECONDS);
+    timer.stop();
+
+    return 2.0 * rows * n * static_cast<double>(n) * reps / timer.elapsed_seconds() / 1e9;
+}
+
+int count_nodes() {
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+    int node_rank;
+    MPI_Comm_rank(node_comm, &node_rank);
+    MPI_Comm_free(&node_comm);
+
+    int leaders = node_rank == 0 ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &leaders, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    return leaders;
+}
+
+// Run the engine for real at this job's size; phase times as in PhaseTimes
+// (bcast and compute from the slowest rank, gather from the fastest so it
+// excludes waiting for late ranks)
+PhaseTimes measure(Engine engine, const Config& config) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    int n = config.matrix_size;
+    Matrix A(n);
+    Matrix B(n);
+    if (rank == 0) {
+        A.randomize();
+        B.randomize();
+    }
+
+    // The schedule being simulated: plain FP64 collectives, equal split
+    DistributedOptions dist;
+    dist.report = nullptr;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+    comm::bcast(A.data(), static_cast<size_t>(n) * n, 0, MPI_COMM_WORLD, dist);
+    comm::bcast(B.data(), static_cast<size_t>(n) * n, 0, MPI_COMM_WORLD, dist);
+    double bcast = MPI_Wtime() - start;
+
+    comm::reset_stats();
+    start = MPI_Wtime();
+    switch (engine) {
+        case Engine::NAIVE_MPI:
+            naive::mpi(A, B, config.optimization, dist);
+            break;
+        case Engine::NAIVE_HYBRID:
+            naive::hybrid(A, B, config.optimization, config.num_threads, dist);
+            break;
+        case Engine::STRASSEN_MPI:
+            strassen::mpi(A, B, config.optimization, dist);
+            break;
+    }
+    double engine_seconds = MPI_Wtime() - start;
+    double gather = comm::stats().seconds;
+
+    PhaseTimes measured;
+    measured.bcast = bcast;
+    measured.compute = engine_seconds - gather;
+    measured.gather = gather;
+    MPI_Allreduce(MPI_IN_PLACE, &measured.bcast, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &measured.compute, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &measured.gather, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+    return measured;
+}
+
+void print_row(const std::string& label, int ranks, const PhaseTimes& t, double baseline) {
+    std::cout << std::left << std::setw(22) << label << std::right << std::setw(6) << ranks
+              << std::fixed << std::setprecision(4)
+              << std::setw(11) << t.bcast << std::setw(11) << t.compute
+              << std::setw(11) << t.gather << std::setw(11) << t.total()
+              << std::setprecision(2) << std::setw(9) << baseline / t.total() << "\n";
+}
+
+void print_header() {
+    std::cout << std::left << std::setw(22) << "Engine" << std::right << std::setw(6) << "Ranks"
+              << std::setw(11) << "Bcast" << std::setw(11) << "Compute"
+              << std::setw(11) << "Gather" << std::setw(11) << "Total"
+              << std::setw(9) << "Speedup" << "\n";
+}
+
+} // namespace
+
+std::string engine_to_string(Engine engine) {
+    switch (engine) {
+        case Engine::NAIVE_MPI: return "naive::mpi";
+        case Engine::NAIVE_HYBRID: return "naive::hybrid";
+        case Engine::STRASSEN_MPI: return "strassen::mpi";
+        default: return "unknown";
+    }
+}
+
+bool load_params(const std::string& filename, SimParams& params) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << "\n";
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream iss(line);
+        std::string key;
+        std::string value;
+        if (!(iss >> key >> value)) continue;
+
+        if (key == "latency") params.latency = std::atof(value.c_str());
+        else if (key == "bandwidth") params.bandwidth = std::atof(value.c_str());
+        else if (key == "cores_per_node") params.cores_per_node = std::atoi(value.c_str());
+        else if (key == "nodes") params.nodes = std::atoi(value.c_str());
+        else if (key == "gflops_per_core") params.gflops_per_core = std::atof(value.c_str());
+        else if (key == "ranks") {
+            params.ranks.clear();
+            std::istringstream list(value);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                int p = std::atoi(item.c_str());
+                if (p > 0) params.ranks.push_back(p);
+            }
+        } else {
+            std::cerr << "Warning: Unknown simulation parameter '" << key << "' in " << filename << "\n";
+        }
+    }
+    if (params.latency > 0.0 || params.bandwidth > 0.0) {
+        params.network_source = filename;
+    }
+    return true;
+}
+
+PhaseTimes simulate(Engine engine, int n, int ranks, int threads, const SimParams& params) {
+    int threads_per_rank = engine == Engine::NAIVE_HYBRID ? std::max(1, threads) : 1;
+    int nodes = params.nodes > 0
+        ? params.nodes
+        : (ranks * threads_per_rank + params.cores_per_node - 1) / params.cores_per_node;
+    nodes = std::max(1, std::min(nodes, ranks));
+    int ranks_per_node = (ranks + nodes - 1) / nodes;
+    double cores_per_rank = std::min(static_cast<double>(threads_per_rank),
+                                     static_cast<double>(params.cores_per_node) / ranks_per_node);
+
+    // Equal split: the largest stripe determines the compute phase
+    double rows = (n + ranks - 1) / ranks;
+    double flops = engine == Engine::STRASSEN_MPI && ranks == 1
+        ? strassen_flops(n)
+        : 2.0 * rows * n * static_cast<double>(n);
+
+    PhaseTimes t;
+    t.compute = flops / (params.gflops_per_core * 1e9 * cores_per_rank);
+    if (ranks > 1) {
+        double bytes = static_cast<double>(n) * n * sizeof(double);
+        t.bcast = 2.0 * bcast_time(bytes, ranks, params);
+        t.gather = allgather_time(bytes, ranks, params);
+    }
+    return t;
+}
+
+void resolve_params(const Config& config, SimParams& params) {
+    if (params.latency <= 0.0 || params.bandwidth <= 0.0) {
+        mpi_bench::CommModel model;
+        const mpi_bench::CommModel::Fit* fit = nullptr;
+        if (!config.comm_model_file.empty() && model.load(config.comm_model_file)) {
+            fit = model.find(mpi_bench::CommOp::SENDRECV, 2);
+            params.measured = model;
+        }
+        if (fit != nullptr && fit->beta > 0.0) {
+            if (params.latency <= 0.0) params.latency = std::max(fit->alpha, 1e-9);
+            if (params.bandwidth <= 0.0) params.bandwidth = 1.0 / fit->beta;
+            params.network_source = "sendrecv fit in " + config.comm_model_file;
+        } else {
+            if (params.latency <= 0.0) params.latency = DEFAULT_LATENCY;
+            if (params.bandwidth <= 0.0) params.bandwidth = DEFAULT_BANDWIDTH;
+            params.network_source = "defaults (no --comm-model)";
+        }
+    }
+    if (params.cores_per_node <= 0) {
+        params.cores_per_node = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (params.gflops_per_core <= 0.0) {
+        params.gflops_per_core = measure_rate(config.matrix_size, config.optimization);
+    }
+    if (params.ranks.empty()) {
+        for (int p = 1; p <= MAX_DEFAULT_RANKS; p *= 2) params.ranks.push_back(p);
+    }
+}
+
+void run(const Config& config) {
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    int n = config.matrix_size;
+    SimParams params;
+    bool ok = true;
+    if (rank == 0) {
+        if (!config.sim_params_file.empty()) {
+            ok = load_params(config.sim_params_file, params);
+        }
+        if (ok) resolve_params(config, params);
+    }
+    MPI_Bcast(&ok, sizeof(bool), MPI_BYTE, 0, MPI_COMM_WORLD);
+    if (!ok) return;
+
+    if (rank == 0) {
+        std::cout << "\n";
+        std::cout << "========================================\n";
+        std::cout << "  Distributed Engine Simulation (" << n << "x" << n << ")\n";
+        std::cout << "========================================\n";
+        std::cout << "Network:         latency " << std::fixed << std::setprecision(2)
+                  << params.latency * 1e6 << " us, bandwidth " << params.bandwidth / 1e9
+                  << " GB/s (" << params.network_source << ")\n";
+        std::cout << "Node:            " << params.cores_per_node << " cores, "
+                  << params.gflops_per_core << " GFLOP/s per core, "
+                  << (params.nodes > 0 ? std::to_string(params.nodes) + " nodes" : "nodes as needed")
+                  << "\n";
+        std::cout << "Hybrid Threads:  " << config.num_threads << " per rank\n";
+        std::cout << "========================================\n";
+        std::cout << "Predicted seconds per phase (slowest rank), speedup vs. 1 rank\n\n";
+        print_header();
+
+        for (Engine engine : ALL_ENGINES) {
+            double baseline = simulate(engine, n, 1, config.num_threads, params).total();
+            for (int p : params.ranks) {
+                print_row(engine_to_string(engine), p,
+                          simulate(engine, n, p, config.num_threads, params), baseline);
+            }
+        }
+    }
+
+    if (size < 2) {
+        if (rank == 0) {
+            std::cout << "\nRun under mpirun -np 2..8 to compare with measured runs\n\n";
+        }
+        return;
+    }
+
+    // Validation against this job: same rank count, actual node count
+    int nodes = count_nodes();
+    if (rank == 0) {
+        std::cout << "\nMeasured vs. predicted at " << size << " ranks on " << nodes
+                  << (nodes == 1 ? " node" : " nodes") << "\n\n";
+        print_header();
+    }
+
+    SimParams local = params;
+    local.nodes = nodes;
+    for (Engine engine : ALL_ENGINES) {
+        PhaseTimes measured = measure(engine, config);
+        if (rank == 0) {
+            double baseline = simulate(engine, n, 1, config.num_threads, local).total();
+            PhaseTimes predicted = simulate(engine, n, size, config.num_threads, local);
+            print_row(engine_to_string(engine) + " (model)", size, predicted, baseline);
+            print_row(engine_to_string(engine) + " (real)", size, measured, baseline);
+            std::cout << std::left << std::setw(22) << "  error" << std::right << std::setw(6) << ""
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(10) << 100.0 * (predicted.bcast - measured.bcast) / std::max(measured.bcast, 1e-12) << "%"
+                      << std::setw(10) << 100.0 * (predicted.compute - measured.compute) / std::max(measured.compute, 1e-12) << "%"
+                      << std::setw(10) << 100.0 * (predicted.gather - measured.gather) / std::max(measured.gather, 1e-12) << "%"
+                      << std::setw(10) << 100.0 * (predicted.total() - measured.total()) / measured.total() << "%\n";
+        }
+    }
+    if (rank == 0) std::cout << "\n";
+}
+
+} // namespace simulator
+} // namespace matmul
@@ -0,0 +1,542 @@
+#include "sparse.hpp"
+#include "algorithms.hpp"
+#include "verification.hpp"
+#include "timer.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace matmul {
+
+namespace {
+
+struct Entry {
+    int row;
+    int col;
+    double value;
+};
+
+// Sort coordinate entries into CSR, summing duplicates
+CsrMatrix from_entries(int rows, int cols, std::vector<Entry>& entries) {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.row != b.row ? a.row < b.row : a.col < b.col;
+    });
+
+    CsrMatrix matrix(rows, cols);
+    matrix.col_idx.reserve(entries.size());
+    matrix.values.reserve(entries.size());
+    for (size_t e = 0; e < entries.size(); ++e) {
+        const Entry& entry = entries[e];
+        if (e > 0 && entry.row == entries[e - 1].row && entry.col == entries[e - 1].col) {
+            matrix.values.back() += entry.value;
+            continue;
+        }
+        matrix.col_idx.push_back(entry.col);
+        matrix.values.push_back(entry.value);
+        matrix.row_ptr[entry.row + 1]++;
+    }
+    for (int i = 0; i < rows; ++i) {
+        matrix.row_ptr[i + 1] += matrix.row_ptr[i];
+    }
+    return matrix;
+}
+
+bool has_suffix(const std::string& str, const std::string& suffix) {
+    return str.size() >= suffix.size() &&
+           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+CsrMatrix CsrMatrix::from_dense(const Matrix& A) {
+    CsrMatrix result(A.rows(), A.cols());
+    for (int i = 0; i < A.rows(); ++i) {
+        for (int j = 0; j < A.cols(); ++j) {
+            if (A(i, j) != 0.0) {
+                result.col_idx.push_back(j);
+                result.values.push_back(A(i, j));
+            }
+        }
+        result.row_ptr[i + 1] = static_cast<int64_t>(result.col_idx.size());
+    }
+    return result;
+}
+
+Matrix CsrMatrix::to_dense() const {
+    Matrix result(rows, cols);
+    for (int i = 0; i < rows; ++i) {
+        for (int64_t p = row_ptr[i]; p < row_ptr[i + 1]; ++p) {
+            result(i, col_idx[p]) = values[p];
+        }
+    }
+    return result;
+}
+
+CsrMatrix CsrMatrix::random(int rows, int cols, int nnz_per_row, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> col_dist(0, cols - 1);
+    std::uniform_real_distribution<double> value_dist(-1.0, 1.0);
+
+    std::vector<Entry> entries;
+    entries.reserve(static_cast<size_t>(rows) * nnz_per_row);
+    for (int i = 0; i < rows; ++i) {
+        for (int e = 0; e < nnz_per_row; ++e) {
+            entries.push_back({i, col_dist(gen), value_dist(gen)});
+        }
+    }
+    return from_entries(rows, cols, entries);
+}
+
+BsrMatrix::BsrMatrix(int rows, int cols, int block)
+    : rows(rows), cols(cols), block(block),
+      block_rows((rows + block - 1) / block), block_cols((cols + block - 1) / block),
+      row_ptr(block_rows + 1, 0) {}
+
+bool BsrMatrix::from_dense(const Matrix& A, int block, double max_density, BsrMatrix& out) {
+    if (block < 1) {
+        throw std::runtime_error("BSR block size must be positive");
+    }
+    BsrMatrix result(A.rows(), A.cols(), block);
+
+    // Pattern first, so a matrix that is too dense is rejected before any copy
+    auto block_nonzero = [&](int I, int J) {
+        int i_end = std::min((I + 1) * block, A.rows());
+        int j_end = std::min((J + 1) * block, A.cols());
+        for (int i = I * block; i < i_end; ++i) {
+            for (int j = J * block; j < j_end; ++j) {
+                if (A(i, j) != 0.0) return true;
+            }
+        }
+        return false;
+    };
+    for (int I = 0; I < result.block_rows; ++I) {
+        for (int J = 0; J < result.block_cols; ++J) {
+            if (block_nonzero(I, J)) result.col_idx.push_back(J);
+        }
+        result.row_ptr[I + 1] = static_cast<int64_t>(result.col_idx.size());
+    }
+    if (result.block_density() > max_density) {
+        return false;
+    }
+
+    result.blocks.assign(result.nnzb() * block * block, 0.0);
+    for (int I = 0; I < result.block_rows; ++I) {
+        for (int64_t p = result.row_ptr[I]; p < result.row_ptr[I + 1]; ++p) {
+            int J = result.col_idx[p];
+            double* dst = result.block_data(p);
+            int i_end = std::min((I + 1) * block, A.rows());
+            int j_end = std::min((J + 1) * block, A.cols());
+            for (int i = I * block; i < i_end; ++i) {
+                for (int j = J * block; j < j_end; ++j) {
+                    dst[(i - I * block) * block + (j - J * block)] = A(i, j);
+                }
+            }
+        }
+    }
+
+    out = std::move(result);
+    return true;
+}
+
+Matrix BsrMatrix::to_dense() const {
+    Matrix result(rows, cols);
+    for (int I = 0; I < block_rows; ++I) {
+        for (int64_t p = row_ptr[I]; p < row_ptr[I + 1]; ++p) {
+            int J = col_idx[p];
+            const double* src = block_data(p);
+            int i_end = std::min((I + 1) * block, rows);
+            int j_end = std::min((J + 1) * block, cols);
+            for (int i = I * block; i < i_end; ++i) {
+                for (int j = J * block; j < j_end; ++j) {
+                    result(i, j) = src[(i - I * block) * block + (j - J * block)];
+                }
+            }
+        }
+    }
+    return result;
+}
+
+bool SparseIO::read_matrix_market(const std::string& filename, CsrMatrix& matrix) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: Cannot open file " << filename << "\n";
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Banner: %%MatrixMarket matrix coordinate <field> <symmetry>
+    size_t line_end = text.find('\n');
+    std::istringstream banner(text.substr(0, line_end));
+    std::string tag, object, format, field, symmetry;
+    banner >> tag >> object >> format >> field >> symmetry;
+    for (std::string* word : {&object, &format, &field, &symmetry}) {
+        std::transform(word->begin(), word->end(), word->begin(), ::tolower);
+    }
+    if (tag != "%%MatrixMarket" || object != "matrix" || format != "coordinate") {
+        std::cerr << "Error: " << filename << " is not a Matrix Market coordinate matrix\n";
+        return false;
+    }
+    bool pattern = field == "pattern";
+    if (!pattern && field != "real" && field != "integer") {
+        std::cerr << "Error: Unsupported Matrix Market field '" << field << "'\n";
+        return false;
+    }
+    bool symmetric = symmetry == "symmetric";
+    bool skew = symmetry == "skew-symmetric";
+    if (!symmetric && !skew && symmetry != "general") {
+        std::cerr << "Error: Unsupported Matrix Market symmetry '" << symmetry << "'\n";
+        return false;
+    }
+
+    // Skip comment lines, then the size line
+    const char* p = text.c_str() + (line_end == std::string::npos ? text.size() : line_end + 1);
+    while (*p == '%' || *p == '\n' || *p == '\r') {
+        while (*p && *p != '\n') ++p;
+        if (*p) ++p;
+    }
+    char* end;
+    long rows = std::strtol(p, &end, 10);
+    long cols = std::strtol(end, &end, 10);
+    long long count = std::strtoll(end, &end, 10);
+    if (end == p || rows <= 0 || cols <= 0 || count < 0 || rows >= INT_MAX || cols >= INT_MAX) {
+        std::cerr << "Error: Invalid Matrix Market size line in " << filename << "\n";
+        return false;
+    }
+    p = end;
+
+    std::vector<Entry> entries;
+    entries.reserve(static_cast<size_t>(count) * (symmetric || skew ? 2 : 1));
+    for (long long e = 0; e < count; ++e) {
+        long i = std::strtol(p, &end, 10);
+        long j = std::strtol(end, &end, 10);
+        double value = 1.0;
+        if (!pattern) {
+            value = std::strtod(end, &end);
+        }
+        if (end == p || i < 1 || i > rows || j < 1 || j > cols) {
+            std::cerr << "Error: Invalid entry " << e + 1 << " in " << filename << "\n";
+            return false;
+        }
+        p = end;
+        entries.push_back({static_cast<int>(i - 1), static_cast<int>(j - 1), value});
+        if ((symmetric || skew) && i != j) {
+            entries.push_back({static_cast<int>(j - 1), static_cast<int>(i - 1), skew ? -value : value});
+        }
+    }
+
+    matrix = from_entries(static_cast<int>(rows), static_cast<int>(cols), entries);
+    return true;
+}
+
+bool SparseIO::write_matrix_market(const std::string& filename, const CsrMatrix& matrix) {
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Cannot create file " << filename << "\n";
+        return false;
+    }
+
+    std::fprintf(file, "%%%%MatrixMarket matrix coordinate real general\n");
+    std::fprintf(file, "%d %d %lld\n", matrix.rows, matrix.cols, static_cast<long long>(matrix.nnz()));
+    for (int i = 0; i < matrix.rows; ++i) {
+        for (int64_t p = matrix.row_ptr[i]; p < matrix.row_ptr[i + 1]; ++p) {
+            std::fprintf(file, "%d %d %.17g\n", i + 1, matrix.col_idx[p] + 1, matrix.values[p]);
+        }
+    }
+
+    bool ok = std::ferror(file) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Failed to write " << filename << "\n";
+    }
+    return ok;
+}
+
+bool SparseIO::read_csr(const std::string& filename, CsrMatrix& matrix) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: Cannot open file " << filename << "\n";
+        return false;
+    }
+
+    char magic[8];
+    int64_t header[3];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || std::memcmp(magic, "MATMULS1", 8) != 0 ||
+        header[0] <= 0 || header[1] <= 0 || header[2] < 0 ||
+        header[0] >= INT_MAX || header[1] >= INT_MAX) {
+        std::cerr << "Error: " << filename << " is not a CSR matrix file\n";
+        return false;
+    }
+
+    CsrMatrix result(static_cast<int>(header[0]), static_cast<int>(header[1]));
+    result.col_idx.resize(header[2]);
+    result.values.resize(header[2]);
+    file.read(reinterpret_cast<char*>(result.row_ptr.data()), result.row_ptr.size() * sizeof(int64_t));
+    file.read(reinterpret_cast<char*>(result.col_idx.data()), result.col_idx.size() * sizeof(int));
+    file.read(reinterpret_cast<char*>(result.values.data()), result.values.size() * sizeof(double));
+    if (!file) {
+        std::cerr << "Error: " << filename << " is truncated\n";
+        return false;
+    }
+
+    // The kernels index through row_ptr and col_idx unchecked
+    bool valid = result.row_ptr.front() == 0 && result.row_ptr.back() == header[2];
+    for (size_t i = 1; valid && i < result.row_ptr.size(); ++i) {
+        valid = result.row_ptr[i - 1] <= result.row_ptr[i];
+    }
+    for (size_t i = 0; valid && i < result.col_idx.size(); ++i) {
+        valid = result.col_idx[i] >= 0 && result.col_idx[i] < result.cols;
+    }
+    if (!valid) {
+        std::cerr << "Error: " << filename << " has inconsistent row pointers or column indices\n";
+        return false;
+    }
+
+    matrix = std::move(result);
+    return true;
+}
+
+bool SparseIO::write_csr(const std::string& filename, const CsrMatrix& matrix) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Error: Cannot create file " << filename << "\n";
+        return false;
+    }
+
+    int64_t header[3] = {matrix.rows, matrix.cols, matrix.nnz()};
+    file.write("MATMULS1", 8);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(matrix.row_ptr.data()), matrix.row_ptr.size() * sizeof(int64_t));
+    file.write(reinterpret_cast<const char*>(matrix.col_idx.data()), matrix.col_idx.size() * sizeof(int));
+    file.write(reinterpret_cast<const char*>(matrix.values.data()), matrix.values.size() * sizeof(double));
+    file.close();
+    if (!file) {
+        std::cerr << "Error: Failed to write " << filename << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool SparseIO::read(const std::string& filename, CsrMatrix& matrix) {
+    return has_suffix(filename, ".csr") ? read_csr(filename, matrix)
+                                        : read_matrix_market(filename, matrix);
+}
+
+bool SparseIO::write(const std::string& filename, const CsrMatrix& matrix) {
+    return has_suffix(filename, ".csr") ? write_csr(filename, matrix)
+                                        : write_matrix_market(filename, matrix);
+}
+
+namespace sparse {
+
+namespace {
+
+// Operands from --sparse-a/--sparse-b; B defaults to A (A * A, e.g. two-hop
+// paths of a graph). Returns false if a file cannot be read or the shapes
+// do not match.
+bool load_operands(const Config& config, CsrMatrix& A, CsrMatrix& B) {
+    std::cout << "Loading A from " << config.sparse_a_file << "...\n";
+    if (!SparseIO::read(config.sparse_a_file, A)) return false;
+    if (!config.sparse_b_file.empty()) {
+        std::cout << "Loading B from " << config.sparse_b_file << "...\n";
+        if (!SparseIO::read(config.sparse_b_file, B)) return false;
+    } else {
+        B = A;
+    }
+    if (A.cols != B.rows) {
+        std::cerr << "Error: A is " << A.rows << "x" << A.cols << " but B is "
+                  << B.rows << "x" << B.cols << "\n";
+        return false;
+    }
+    return true;
+}
+
+// n x n with fill of the block x block blocks nonzero (random values)
+Matrix random_block_sparse(int n, int block, double fill, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+
+    Matrix A(n, n);
+    for (int I = 0; I < n; I += block) {
+        for (int J = 0; J < n; J += block) {
+            if (coin(gen) >= fill) continue;
+            for (int i = I; i < std::min(I + block, n); ++i) {
+                for (int j = J; j < std::min(J + block, n); ++j) {
+                    A(i, j) = value(gen);
+                }
+            }
+        }
+    }
+    return A;
+}
+
+} // namespace
+
+void run_spgemm(const Config& config) {
+    CsrMatrix A, B;
+    int n = config.matrix_size;
+
+    if (!config.sparse_a_file.empty()) {
+        if (!load_operands(config, A, B)) return;
+    } else {
+        A = CsrMatrix::random(n, n, config.nnz_per_row, 1);
+        B = CsrMatrix::random(n, n, config.nnz_per_row, 2);
+    }
+
+    bool threaded = config.mode == ExecutionMode::OPENMP || config.mode == ExecutionMode::HYBRID;
+    int threads = threaded ? config.num_threads : 1;
+
+    spgemm::Stats stats;
+    CsrMatrix C = spgemm::multiply(A, B, threads, &stats);
+    double seconds = stats.symbolic_seconds + stats.numeric_seconds;
+
+    std::cout << "\n========================================\n";
+    std::cout << "     Sparse x Sparse (SpGEMM)           \n";
+    std::cout << "========================================\n";
+    std::cout << std::left;
+    std::cout << std::setw(17) << "A:" << A.rows << "x" << A.cols << ", nnz " << A.nnz() << "\n";
+    std::cout << std::setw(17) << "B:" << B.rows << "x" << B.cols << ", nnz " << B.nnz() << "\n";
+    std::cout << std::setw(17) << "C:" << C.rows << "x" << C.cols << ", nnz " << C.nnz() << "\n";
+    std::cout << std::setw(17) << "Threads:" << threads << "\n";
+    std::cout << std::setw(17) << "Products:" << stats.flops << " (" << std::fixed
+              << std::setprecision(2) << (C.nnz() > 0 ? static_cast<double>(stats.flops) / C.nnz() : 0.0)
+              << " per C nonzero)\n";
+    std::cout << std::setw(17) << "Accumulators:" << stats.hash_rows << " hash rows, "
+              << stats.dense_rows << " dense rows\n";
+    std::cout << "========================================\n";
+    std::cout << std::setw(17) << "Symbolic:" << std::setprecision(6) << stats.symbolic_seconds << " s\n";
+    std::cout << std::setw(17) << "Numeric:" << stats.numeric_seconds << " s\n";
+    std::cout << std::setw(17) << "Total:" << seconds << " s\n";
+    std::cout << std::setw(17) << "Throughput:" << std::setprecision(2)
+              << C.nnz() / seconds / 1e6 << " M nnz(C)/s, "
+              << 2.0 * stats.flops / seconds / 1e9 << " GFLOP/s\n";
+    std::cout << "========================================\n" << std::right;
+
+    if (config.validate_against_openblas) {
+        if (static_cast<double>(A.rows) * A.cols + static_cast<double>(B.rows) * B.cols > 32.0e6) {
+            std::cout << "Validation skipped: dense A and B would exceed 256 MB together\n";
+        } else {
+            Matrix reference = openblas::multiply(A.to_dense(), B.to_dense());
+            bool valid = verification::compare_and_report(C.to_dense(), reference, "SpGEMM", "OpenBLAS",
+                                                          config.abs_tolerance, config.rel_tolerance);
+            std::cout << "Validation Status: "
+                      << (valid ? "\033[32mPASSED\033[0m ✓\n" : "\033[31mFAILED\033[0m ✗\n");
+        }
+    }
+
+    if (!config.sparse_output_file.empty()) {
+        std::cout << "Saving result to " << config.sparse_output_file << "...\n";
+        if (!SparseIO::write(config.sparse_output_file, C)) {
+            std::cerr << "Warning: Failed to save output matrix\n";
+        }
+    }
+}
+
+void run_bsr(const Config& config) {
+    int block = config.bsr_block;
+    Matrix A_dense, B_dense;
+    if (!config.sparse_a_file.empty()) {
+        CsrMatrix A_csr, B_csr;
+        if (!load_operands(config, A_csr, B_csr)) return;
+        A_dense = A_csr.to_dense();
+        B_dense = B_csr.to_dense();
+    } else {
+        A_dense = random_block_sparse(config.matrix_size, block, config.bsr_fill, 1);
+        B_dense = random_block_sparse(config.matrix_size, block, config.bsr_fill, 2);
+    }
+
+    // Dense engines run locally; Sequential/OpenMP as configured
+    Config local = config;
+    if (local.mode == ExecutionMode::MPI) local.mode = ExecutionMode::SEQUENTIAL;
+    if (local.mode == ExecutionMode::HYBRID) local.mode = ExecutionMode::OPENMP;
+    bool threaded = local.mode == ExecutionMode::OPENMP;
+    int threads = threaded ? config.num_threads : 1;
+
+    Timer timer;
+    timer.start();
+    BsrMatrix A, B;
+    bool sparse_enough = BsrMatrix::from_dense(A_dense, block, config.bsr_threshold, A) &&
+                         BsrMatrix::from_dense(B_dense, block, config.bsr_threshold, B);
+    timer.stop();
+    double convert_seconds = timer.elapsed_seconds();
+
+    timer.start();
+    Matrix C_dense = multiply(A_dense, B_dense, local);
+    timer.stop();
+    double dense_seconds = timer.elapsed_seconds();
+    double dense_flops = 2.0 * A_dense.rows() * A_dense.cols() * B_dense.cols();
+
+    std::cout << "\n========================================\n";
+    std::cout << "     Block-Sparse (BSR) Multiply        \n";
+    std::cout << "========================================\n";
+    std::cout << std::left << std::fixed;
+    std::cout << std::setw(17) << "Operands:" << A_dense.rows() << "x" << A_dense.cols() << " * "
+              << B_dense.rows() << "x" << B_dense.cols() << ", " << block << "x" << block << " blocks\n";
+    std::cout << std::setw(17) << "Dense engine:" << algorithm_to_string(local.algorithm) << " / "
+              << mode_to_string(local.mode) << "\n";
+    std::cout << std::setw(17) << "Threads:" << threads << "\n";
+
+    if (!sparse_enough) {
+        std::cout << std::setw(17) << "Conversion:" << "more than " << std::setprecision(0)
+                  << config.bsr_threshold * 100 << "% of blocks nonzero, dense engine used\n";
+        std::cout << std::setw(17) << "Dense:" << std::setprecision(6) << dense_seconds << " s ("
+                  << std::setprecision(2) << dense_flops / dense_seconds / 1e9 << " GFLOP/s)\n";
+        std::cout << "========================================\n" << std::right;
+        return;
+    }
+
+    bsr::Stats stats;
+    BsrMatrix C = bsr::multiply(A, B, threads, &stats);
+    double bsr_seconds = stats.symbolic_seconds + stats.numeric_seconds;
+    double bsr_flops = 2.0 * stats.block_products * block * block * block;
+
+    CsrMatrix A_csr = CsrMatrix::from_dense(A_dense);
+    CsrMatrix B_csr = CsrMatrix::from_dense(B_dense);
+    spgemm::Stats csr_stats;
+    spgemm::multiply(A_csr, B_csr, threads, &csr_stats);
+    double csr_seconds = csr_stats.symbolic_seconds + csr_stats.numeric_seconds;
+
+    std::cout << std::setprecision(1);
+    std::cout << std::setw(17) << "Block density:" << "A " << A.block_density() * 100 << "%, B "
+              << B.block_density() * 100 << "%, C " << C.block_density() * 100 << "% ("
+              << C.nnzb() << " blocks)\n";
+    std::cout << std::setw(17) << "Block products:" << stats.block_products << "\n";
+    std::cout << std::setw(17) << "Conversion:" << std::setprecision(6) << convert_seconds << " s\n";
+    std::cout << "========================================\n";
+
+    auto print_row = [](const std::string& label, double seconds, double flops, double baseline) {
+        std::cout << std::setw(17) << label << std::setprecision(6) << seconds << " s  "
+                  << std::setprecision(2) << std::setw(8) << std::right << flops / seconds / 1e9
+                  << std::left << " GFLOP/s  " << std::setw(8) << std::right << baseline / seconds
+                  << std::left << "x\n";
+    };
+    std::cout << std::setw(17) << "" << "time        useful rate  vs dense\n";
+    print_row("Dense:", dense_seconds, bsr_flops, dense_seconds);
+    print_row("CSR SpGEMM:", csr_seconds, bsr_flops, dense_seconds);
+    print_row("BSR:", bsr_seconds, bsr_flops, dense_seconds);
+    std::cout << std::setw(17) << "BSR phases:" << std::setprecision(6) << stats.symbolic_seconds
+              << " s symbolic, " << stats.numeric_seconds << " s numeric\n";
+    std::cout << "========================================\n" << std::right;
+
+    if (config.validate_against_openblas) {
+        bool valid = verification::compare_and_report(C.to_dense(), C_dense, "BSR", "Dense",
+                                                      config.abs_tolerance, config.rel_tolerance);
+        std::cout << "Validation Status: "
+                  << (valid ? "\033[32mPASSED\033[0m ✓\n" : "\033[31mFAILED\033[0m ✗\n");
+    }
+}
+
+} // namespace sparse
+
+} // namespace matmul
@@ -0,0 +1,332 @@
+#include "stream_io.hpp"
+#include "algorithms.hpp"
+#include "async_io.hpp"
+#include "binary_io.hpp"
+#include "csv_io.hpp"
+#include "timer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace matmul {
+
+namespace {
+
+const char STREAM_MAGIC[8] = {'M', 'A', 'T', 'M', 'U', 'L', 'F', '1'};
+const uint32_t STREAM_VERSION = 1;
+
+// Pipes default to 64 KB; a larger pipe lets the producer and consumer run
+// further apart and halves the number of wakeups per block
+const int PIPE_BYTES = 1 << 20;
+
+void enlarge_pipe(int fd) {
+#ifdef F_SETPIPE_SZ
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode)) {
+        fcntl(fd, F_SETPIPE_SZ, PIPE_BYTES);  // Best effort: capped by /proc/sys/fs/pipe-max-size
+    }
+#else
+    (void)fd;
+#endif
+}
+
+// True when fd has data (or EOF) to deliver without blocking
+bool readable_now(int fd) {
+    struct pollfd p = {fd, POLLIN, 0};
+    return poll(&p, 1, 0) > 0;
+}
+
+// Write every byte of the iovecs, resuming after partial writes and EINTR
+bool write_all(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        size_t left = static_cast<size_t>(n);
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool FrameReader::read_full(void* dst, size_t bytes) {
+    char* p = static_cast<char*>(dst);
+    while (bytes > 0) {
+        ssize_t n = read(fd_, p, bytes);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        bytes -= static_cast<size_t>(n);
+        bytes_ += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+bool FrameReader::open() {
+    // Both formats have a 64-byte header starting with an 8-byte magic
+    char raw[64];
+    static_assert(sizeof(raw) == sizeof(StreamHeader) && sizeof(raw) == sizeof(BinaryMatrixHeader),
+                  "Stream and matrix headers must have the same size");
+    if (!read_full(raw, sizeof(raw))) {
+        std::cerr << "Error: Input stream ended before its header\n";
+        return false;
+    }
+
+    uint32_t header_size = 0;
+    if (std::memcmp(raw, STREAM_MAGIC, sizeof(STREAM_MAGIC)) == 0) {
+        StreamHeader header;
+        std::memcpy(&header, raw, sizeof(header));
+        if (header.version != STREAM_VERSION || header.header_size < sizeof(StreamHeader) ||
+            header.cols <= 0) {
+            std::cerr << "Error: Unsupported stream header\n";
+            return false;
+        }
+        framed_ = true;
+        cols_ = header.cols;
+        header_size = header.header_size;
+    } else {
+        BinaryMatrixHeader header;
+        std::memcpy(&header, raw, sizeof(header));
+        if (!BinaryIO::valid_header(header)) {
+            std::cerr << "Error: Input is neither a frame stream nor a binary matrix\n";
+            return false;
+        }
+        framed_ = false;
+        cols_ = header.cols;
+        rows_ = header.rows;
+        frame_left_ = header.rows;
+        header_size = header.header_size;
+    }
+
+    // Skip header extensions from newer writers
+    char skip[256];
+    for (size_t left = header_size - sizeof(raw); left > 0;) {
+        size_t n = std::min(left, sizeof(skip));
+        if (!read_full(skip, n)) return false;
+        left -= n;
+    }
+    return true;
+}
+
+int FrameReader::read_rows(double* dst, int max_rows) {
+    size_t row_bytes = static_cast<size_t>(cols_) * sizeof(double);
+    int got = 0;
+
+    while (got < max_rows && !done_) {
+        if (frame_left_ == 0) {
+            if (!framed_) {
+                done_ = true;
+                break;
+            }
+            // Only wait for the next frame when the block is still empty
+            if (got > 0 && !readable_now(fd_)) break;
+            int64_t rows;
+            if (!read_full(&rows, sizeof(rows))) {
+                std::cerr << "Error: Input stream ended without an end-of-stream frame\n";
+                return -1;
+            }
+            if (rows < 0) {
+                std::cerr << "Error: Negative frame length in input stream\n";
+                return -1;
+            }
+            if (rows == 0) {
+                done_ = true;
+                break;
+            }
+            frame_left_ = rows;
+        }
+
+        int n = static_cast<int>(std::min<int64_t>(frame_left_, max_rows - got));
+        if (!read_full(dst + static_cast<size_t>(got) * cols_, n * row_bytes)) {
+            std::cerr << "Error: Input stream is truncated\n";
+            return -1;
+        }
+        frame_left_ -= n;
+        got += n;
+    }
+    return got;
+}
+
+bool FrameWriter::begin(int64_t cols, bool framed, int64_t rows) {
+    framed_ = framed;
+    cols_ = cols;
+
+    char raw[64];
+    if (framed) {
+        StreamHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, STREAM_MAGIC, sizeof(header.magic));
+        header.version = STREAM_VERSION;
+        header.header_size = sizeof(StreamHeader);
+        header.cols = cols;
+        std::memcpy(raw, &header, sizeof(raw));
+    } else {
+        BinaryMatrixHeader header = BinaryIO::make_header(static_cast<int>(rows), static_cast<int>(cols));
+        std::memcpy(raw, &header, sizeof(raw));
+    }
+
+    struct iovec iov = {raw, sizeof(raw)};
+    if (!write_all(fd_, &iov, 1)) return false;
+    bytes_ += sizeof(raw);
+    return true;
+}
+
+bool FrameWriter::write_rows(const double* src, int rows) {
+    int64_t frame_rows = rows;
+    size_t data_bytes = static_cast<size_t>(rows) * cols_ * sizeof(double);
+    struct iovec iov[2] = {
+        {&frame_rows, sizeof(frame_rows)},
+        {const_cast<double*>(src), data_bytes},
+    };
+    bool ok = framed_ ? write_all(fd_, iov, 2) : write_all(fd_, iov + 1, 1);
+    if (ok) bytes_ += data_bytes + (framed_ ? sizeof(frame_rows) : 0);
+    return ok;
+}
+
+bool FrameWriter::finish() {
+    if (!framed_) return true;
+    int64_t end = 0;
+    struct iovec iov = {&end, sizeof(end)};
+    if (!write_all(fd_, &iov, 1)) return false;
+    bytes_ += sizeof(end);
+    return true;
+}
+
+namespace stream {
+
+bool run(const Config& config) {
+    Matrix B;
+    const std::string& b_file = config.stream_b_file;
+    bool csv = b_file.size() >= 4 && b_file.compare(b_file.size() - 4, 4, ".csv") == 0;
+    if (!(csv ? CsvIO::read_matrix(b_file, B) : AsyncIO::read_matrix(b_file, B))) {
+        return false;
+    }
+
+    enlarge_pipe(STDIN_FILENO);
+    enlarge_pipe(STDOUT_FILENO);
+
+    FrameReader reader(STDIN_FILENO);
+    if (!reader.open()) return false;
+    if (reader.cols() != B.rows()) {
+        std::cerr << "Error: Stream rows have " << reader.cols() << " columns but B has "
+                  << B.rows() << " rows\n";
+        return false;
+    }
+
+    // Blocks are row stripes of A: the distributed engines would need every
+    // rank on stdin, so run them locally, and Strassen only takes squares
+    Config local = config;
+    if (local.mode == ExecutionMode::MPI) local.mode = ExecutionMode::SEQUENTIAL;
+    if (local.mode == ExecutionMode::HYBRID) local.mode = ExecutionMode::OPENMP;
+    if (local.algorithm == Algorithm::STRASSEN) local.algorithm = Algorithm::NAIVE;
+
+    int k = B.rows();
+    int n = B.cols();
+    int block = config.stream_block;
+    Matrix A_block = Matrix::uninitialized(block, k);
+    Matrix C_block = Matrix::uninitialized(block, n);
+
+    FrameWriter writer(STDOUT_FILENO);
+    if (!writer.begin(n, reader.framed(), reader.rows())) {
+        std::cerr << "Error: Could not write to stdout\n";
+        return false;
+    }
+
+    double read_seconds = 0.0, compute_seconds = 0.0, write_seconds = 0.0;
+    int64_t total_rows = 0;
+    int blocks = 0;
+    Timer total, timer;
+    total.start();
+
+    while (true) {
+        timer.start();
+        int rows = reader.read_rows(A_block.data(), block);
+        timer.stop();
+        read_seconds += timer.elapsed_seconds();
+        if (rows < 0) return false;
+        if (rows == 0) break;
+
+        timer.start();
+        const ConstMatrixView A_rows(A_block.data(), rows, k);
+        Matrix C_rows = Matrix::view(C_block.data(), rows, n);
+        multiply_into(A_rows, B, local, C_rows);
+        timer.stop();
+        compute_seconds += timer.elapsed_seconds();
+
+        timer.start();
+        bool ok = writer.write_rows(C_rows.data(), rows);
+        timer.stop();
+        write_seconds += timer.elapsed_seconds();
+        if (!ok) {
+            std::cerr << "Error: Could not write to stdout\n";
+            return false;
+        }
+
+        total_rows += rows;
+        ++blocks;
+    }
+
+    if (!writer.finish()) {
+        std::cerr << "Error: Could not write to stdout\n";
+        return false;
+    }
+    total.stop();
+
+    if (!reader.framed() && total_rows != reader.rows()) {
+        std::cerr << "Error: Input matrix is truncated\n";
+        return false;
+    }
+
+    double seconds = total.elapsed_seconds();
+    double working_mb = (static_cast<double>(k) * n + static_cast<double>(block) * (k + n)) *
+                        sizeof(double) / (1024.0 * 1024.0);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::cerr << "\nStream: " << total_rows << " rows in " << blocks << " block(s), "
+              << (reader.framed() ? "framed" : "binary matrix") << " input, B is " << k << "x" << n
+              << ", " << algorithm_to_string(local.algorithm) << " / " << mode_to_string(local.mode)
+              << "\n";
+    std::cerr << "========================================\n";
+    std::cerr << std::fixed << std::setprecision(3) << std::left
+              << std::setw(17) << "Read:" << read_seconds << " s, "
+              << reader.bytes() / (1024.0 * 1024.0) << " MB ("
+              << reader.bytes() / (1024.0 * 1024.0) / seconds << " MB/s over the run)\n"
+              << std::setw(17) << "Compute:" << compute_seconds << " s ("
+              << (compute_seconds > 0.0 ? 2.0 * total_rows * k * n / compute_seconds / 1e9 : 0.0)
+              << " GFLOP/s)\n"
+              << std::setw(17) << "Write:" << write_seconds << " s, "
+              << writer.bytes() / (1024.0 * 1024.0) << " MB ("
+              << writer.bytes() / (1024.0 * 1024.0) / seconds << " MB/s over the run)\n"
+              << std::setw(17) << "Total:" << seconds << " s ("
+              << total_rows / seconds << " rows/s)\n"
+              << std::setw(17) << "Working set:" << working_mb
+              << " MB (B plus one block of A and C)\n"
+              << std::setw(17) << "Peak RSS:" << usage.ru_maxrss / 1024.0 << " MB\n"
+              << std::right;
+    std::cerr << "========================================\n";
+    return true;
+}
+
+} // namespace stream
+
+} // namespace matmul
@@ -0,0 +1,358 @@
+#include "tensor.hpp"
+#include "csv_io.hpp"
+#include "timer.hpp"
+#include <omp.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+namespace matmul {
+
+Tensor::Tensor(std::vector<int> shape) : shape_(std::move(shape)) {
+    size_t count = 1;
+    for (int e : shape_) {
+        if (e < 0) throw std::runtime_error("Tensor extents must be non-negative");
+        count *= static_cast<size_t>(e);
+    }
+    data_.assign(count, 0.0);
+}
+
+std::vector<int64_t> Tensor::strides() const {
+    std::vector<int64_t> result(shape_.size(), 1);
+    for (int d = rank() - 2; d >= 0; --d) {
+        result[d] = result[d + 1] * shape_[d + 1];
+    }
+    return result;
+}
+
+double& Tensor::at(const std::vector<int>& index) {
+    size_t offset = 0;
+    for (int d = 0; d < rank(); ++d) offset = offset * shape_[d] + index[d];
+    return data_[offset];
+}
+
+double Tensor::at(const std::vector<int>& index) const {
+    return const_cast<Tensor*>(this)->at(index);
+}
+
+void Tensor::randomize(double min, double max, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dis(min, max);
+    for (double& v : data_) v = dis(gen);
+}
+
+Tensor Tensor::from_matrix(const Matrix& M) {
+    Tensor T({M.rows(), M.cols()});
+    std::copy(M.data(), M.data() + T.count(), T.data());
+    return T;
+}
+
+Matrix Tensor::to_matrix() const {
+    if (rank() != 2) throw std::runtime_error("Only rank-2 tensors convert to a Matrix");
+    Matrix M = Matrix::uninitialized(shape_[0], shape_[1]);
+    std::copy(data_.begin(), data_.end(), M.data());
+    return M;
+}
+
+namespace {
+
+bool has_suffix(const std::string& str, const std::string& suffix) {
+    return str.size() >= suffix.size() &&
+           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+bool TensorIO::read_tensor(const std::string& filename, Tensor& tensor) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: Cannot open file " << filename << "\n";
+        return false;
+    }
+
+    char magic[8];
+    int64_t rank = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&rank), sizeof(rank));
+    if (!file || std::memcmp(magic, "MATMULT1", 8) != 0 || rank < 0 || rank > 64) {
+        std::cerr << "Error: " << filename << " is not a tensor file\n";
+        return false;
+    }
+
+    std::vector<int64_t> extents(rank);
+    file.read(reinterpret_cast<char*>(extents.data()), rank * sizeof(int64_t));
+    std::vector<int> shape;
+    for (int64_t e : extents) {
+        if (e < 0 || e > INT32_MAX) {
+            std::cerr << "Error: " << filename << " has an invalid extent\n";
+            return false;
+        }
+        shape.push_back(static_cast<int>(e));
+    }
+
+    Tensor result(shape);
+    file.read(reinterpret_cast<char*>(result.data()), result.count() * sizeof(double));
+    if (!file) {
+        std::cerr << "Error: " << filename << " is truncated\n";
+        return false;
+    }
+
+    tensor = std::move(result);
+    return true;
+}
+
+bool TensorIO::write_tensor(const std::string& filename, const Tensor& tensor) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Error: Cannot create file " << filename << "\n";
+        return false;
+    }
+
+    int64_t rank = tensor.rank();
+    file.write("MATMULT1", 8);
+    file.write(reinterpret_cast<const char*>(&rank), sizeof(rank));
+    for (int e : tensor.shape()) {
+        int64_t extent = e;
+        file.write(reinterpret_cast<const char*>(&extent), sizeof(extent));
+    }
+    file.write(reinterpret_cast<const char*>(tensor.data()), tensor.count() * sizeof(double));
+    file.close();
+    if (!file) {
+        std::cerr << "Error: Failed to write " << filename << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool TensorIO::read(const std::string& filename, Tensor& tensor) {
+    if (!has_suffix(filename, ".csv")) return read_tensor(filename, tensor);
+    Matrix M;
+    if (!CsvIO::read_matrix(filename, M)) return false;
+    tensor = Tensor::from_matrix(M);
+    return true;
+}
+
+bool TensorIO::write(const std::string& filename, const Tensor& tensor) {
+    if (!has_suffix(filename, ".csv")) return write_tensor(filename, tensor);
+    if (tensor.rank() != 2) {
+        std::cerr << "Error: Only rank-2 tensors can be written as CSV\n";
+        return false;
+    }
+    return CsvIO::write_matrix(filename, tensor.to_matrix());
+}
+
+namespace tensor {
+
+Tensor permute(const Tensor& in, const std::vector<int>& perm, int num_threads) {
+    int rank = in.rank();
+    std::vector<bool> seen(rank, false);
+    if (static_cast<int>(perm.size()) != rank) throw std::runtime_error("Permutation has the wrong rank");
+    for (int p : perm) {
+        if (p < 0 || p >= rank || seen[p]) throw std::runtime_error("Invalid tensor permutation");
+        seen[p] = true;
+    }
+
+    std::vector<int> out_shape(rank);
+    for (int d = 0; d < rank; ++d) out_shape[d] = in.extent(perm[d]);
+    Tensor out(out_shape);
+    if (out.count() == 0) return out;
+
+    // Output indices, outermost first, with their input strides. Extent-1
+    // indices are dropped and neighbours that stay adjacent in the input are
+    // fused, so e.g. "abcd -> cdab" becomes a 2-D transpose.
+    std::vector<int64_t> in_strides = in.strides();
+    std::vector<int64_t> ext, src;
+    for (int d = 0; d < rank; ++d) {
+        int64_t e = out_shape[d];
+        int64_t s = in_strides[perm[d]];
+        if (e == 1) continue;
+        if (!ext.empty() && src.back() == s * e) {
+            ext.back() *= e;
+            src.back() = s;
+        } else {
+            ext.push_back(e);
+            src.push_back(s);
+        }
+    }
+    if (ext.empty()) {
+        out.data()[0] = in.data()[0];
+        return out;
+    }
+
+    int dims = static_cast<int>(ext.size());
+    std::vector<int64_t> dst(dims, 1);
+    for (int d = dims - 2; d >= 0; --d) dst[d] = dst[d + 1] * ext[d + 1];
+
+    const double* ip = in.data();
+    double* op = out.data();
+
+    // The innermost index is contiguous on both sides: copy whole runs
+    if (src[dims - 1] == 1) {
+        int64_t run = ext[dims - 1];
+        int64_t runs = static_cast<int64_t>(out.count()) / run;
+        #pragma omp parallel num_threads(num_threads)
+        {
+            // Each thread decodes the index of its first run once, then steps
+            // it like an odometer
+            int threads = omp_get_num_threads(), id = omp_get_thread_num();
+            int64_t first = runs * id / threads, last = runs * (id + 1) / threads;
+            std::vector<int64_t> index(dims, 0);
+            int64_t offset = 0, rem = first;
+            for (int d = dims - 2; d >= 0; --d) {
+                index[d] = rem % ext[d];
+                offset += index[d] * src[d];
+                rem /= ext[d];
+            }
+            for (int64_t r = first; r < last; ++r) {
+                std::copy(ip + offset, ip + offset + run, op + r * run);
+                for (int d = dims - 2; d >= 0; --d) {
+                    offset += src[d];
+                    if (++index[d] < ext[d]) break;
+                    offset -= index[d] * src[d];
+                    index[d] = 0;
+                }
+            }
+        }
+        return out;
+    }
+
+    // Otherwise transpose index p (unit stride in the input) against index q
+    // (unit stride in the output) in TILE x TILE tiles, so both sides touch
+    // whole cache lines; every other index selects a plane
+    const int TILE = 32;
+    int q = dims - 1;
+    int p = static_cast<int>(std::find(src.begin(), src.end(), 1) - src.begin());
+    int64_t P = ext[p], Q = ext[q];
+    int64_t tiles_p = (P + TILE - 1) / TILE, tiles_q = (Q + TILE - 1) / TILE;
+    int64_t planes = static_cast<int64_t>(out.count()) / (P * Q);
+
+    #pragma omp parallel for schedule(static) num_threads(num_threads)
+    for (int64_t t = 0; t < planes * tiles_p * tiles_q; ++t) {
+        int64_t tq = t % tiles_q;
+        int64_t tp = (t / tiles_q) % tiles_p;
+        int64_t rem = t / (tiles_q * tiles_p);
+
+        int64_t in_base = 0, out_base = 0;
+        for (int d = dims - 1; d >= 0; --d) {
+            if (d == p || d == q) continue;
+            int64_t i = rem % ext[d];
+            rem /= ext[d];
+            in_base += i * src[d];
+            out_base += i * dst[d];
+        }
+
+        int64_t p_end = std::min((tp + 1) * TILE, P), q_end = std::min((tq + 1) * TILE, Q);
+        for (int64_t i = tp * TILE; i < p_end; ++i) {
+            const double* s = ip + in_base + i;
+            double* o = op + out_base + i * dst[p];
+            for (int64_t j = tq * TILE; j < q_end; ++j) {
+                o[j] = s[j * src[q]];
+            }
+        }
+    }
+    return out;
+}
+
+namespace {
+
+std::string shape_string(const Tensor& T) {
+    std::string s;
+    for (int d = 0; d < T.rank(); ++d) s += (d ? "x" : "") + std::to_string(T.extent(d));
+    return s.empty() ? "scalar" : s;
+}
+
+} // namespace
+
+void run_einsum(const Config& config) {
+    std::string spec = config.einsum;
+    size_t comma = spec.find(',');
+    size_t arrow = spec.find("->");
+    if (comma == std::string::npos || arrow == std::string::npos || comma > arrow) {
+        throw std::runtime_error("--einsum expects a spec like \"ab,bc->ac\"");
+    }
+
+    Tensor A, B;
+    if (!config.tensor_a_file.empty()) {
+        if (!TensorIO::read(config.tensor_a_file, A)) return;
+        if (config.tensor_b_file.empty()) {
+            B = A;
+        } else if (!TensorIO::read(config.tensor_b_file, B)) {
+            return;
+        }
+    } else {
+        // Random operands, every index of extent --tensor-extent
+        auto letters = [](const std::string& term) {
+            int count = 0;
+            for (char c : term) count += std::isalpha(static_cast<unsigned char>(c)) ? 1 : 0;
+            return count;
+        };
+        A = Tensor(std::vector<int>(letters(spec.substr(0, comma)), config.tensor_extent));
+        B = Tensor(std::vector<int>(letters(spec.substr(comma + 1, arrow - comma - 1)), config.tensor_extent));
+        A.randomize(-1.0, 1.0, 1);
+        B.randomize(-1.0, 1.0, 2);
+    }
+
+    std::cout << "\nTensor contraction " << spec << "\n";
+    std::cout << "  A:               " << shape_string(A) << "\n";
+    std::cout << "  B:               " << shape_string(B) << "\n";
+
+    // TTGT always applies; batched only when no operand has to move
+    Tensor result;
+    for (Strategy strategy : {Strategy::TTGT, Strategy::BATCHED}) {
+        const char* label = strategy == Strategy::TTGT ? "TTGT" : "Batched";
+        Stats stats;
+        Tensor C;
+        Timer timer;
+        try {
+            contract(spec, A, B, config, strategy);  // Warm up
+            timer.start();
+            C = contract(spec, A, B, config, strategy, &stats);
+            timer.stop();
+        } catch (const std::runtime_error& e) {
+            if (strategy == Strategy::TTGT) throw;
+            std::cout << "\n" << label << ": not applicable (" << e.what() << ")\n";
+            continue;
+        }
+
+        const Plan& plan = stats.plan;
+        double flops = 2.0 * plan.batch_size * plan.m_size * plan.n_size * plan.k_size;
+        double seconds = timer.elapsed_seconds();
+        std::cout << "\n" << label << ": " << plan.describe() << "\n"
+                  << std::fixed << std::setprecision(6)
+                  << "  Permutations:    " << stats.permute_seconds << " s\n"
+                  << "  GEMM:            " << stats.gemm_seconds << " s\n"
+                  << "  Total:           " << seconds << " s (" << std::setprecision(2)
+                  << flops / seconds / 1e9 << " GFLOP/s)\n";
+        if (strategy == Strategy::TTGT) result = std::move(C);
+    }
+
+    std::cout << "\nResult:            " << shape_string(result) << "\n";
+    if (config.validate_against_openblas) {
+        Tensor reference = contract_reference(spec, A, B);
+        double diff = 0.0, scale = 0.0;
+        for (size_t i = 0; i < reference.count(); ++i) {
+            diff = std::max(diff, std::fabs(result.data()[i] - reference.data()[i]));
+            scale = std::max(scale, std::fabs(reference.data()[i]));
+        }
+        double error = scale > 0.0 ? diff / scale : diff;
+        std::cout << "Validation:        " << std::scientific << std::setprecision(2) << error
+                  << " relative to direct loops, " << (error < config.rel_tolerance ? "PASSED" : "FAILED")
+                  << std::fixed << "\n";
+    }
+
+    if (!config.tensor_output_file.empty()) {
+        if (TensorIO::write(config.tensor_output_file, result)) {
+            std::cout << "Saved result to " << config.tensor_output_file << "\n";
+        }
+    }
+}
+
+} // namespace tensor
+} // namespace matmul
@@ -1,32 +1,119 @@
 #include "timer.hpp"
 #include <sstream>
 #include <iomanip>
+#include <mutex>
+#include <algorithm>
+#include <ctime>
+
+#ifdef MATMUL_HAVE_TSC
+#include <cpuid.h>
+#endif
 
 namespace matmul {
 
-Timer::Timer() : is_running_(false) {}
+namespace {
+
+#ifdef MATMUL_HAVE_TSC
+// CPUID.80000007H:EDX[8]: the TSC runs at a constant rate in all P/C-states
+bool has_invariant_tsc() {
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+}
+#endif
+
+#ifdef CLOCK_MONOTONIC_RAW
+uint64_t raw_nanoseconds() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+#endif
+
+// Registry of live phases; leaked so phases destroyed at exit can still unregister
+struct Registry {
+    std::mutex mutex;
+    std::vector<PhaseAccumulator*> phases;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+} // namespace
+
+const CycleClock::Calibration& CycleClock::calibration() {
+    static const Calibration cal = [] {
+        Calibration c{false, 1e-9};
+#if defined(MATMUL_HAVE_TSC) && defined(CLOCK_MONOTONIC_RAW)
+        if (has_invariant_tsc()) {
+            // Spin ~20 ms against the unslewed clock; of three windows keep
+            // the one whose closing TSC read was bracketed most tightly
+            double best = 0.0;
+            uint64_t best_bracket = UINT64_MAX;
+            for (int attempt = 0; attempt < 3; ++attempt) {
+                unsigned int aux;
+                uint64_t ns0 = raw_nanoseconds();
+                uint64_t t0 = __rdtscp(&aux);
+                uint64_t ns1 = ns0;
+                while (ns1 - ns0 < 20000000ull) {
+                    ns1 = raw_nanoseconds();
+                }
+                uint64_t t1 = __rdtscp(&aux);
+                uint64_t ns2 = raw_nanoseconds();
+                if (t1 > t0 && ns2 - ns1 < best_bracket) {
+                    best_bracket = ns2 - ns1;
+                    best = (static_cast<double>(ns1 - ns0) + 0.5 * (ns2 - ns1)) * 1e-9
+                           / static_cast<double>(t1 - t0);
+                }
+            }
+            if (best > 0.0) {
+                c.tsc = true;
+                c.seconds_per_tick = best;
+            }
+        }
+#endif
+        return c;
+    }();
+    return cal;
+}
+
+std::string CycleClock::description() {
+    std::ostringstream oss;
+    if (uses_tsc()) {
+        oss << "TSC " << std::fixed << std::setprecision(3)
+            << 1e-9 / seconds_per_tick() << " GHz (invariant)";
+    } else {
+        oss << "steady_clock (no invariant TSC)";
+    }
+    return oss.str();
+}
+
+Timer::Timer() : start_ticks_(0), stop_ticks_(0), is_running_(false) {}
 
 void Timer::start() {
-    start_time_ = Clock::now();
+    start_ticks_ = CycleClock::now();
     is_running_ = true;
 }
 
 void Timer::stop() {
-    stop_time_ = Clock::now();
+    stop_ticks_ = CycleClock::now();
     is_running_ = false;
 }
 
 void Timer::reset() {
-    start_time_ = TimePoint();
-    stop_time_ = TimePoint();
+    start_ticks_ = 0;
+    stop_ticks_ = 0;
     is_running_ = false;
 }
 
 double Timer::elapsed_seconds() const {
-    TimePoint end_time = is_running_ ? Clock::now() : stop_time_;
-    auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(
-        end_time - start_time_);
-    return duration.count();
+    uint64_t end_ticks = is_running_ ? CycleClock::now() : stop_ticks_;
+    return static_cast<double>(end_ticks - start_ticks_) * CycleClock::seconds_per_tick();
 }
 
 double Timer::elapsed_milliseconds() const {
@@ -61,4 +148,72 @@ std::string Timer::elapsed_string() const {
     return oss.str();
 }
 
+PhaseAccumulator::PhaseAccumulator(const std::string& name)
+    : name_(name), slots_(new Slot[MAX_THREADS]) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.phases.push_back(this);
+}
+
+PhaseAccumulator::~PhaseAccumulator() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.phases.erase(std::remove(reg.phases.begin(), reg.phases.end(), this), reg.phases.end());
+}
+
+int PhaseAccumulator::thread_slot() {
+    // Threads beyond MAX_THREADS share slots; their sums may then lose updates
+    static std::atomic<int> next_slot{0};
+    thread_local int slot = next_slot.fetch_add(1, std::memory_order_relaxed) % MAX_THREADS;
+    return slot;
+}
+
+double PhaseAccumulator::seconds() const {
+    uint64_t ticks = 0;
+    for (int i = 0; i < MAX_THREADS; ++i) {
+        ticks += slots_[i].ticks.load(std::memory_order_relaxed);
+    }
+    return static_cast<double>(ticks) * CycleClock::seconds_per_tick();
+}
+
+uint64_t PhaseAccumulator::calls() const {
+    uint64_t calls = 0;
+    for (int i = 0; i < MAX_THREADS; ++i) {
+        calls += slots_[i].calls.load(std::memory_order_relaxed);
+    }
+    return calls;
+}
+
+void PhaseAccumulator::reset() {
+    for (int i = 0; i < MAX_THREADS; ++i) {
+        slots_[i].ticks.store(0, std::memory_order_relaxed);
+        slots_[i].calls.store(0, std::memory_order_relaxed);
+    }
+}
+
+namespace phases {
+
+void reset_all() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (PhaseAccumulator* phase : reg.phases) {
+        phase->reset();
+    }
+}
+
+std::vector<PhaseTotal> totals() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::vector<PhaseTotal> result;
+    for (const PhaseAccumulator* phase : reg.phases) {
+        uint64_t calls = phase->calls();
+        if (calls > 0) {
+            result.push_back({phase->name(), phase->seconds(), calls});
+        }
+    }
+    return result;
+}
+
+} // namespace phases
+
 } // namespace matmul
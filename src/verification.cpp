@@ -1,8 +1,13 @@
 #include "verification.hpp"
 #include "algorithms.hpp"
+#include "partition.hpp"
 #include "timer.hpp"
+#include <mpi.h>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
+#include <random>
 #include <sstream>
 
 namespace matmul {
@@ -52,7 +57,11 @@ void print_comparison_report(const ComparisonResult& result,
     if (result.worst_row >= 0) {
         std::cout << "----------------------------------------\n";
         std::cout << "Worst Error Location:\n";
-        std::cout << "  Position:      [" << result.worst_row << ", " << result.worst_col << "]\n";
+        if (result.worst_col >= 0) {
+            std::cout << "  Position:      [" << result.worst_row << ", " << result.worst_col << "]\n";
+        } else {
+            std::cout << "  Row:           " << result.worst_row << "\n";
+        }
         std::cout << "  " << label1 << ":  " << std::scientific << std::setprecision(10)
                   << result.worst_value_this << "\n";
         std::cout << "  " << label2 << ":  " << std::scientific << std::setprecision(10)
@@ -83,6 +92,225 @@ bool validate_against_reference(const Matrix& result,
     return cmp.all_close;
 }
 
+namespace {
+
+// ComparisonResult as sums, so partial results from ranks can be added
+struct PartialComparison {
+    double sum_abs;
+    double sum_rel;
+    double sum_squared;
+    double max_abs;
+    double max_rel;
+    double worst_this;
+    double worst_other;
+    int64_t elements;
+    int64_t failures;
+    int32_t worst_row;      // Global row (-1: no elements)
+    int32_t worst_col;      // -1 for check-vector rows
+    int32_t mismatch;       // Nonzero if some rank's shapes disagreed
+    int32_t padding;
+};
+
+PartialComparison to_partial(const ComparisonResult& r, int row_offset) {
+    PartialComparison p;
+    p.sum_abs = r.mean_abs_error * r.num_elements;
+    p.sum_rel = r.mean_rel_error * r.num_elements;
+    p.sum_squared = r.rms_error * r.rms_error * r.num_elements;
+    p.max_abs = r.max_abs_error;
+    p.max_rel = r.max_rel_error;
+    p.worst_this = r.worst_value_this;
+    p.worst_other = r.worst_value_other;
+    p.elements = r.num_elements;
+    p.failures = r.num_failures;
+    p.worst_row = r.worst_row >= 0 ? r.worst_row + row_offset : -1;
+    p.worst_col = r.worst_col;
+    p.mismatch = (r.num_elements == 0 && !r.all_close) ? 1 : 0;
+    p.padding = 0;
+    return p;
+}
+
+// MPI_Op: sums and counts add, the larger max_abs keeps its location
+// (the lower row on ties, so the result does not depend on rank order)
+void combine_partials(void* in, void* inout, int* len, MPI_Datatype*) {
+    const PartialComparison* a = static_cast<const PartialComparison*>(in);
+    PartialComparison* b = static_cast<PartialComparison*>(inout);
+    for (int i = 0; i < *len; ++i) {
+        bool take = a[i].worst_row >= 0 &&
+                    (b[i].worst_row < 0 || a[i].max_abs > b[i].max_abs ||
+                     (a[i].max_abs == b[i].max_abs && a[i].worst_row < b[i].worst_row));
+        if (take) {
+            b[i].max_abs = a[i].max_abs;
+            b[i].worst_this = a[i].worst_this;
+            b[i].worst_other = a[i].worst_other;
+            b[i].worst_row = a[i].worst_row;
+            b[i].worst_col = a[i].worst_col;
+        }
+        b[i].sum_abs += a[i].sum_abs;
+        b[i].sum_rel += a[i].sum_rel;
+        b[i].sum_squared += a[i].sum_squared;
+        b[i].max_rel = std::max(b[i].max_rel, a[i].max_rel);
+        b[i].elements += a[i].elements;
+        b[i].failures += a[i].failures;
+        b[i].mismatch |= a[i].mismatch;
+    }
+}
+
+// Rows [row_begin, row_end) of C checked with x: (C x)_i against (A y)_i,
+// y = B x. The tolerance scales with sum_j |C_ij x_j|, the size of the terms
+// that cancel in the row sum.
+ComparisonResult check_vector_rows(const Matrix& C, const Matrix& A, const std::vector<double>& x,
+                                   const std::vector<double>& y, int row_begin, int row_end,
+                                   double abs_tol, double rel_tol) {
+    ComparisonResult r = ComparisonResult();
+    r.abs_tolerance = abs_tol;
+    r.rel_tolerance = rel_tol;
+    r.worst_row = -1;
+    r.worst_col = -1;
+    r.all_close = true;
+
+    double sum_abs = 0.0, sum_rel = 0.0, sum_squared = 0.0;
+    for (int i = row_begin; i < row_end; ++i) {
+        double cx = 0.0, c_scale = 0.0;
+        for (int j = 0; j < C.cols(); ++j) {
+            double t = C(i, j) * x[j];
+            cx += t;
+            c_scale += std::abs(t);
+        }
+        double ay = 0.0, a_scale = 0.0;
+        for (int p = 0; p < A.cols(); ++p) {
+            double t = A(i, p) * y[p];
+            ay += t;
+            a_scale += std::abs(t);
+        }
+
+        double abs_error = std::abs(cx - ay);
+        double scale = std::max(c_scale, a_scale);
+        double rel_error = scale > 0.0 ? abs_error / scale : 0.0;
+        if (abs_error > std::max(abs_tol, rel_tol * scale)) {
+            r.all_close = false;
+            r.num_failures++;
+        }
+        sum_abs += abs_error;
+        sum_rel += rel_error;
+        sum_squared += abs_error * abs_error;
+        if (r.worst_row < 0 || abs_error > r.max_abs_error) {
+            r.max_abs_error = abs_error;
+            r.worst_row = i - row_begin;
+            r.worst_value_this = cx;
+            r.worst_value_other = ay;
+        }
+        r.max_rel_error = std::max(r.max_rel_error, rel_error);
+    }
+
+    r.num_elements = row_end - row_begin;
+    if (r.num_elements > 0) {
+        r.mean_abs_error = sum_abs / r.num_elements;
+        r.mean_rel_error = sum_rel / r.num_elements;
+        r.rms_error = std::sqrt(sum_squared / r.num_elements);
+        r.failure_rate = (100.0 * r.num_failures) / r.num_elements;
+    }
+    return r;
+}
+
+} // namespace
+
+bool validate_distributed(const Matrix& C,
+                          const Matrix& A,
+                          const Matrix& B,
+                          const Config& config,
+                          int rank,
+                          int size) {
+    int m = A.rows();
+    int k = A.cols();
+    partition::RowPartition part = partition::equal(m, size);
+    int row_begin = part.row_offset(rank);
+    int row_end = row_begin + part.local_rows(rank);
+    bool vector = config.dist_validation == DistValidation::VECTOR;
+
+    if (rank == 0) {
+        std::cout << "\nValidating " << (vector ? "with a check vector" : "against OpenBLAS stripes")
+                  << " on " << size << " rank(s)...\n";
+    }
+
+    Timer timer;
+    timer.start();
+
+    ComparisonResult local;
+    bool shapes_ok = C.rows() == m && C.cols() == B.cols() && B.rows() == k;
+    if (!shapes_ok) {
+        local = ComparisonResult();
+        local.all_close = false;
+        local.worst_row = -1;
+    } else if (vector) {
+        // Same x on every rank; y = B x is O(k n), the stripe check O(rows (k + n))
+        std::vector<double> x(B.cols());
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> dist(0.5, 1.5);
+        for (double& v : x) v = dist(rng);
+        std::vector<double> y(k, 0.0);
+        for (int p = 0; p < k; ++p) {
+            for (int j = 0; j < B.cols(); ++j) y[p] += B(p, j) * x[j];
+        }
+        local = check_vector_rows(C, A, x, y, row_begin, row_end, config.abs_tolerance,
+                                  config.rel_tolerance);
+    } else {
+        // Views of this rank's rows; only the stripe's reference is computed
+        int rows = row_end - row_begin;
+        const ConstMatrixView A_rows(A.data() + static_cast<size_t>(row_begin) * k, rows, k);
+        const ConstMatrixView C_rows(C.data() + static_cast<size_t>(row_begin) * C.cols(), rows, C.cols());
+        Matrix reference = rows > 0 ? openblas::multiply(A_rows, B) : Matrix::uninitialized(0, B.cols());
+        local = C_rows.matrix().compare(reference, config.abs_tolerance, config.rel_tolerance);
+    }
+    PartialComparison partial = to_partial(local, row_begin);
+    if (!shapes_ok) partial.mismatch = 1;
+
+    timer.stop();
+    double seconds = timer.elapsed_seconds();
+
+    MPI_Datatype type;
+    MPI_Type_contiguous(sizeof(PartialComparison), MPI_BYTE, &type);
+    MPI_Type_commit(&type);
+    MPI_Op op;
+    MPI_Op_create(&combine_partials, 1, &op);
+    PartialComparison total;
+    MPI_Allreduce(&partial, &total, 1, type, op, MPI_COMM_WORLD);
+    MPI_Op_free(&op);
+    MPI_Type_free(&type);
+
+    double slowest = 0.0;
+    MPI_Reduce(&seconds, &slowest, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    ComparisonResult result = ComparisonResult();
+    result.abs_tolerance = config.abs_tolerance;
+    result.rel_tolerance = config.rel_tolerance;
+    result.num_elements = static_cast<int>(total.elements);
+    result.num_failures = static_cast<int>(total.failures);
+    if (total.elements > 0) {
+        result.mean_abs_error = total.sum_abs / total.elements;
+        result.mean_rel_error = total.sum_rel / total.elements;
+        result.rms_error = std::sqrt(total.sum_squared / total.elements);
+        result.failure_rate = (100.0 * total.failures) / total.elements;
+    }
+    result.max_abs_error = total.max_abs;
+    result.max_rel_error = total.max_rel;
+    result.worst_row = total.worst_row;
+    result.worst_col = total.worst_col;
+    result.worst_value_this = total.worst_this;
+    result.worst_value_other = total.worst_other;
+    result.all_close = total.mismatch == 0 && total.failures == 0;
+
+    if (rank == 0) {
+        if (total.mismatch != 0) {
+            std::cerr << "Error: Result has the wrong dimensions on some rank\n";
+        }
+        print_comparison_report(result, algorithm_to_string(config.algorithm),
+                                vector ? "A (B x) rows" : "OpenBLAS stripes");
+        std::cout << "Validation time: " << std::fixed << std::setprecision(6) << slowest
+                  << " s (slowest rank, " << part.local_rows(0) << " rows on rank 0)\n";
+    }
+    return result.all_close;
+}
+
 void run_verification_suite(const Matrix& A,
                            const Matrix& B,
                            const Config& config,
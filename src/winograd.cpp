@@ -0,0 +1,153 @@
+#include "winograd.hpp"
+#include "algorithms.hpp"
+#include "timer.hpp"
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace matmul {
+namespace winograd {
+
+namespace {
+
+// Naive C = A * B with the same tiling and vectorized row updates as
+// multiply(), so a comparison isolates the scheme from the memory layout
+template <typename T>
+void naive_tiled(int m, int k, int n, const T* A, const T* B, T* C, int num_threads) {
+    const int ROW_BLOCK = 64, COL_BLOCK = 256, K_BLOCK = 128;
+
+    #pragma omp parallel for collapse(2) schedule(dynamic) num_threads(num_threads)
+    for (int ib = 0; ib < m; ib += ROW_BLOCK) {
+        for (int cb = 0; cb < n; cb += COL_BLOCK) {
+            int i_max = std::min(ib + ROW_BLOCK, m);
+            int c_max = std::min(cb + COL_BLOCK, n);
+            for (int i = ib; i < i_max; ++i) {
+                std::fill(C + static_cast<size_t>(i) * n + cb, C + static_cast<size_t>(i) * n + c_max, T());
+            }
+            for (int kb = 0; kb < k; kb += K_BLOCK) {
+                int k_max = std::min(kb + K_BLOCK, k);
+                for (int i = ib; i < i_max; ++i) {
+                    T* c_row = C + static_cast<size_t>(i) * n;
+                    for (int p = kb; p < k_max; ++p) {
+                        T a = A[static_cast<size_t>(i) * k + p];
+                        const T* b = B + static_cast<size_t>(p) * n;
+                        #pragma omp simd
+                        for (int c = cb; c < c_max; ++c) {
+                            c_row[c] += a * b[c];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Best of two runs (the first also warms the caches and the thread pool)
+template <typename F>
+double time_best(F&& run) {
+    double best = 0.0;
+    for (int rep = 0; rep < 2; ++rep) {
+        Timer timer;
+        timer.start();
+        run();
+        timer.stop();
+        if (rep == 0 || timer.elapsed_seconds() < best) best = timer.elapsed_seconds();
+    }
+    return best;
+}
+
+void print_header(const std::string& title) {
+    std::cout << "\n" << title << "\n";
+    std::cout << std::left << std::setw(22) << "  Kernel" << std::right << std::setw(12) << "Time (s)"
+              << std::setw(14) << "Mults (G)" << std::setw(10) << "Speedup" << std::setw(16) << "Check" << "\n";
+    std::cout << "  " << std::string(72, '-') << "\n";
+}
+
+void print_row(const std::string& name, double seconds, double baseline, int64_t mults,
+               const std::string& check) {
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::fixed
+              << std::setprecision(4) << std::setw(12) << seconds << std::setprecision(2)
+              << std::setw(14) << mults / 1e9 << std::setw(9) << baseline / seconds << "x"
+              << std::setw(16) << check << "\n";
+}
+
+// Times naive_tiled against the scheme for element type T; exact types must
+// agree bit for bit
+template <typename T, typename Gen>
+void run_exact(const std::string& title, int N, int threads, Gen&& gen) {
+    size_t count = static_cast<size_t>(N) * N;
+    std::vector<T> A(count), B(count), C_naive(count), C_wino(count);
+    for (size_t i = 0; i < count; ++i) A[i] = gen();
+    for (size_t i = 0; i < count; ++i) B[i] = gen();
+
+    double naive_seconds = time_best([&] { naive_tiled(N, N, N, A.data(), B.data(), C_naive.data(), threads); });
+    double wino_seconds = time_best([&] { multiply(N, N, N, A.data(), B.data(), C_wino.data(), threads); });
+    bool equal = std::equal(C_naive.begin(), C_naive.end(), C_wino.begin());
+
+    print_header(title);
+    print_row("Naive (tiled)", naive_seconds, naive_seconds, static_cast<int64_t>(count) * N, "-");
+    print_row("Winograd", wino_seconds, naive_seconds, multiplications(N, N, N),
+              equal ? "exact" : "MISMATCH");
+}
+
+} // namespace
+
+void run_benchmark(const Config& config) {
+    int N = config.matrix_size;
+    bool parallel = config.mode == ExecutionMode::OPENMP || config.mode == ExecutionMode::HYBRID;
+    int threads = parallel ? config.num_threads : 1;
+
+    std::cout << "\nWinograd inner-product scheme, " << N << "x" << N << ", " << threads << " thread(s)\n";
+
+    // Double: also against the naive engine as configured (-c/-b apply)
+    {
+        Matrix A(N, N), B(N, N);
+        A.randomize(-1.0, 1.0);
+        B.randomize(-1.0, 1.0);
+        size_t count = static_cast<size_t>(N) * N;
+
+        Matrix C_engine, C_wino;
+        Matrix C_tiled(N, N);
+        double engine_seconds = time_best([&] {
+            C_engine = parallel ? naive::openmp(A, B, config.optimization, threads)
+                                : naive::sequential(A, B, config.optimization);
+        });
+        double tiled_seconds = time_best([&] {
+            naive_tiled(N, N, N, A.data(), B.data(), C_tiled.data(), threads);
+        });
+        double wino_seconds = time_best([&] { C_wino = openmp(A, B, threads); });
+
+        double diff = 0.0, scale = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            diff = std::max(diff, std::fabs(C_wino.data()[i] - C_engine.data()[i]));
+            scale = std::max(scale, std::fabs(C_engine.data()[i]));
+        }
+        std::ostringstream error;
+        error << std::scientific << std::setprecision(1) << (scale > 0.0 ? diff / scale : diff) << " rel";
+
+        print_header("double (FMA: a multiply and an add cost the same)");
+        int64_t naive_mults = static_cast<int64_t>(count) * N;
+        print_row(parallel ? "naive::openmp" : "naive::sequential", engine_seconds, engine_seconds,
+                  naive_mults, "-");
+        print_row("Naive (tiled)", tiled_seconds, engine_seconds, naive_mults, "-");
+        print_row("Winograd", wino_seconds, engine_seconds, multiplications(N, N, N), error.str());
+    }
+
+    std::mt19937_64 rng(42);
+
+    // int64: entries small enough that no sum overflows
+    std::uniform_int_distribution<int64_t> small(-1000, 1000);
+    run_exact<int64_t>("int64", N, threads, [&] { return small(rng); });
+
+    std::uniform_int_distribution<uint32_t> residue(0, Modular::P - 1);
+    run_exact<Modular>("mod 998244353 (a product is a 64-bit multiply and a reduction)", N, threads,
+                       [&] { return Modular(residue(rng)); });
+}
+
+} // namespace winograd
+} // namespace matmul
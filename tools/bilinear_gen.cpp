@@ -0,0 +1,498 @@
+// Generates recursive C++ implementations of the fast bilinear matrix
+// multiplication schemes in a catalog file (see algo/schemes/catalog.txt).
+//
+//   bilinear_gen <catalog> <output.cpp>
+//
+// Every scheme is checked against the Brent equations. Additions are
+// reduced by greedy common subexpression elimination: the pair of operands
+// that appears with the same coefficient ratio in the most linear
+// combinations becomes a shared temporary, until no pair repeats.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using Row = std::vector<double>;
+using Table = std::vector<Row>;
+
+struct Scheme {
+    std::string name;
+    int m = 0, k = 0, n = 0, rank = 0;
+    Table U;  // rank x (m*k)
+    Table V;  // rank x (k*n)
+    Table W;  // (m*n) x rank
+};
+
+// ---- Construction ---------------------------------------------------------
+
+Scheme classical(const std::string& name, int m, int k, int n) {
+    Scheme s{name, m, k, n, m * k * n, {}, {}, {}};
+    s.W.assign(m * n, Row(s.rank, 0.0));
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j) {
+            for (int p = 0; p < k; ++p) {
+                int r = (i * n + j) * k + p;
+                Row u(m * k, 0.0), v(k * n, 0.0);
+                u[i * k + p] = 1.0;
+                v[p * n + j] = 1.0;
+                s.U.push_back(u);
+                s.V.push_back(v);
+                s.W[i * n + j][r] = 1.0;
+            }
+        }
+    }
+    return s;
+}
+
+// Kronecker product: the outer scheme's blocks are split again by the inner one
+Scheme product(const std::string& name, const Scheme& x, const Scheme& y) {
+    Scheme s{name, x.m * y.m, x.k * y.k, x.n * y.n, x.rank * y.rank, {}, {}, {}};
+    auto index = [](int i1, int i2, int j1, int j2, int rows2, int cols1, int cols2) {
+        return (i1 * rows2 + i2) * (cols1 * cols2) + (j1 * cols2 + j2);
+    };
+    for (int r1 = 0; r1 < x.rank; ++r1) {
+        for (int r2 = 0; r2 < y.rank; ++r2) {
+            Row u(s.m * s.k, 0.0), v(s.k * s.n, 0.0);
+            for (int i1 = 0; i1 < x.m; ++i1)
+                for (int p1 = 0; p1 < x.k; ++p1)
+                    for (int i2 = 0; i2 < y.m; ++i2)
+                        for (int p2 = 0; p2 < y.k; ++p2)
+                            u[index(i1, i2, p1, p2, y.m, x.k, y.k)] =
+                                x.U[r1][i1 * x.k + p1] * y.U[r2][i2 * y.k + p2];
+            for (int p1 = 0; p1 < x.k; ++p1)
+                for (int j1 = 0; j1 < x.n; ++j1)
+                    for (int p2 = 0; p2 < y.k; ++p2)
+                        for (int j2 = 0; j2 < y.n; ++j2)
+                            v[index(p1, p2, j1, j2, y.k, x.n, y.n)] =
+                                x.V[r1][p1 * x.n + j1] * y.V[r2][p2 * y.n + j2];
+            s.U.push_back(u);
+            s.V.push_back(v);
+        }
+    }
+    s.W.assign(s.m * s.n, Row(s.rank, 0.0));
+    for (int i1 = 0; i1 < x.m; ++i1)
+        for (int j1 = 0; j1 < x.n; ++j1)
+            for (int i2 = 0; i2 < y.m; ++i2)
+                for (int j2 = 0; j2 < y.n; ++j2)
+                    for (int r1 = 0; r1 < x.rank; ++r1)
+                        for (int r2 = 0; r2 < y.rank; ++r2)
+                            s.W[index(i1, i2, j1, j2, y.m, x.n, y.n)][r1 * y.rank + r2] =
+                                x.W[i1 * x.n + j1][r1] * y.W[i2 * y.n + j2][r2];
+    return s;
+}
+
+// x and y side by side along dimension 'm', 'k' or 'n'
+Scheme direct_sum(const std::string& name, char dim, const Scheme& x, const Scheme& y) {
+    Scheme s{name, x.m, x.k, x.n, x.rank + y.rank, {}, {}, {}};
+    if (dim == 'm') s.m += y.m;
+    if (dim == 'k') s.k += y.k;
+    if (dim == 'n') s.n += y.n;
+    if ((dim != 'm' && x.m != y.m) || (dim != 'k' && x.k != y.k) || (dim != 'n' && x.n != y.n)) {
+        throw std::runtime_error(name + ": operands do not match outside the summed dimension");
+    }
+
+    // Offsets of y's blocks in the combined grid
+    int om = dim == 'm' ? x.m : 0;
+    int ok = dim == 'k' ? x.k : 0;
+    int on = dim == 'n' ? x.n : 0;
+
+    auto place = [&](const Scheme& src, int di, int dp, int dj, int r0) {
+        for (int r = 0; r < src.rank; ++r) {
+            Row u(s.m * s.k, 0.0), v(s.k * s.n, 0.0);
+            for (int i = 0; i < src.m; ++i)
+                for (int p = 0; p < src.k; ++p)
+                    u[(i + di) * s.k + (p + dp)] = src.U[r][i * src.k + p];
+            for (int p = 0; p < src.k; ++p)
+                for (int j = 0; j < src.n; ++j)
+                    v[(p + dp) * s.n + (j + dj)] = src.V[r][p * src.n + j];
+            s.U.push_back(u);
+            s.V.push_back(v);
+        }
+        for (int i = 0; i < src.m; ++i)
+            for (int j = 0; j < src.n; ++j)
+                for (int r = 0; r < src.rank; ++r)
+                    s.W[(i + di) * s.n + (j + dj)][r0 + r] = src.W[i * src.n + j][r];
+    };
+    s.W.assign(s.m * s.n, Row(s.rank, 0.0));
+    place(x, 0, 0, 0, 0);
+    place(y, om, ok, on, x.rank);
+    return s;
+}
+
+// C^T = B^T A^T: <n,k,m> with the roles of U and V swapped
+Scheme transpose(const std::string& name, const Scheme& x) {
+    Scheme s{name, x.n, x.k, x.m, x.rank, {}, {}, {}};
+    for (int r = 0; r < x.rank; ++r) {
+        Row u(s.m * s.k, 0.0), v(s.k * s.n, 0.0);
+        for (int p = 0; p < x.k; ++p)
+            for (int j = 0; j < x.n; ++j)
+                u[j * s.k + p] = x.V[r][p * x.n + j];
+        for (int i = 0; i < x.m; ++i)
+            for (int p = 0; p < x.k; ++p)
+                v[p * s.n + i] = x.U[r][i * x.k + p];
+        s.U.push_back(u);
+        s.V.push_back(v);
+    }
+    s.W.assign(s.m * s.n, Row(s.rank, 0.0));
+    for (int i = 0; i < x.m; ++i)
+        for (int j = 0; j < x.n; ++j)
+            s.W[j * s.n + i] = x.W[i * x.n + j];
+    return s;
+}
+
+// Brent equations: sum_r U[r][ip] V[r][qj] W[i'j'][r] = [p==q][i==i'][j==j']
+bool verify(const Scheme& s, std::string& error) {
+    for (int i = 0; i < s.m; ++i)
+        for (int p = 0; p < s.k; ++p)
+            for (int q = 0; q < s.k; ++q)
+                for (int j = 0; j < s.n; ++j)
+                    for (int ci = 0; ci < s.m; ++ci)
+                        for (int cj = 0; cj < s.n; ++cj) {
+                            double sum = 0.0;
+                            for (int r = 0; r < s.rank; ++r) {
+                                sum += s.U[r][i * s.k + p] * s.V[r][q * s.n + j] * s.W[ci * s.n + cj][r];
+                            }
+                            double expected = (p == q && i == ci && j == cj) ? 1.0 : 0.0;
+                            if (std::fabs(sum - expected) > 1e-12) {
+                                std::ostringstream oss;
+                                oss << "A" << i + 1 << p + 1 << " * B" << q + 1 << j + 1
+                                    << " contributes " << sum << " to C" << ci + 1 << cj + 1
+                                    << " (expected " << expected << ")";
+                                error = oss.str();
+                                return false;
+                            }
+                        }
+    return true;
+}
+
+// ---- Catalog parsing ------------------------------------------------------
+
+Table read_table(std::istream& in, int rows, int cols, const std::string& what) {
+    Table t(rows, Row(cols));
+    for (auto& row : t) {
+        for (double& value : row) {
+            if (!(in >> value)) throw std::runtime_error("short " + what + " table");
+        }
+    }
+    return t;
+}
+
+std::map<std::string, Scheme> parse_catalog(const std::string& filename, std::vector<std::string>& emit) {
+    std::ifstream file(filename);
+    if (!file) throw std::runtime_error("cannot open " + filename);
+
+    // Drop comments so tables can be read with >>
+    std::stringstream text;
+    std::string line;
+    while (std::getline(file, line)) {
+        text << line.substr(0, line.find('#')) << "\n";
+    }
+
+    std::map<std::string, Scheme> schemes;
+    auto get = [&schemes](const std::string& name) -> const Scheme& {
+        auto it = schemes.find(name);
+        if (it == schemes.end()) throw std::runtime_error("unknown scheme " + name);
+        return it->second;
+    };
+
+    std::string word;
+    while (text >> word) {
+        std::string name;
+        if (word == "emit") {
+            std::getline(text, line);
+            std::istringstream names(line);
+            while (names >> name) emit.push_back(name);
+            continue;
+        }
+        text >> name;
+        Scheme s;
+        if (word == "scheme") {
+            s.name = name;
+            text >> s.m >> s.k >> s.n >> s.rank;
+            std::string tag;
+            text >> tag;
+            s.U = read_table(text, s.rank, s.m * s.k, name + " U");
+            text >> tag;
+            s.V = read_table(text, s.rank, s.k * s.n, name + " V");
+            text >> tag;
+            s.W = read_table(text, s.m * s.n, s.rank, name + " W");
+            text >> tag;
+            if (tag != "end") throw std::runtime_error(name + ": expected 'end'");
+        } else if (word == "classical") {
+            int m, k, n;
+            text >> m >> k >> n;
+            s = classical(name, m, k, n);
+        } else if (word == "product") {
+            std::string x, y;
+            text >> x >> y;
+            s = product(name, get(x), get(y));
+        } else if (word == "sum_m" || word == "sum_k" || word == "sum_n") {
+            std::string x, y;
+            text >> x >> y;
+            s = direct_sum(name, word.back(), get(x), get(y));
+        } else if (word == "transpose") {
+            std::string x;
+            text >> x;
+            s = transpose(name, get(x));
+        } else {
+            throw std::runtime_error("unknown statement '" + word + "'");
+        }
+        if (!text) throw std::runtime_error("malformed statement for " + name);
+        if (s.m > 9 || s.k > 9 || s.n > 9) throw std::runtime_error(name + ": grids above 9 are not supported");
+
+        std::string error;
+        if (!verify(s, error)) throw std::runtime_error(name + " is not a valid scheme: " + error);
+        schemes[name] = s;
+    }
+    return schemes;
+}
+
+// ---- Common subexpression elimination -------------------------------------
+
+// Sparse linear combination: variable index -> coefficient
+using Form = std::map<int, double>;
+
+struct Temporary {
+    int x, y;       // Temporary = var x + ratio * var y
+    double ratio;
+};
+
+int additions(const std::vector<Form>& forms) {
+    int count = 0;
+    for (const auto& f : forms) count += std::max(static_cast<int>(f.size()) - 1, 0);
+    return count;
+}
+
+// Rewrite forms over inputs 0..inputs-1 to use new temporaries (numbered
+// from inputs on, each defined on earlier variables)
+std::vector<Temporary> eliminate(std::vector<Form>& forms, int inputs) {
+    std::vector<Temporary> temps;
+    while (true) {
+        std::map<std::tuple<int, int, double>, int> pairs;
+        for (const auto& f : forms) {
+            for (auto a = f.begin(); a != f.end(); ++a) {
+                for (auto b = std::next(a); b != f.end(); ++b) {
+                    pairs[std::make_tuple(a->first, b->first, b->second / a->second)]++;
+                }
+            }
+        }
+        auto best = pairs.end();
+        for (auto it = pairs.begin(); it != pairs.end(); ++it) {
+            if (it->second >= 2 && (best == pairs.end() || it->second > best->second)) best = it;
+        }
+        if (best == pairs.end()) return temps;
+
+        int x, y;
+        double ratio;
+        std::tie(x, y, ratio) = best->first;
+        int t = inputs + static_cast<int>(temps.size());
+        temps.push_back({x, y, ratio});
+        for (auto& f : forms) {
+            auto fx = f.find(x);
+            auto fy = f.find(y);
+            if (fx != f.end() && fy != f.end() && fy->second / fx->second == ratio) {
+                double coef = fx->second;
+                f.erase(x);
+                f.erase(y);
+                f[t] = coef;
+            }
+        }
+    }
+}
+
+// ---- Code generation ------------------------------------------------------
+
+std::string number(double value) {
+    std::ostringstream oss;
+    oss << value;
+    std::string s = oss.str();
+    if (s.find_first_of(".e") == std::string::npos) s += ".0";
+    return s;
+}
+
+struct Operand {
+    std::string ptr;
+    std::string ld;
+};
+
+std::string terms(const Form& form, const std::vector<Operand>& vars) {
+    std::ostringstream oss;
+    oss << "{";
+    bool first = true;
+    for (const auto& entry : form) {
+        oss << (first ? "" : ", ") << "{" << number(entry.second) << ", " << vars[entry.first].ptr
+            << ", " << vars[entry.first].ld << "}";
+        first = false;
+    }
+    oss << "}";
+    return oss.str();
+}
+
+// Emit the temporaries of one side: returns the variable table (inputs, then temps)
+std::vector<Operand> emit_temporaries(std::ostream& out, std::vector<Operand> vars,
+                                      const std::vector<Temporary>& temps, const std::string& prefix,
+                                      const std::string& rows, const std::string& cols) {
+    for (size_t t = 0; t < temps.size(); ++t) {
+        std::string name = prefix + std::to_string(t + 1);
+        Form f{{temps[t].x, 1.0}, {temps[t].y, temps[t].ratio}};
+        out << "    Temp " << name << "(" << rows << ", " << cols << ");\n";
+        out << "    combine(" << rows << ", " << cols << ", " << name << ".data, " << name << ".ld, "
+            << terms(f, vars) << ");\n";
+        vars.push_back({name + ".data", name + ".ld"});
+    }
+    return vars;
+}
+
+// Factor the leading coefficient out of a form; returns it
+double normalize(Form& form) {
+    if (form.empty()) return 1.0;
+    double lead = form.begin()->second;
+    for (auto& entry : form) entry.second /= lead;
+    return lead;
+}
+
+struct Counts {
+    int additions = 0;
+    int cse_additions = 0;
+};
+
+Counts emit_scheme(std::ostream& out, const Scheme& s) {
+    int mk = s.m * s.k, kn = s.k * s.n, mn = s.m * s.n;
+
+    // Operand forms, with leading coefficients folded into W
+    std::vector<Form> left(s.rank), right(s.rank);
+    std::vector<double> scale(s.rank, 1.0);
+    for (int r = 0; r < s.rank; ++r) {
+        for (int v = 0; v < mk; ++v) if (s.U[r][v] != 0.0) left[r][v] = s.U[r][v];
+        for (int v = 0; v < kn; ++v) if (s.V[r][v] != 0.0) right[r][v] = s.V[r][v];
+        scale[r] = normalize(left[r]) * normalize(right[r]);
+    }
+    std::vector<Form> outputs(mn);
+    for (int c = 0; c < mn; ++c) {
+        for (int r = 0; r < s.rank; ++r) {
+            if (s.W[c][r] != 0.0) outputs[c][r] = s.W[c][r] * scale[r];
+        }
+    }
+
+    Counts counts;
+    counts.additions = additions(left) + additions(right) + additions(outputs);
+    std::vector<Temporary> left_temps = eliminate(left, mk);
+    std::vector<Temporary> right_temps = eliminate(right, kn);
+    std::vector<Temporary> output_temps = eliminate(outputs, s.rank);
+    counts.cse_additions = static_cast<int>(left_temps.size() + right_temps.size() + output_temps.size()) +
+                           additions(left) + additions(right) + additions(outputs);
+
+    std::string step = s.name + "_step";
+    out << "// <" << s.m << "," << s.k << "," << s.n << ";" << s.rank << ">: "
+        << counts.additions << " block additions, " << counts.cse_additions << " after CSE\n";
+    out << "static void " << step << "(const double* A, int lda, const double* B, int ldb, double* C, int ldc,\n"
+        << "    int m, int k, int n, int levels) {\n";
+    out << "    if (levels == 0) {\n"
+        << "        leaf_gemm(m, k, n, A, lda, B, ldb, C, ldc);\n"
+        << "        return;\n"
+        << "    }\n";
+    out << "    const int mb = m / " << s.m << ", kb = k / " << s.k << ", nb = n / " << s.n << ";\n\n";
+
+    std::vector<Operand> a_vars, b_vars, m_vars;
+    for (int i = 0; i < s.m; ++i) {
+        for (int p = 0; p < s.k; ++p) {
+            std::string name = "A" + std::to_string(i + 1) + std::to_string(p + 1);
+            out << "    const double* " << name << " = A + " << i << " * mb * lda + " << p << " * kb;\n";
+            a_vars.push_back({name, "lda"});
+        }
+    }
+    for (int p = 0; p < s.k; ++p) {
+        for (int j = 0; j < s.n; ++j) {
+            std::string name = "B" + std::to_string(p + 1) + std::to_string(j + 1);
+            out << "    const double* " << name << " = B + " << p << " * kb * ldb + " << j << " * nb;\n";
+            b_vars.push_back({name, "ldb"});
+        }
+    }
+    out << "\n    // Sums shared between products\n";
+    a_vars = emit_temporaries(out, a_vars, left_temps, "SA", "mb", "kb");
+    b_vars = emit_temporaries(out, b_vars, right_temps, "SB", "kb", "nb");
+
+    out << "\n    // Block products\n";
+    for (int r = 0; r < s.rank; ++r) {
+        std::string name = "M" + std::to_string(r + 1);
+        out << "    Temp " << name << "(mb, nb);\n";
+        out << "    {\n";
+        auto operand = [&out](const Form& f, const std::vector<Operand>& vars, const std::string& tag,
+                              const std::string& rows, const std::string& cols) -> Operand {
+            if (f.size() == 1 && f.begin()->second == 1.0) return vars[f.begin()->first];
+            out << "        Temp " << tag << "(" << rows << ", " << cols << ");\n";
+            out << "        combine(" << rows << ", " << cols << ", " << tag << ".data, " << tag << ".ld, "
+                << terms(f, vars) << ");\n";
+            return {tag + ".data", tag + ".ld"};
+        };
+        Operand a = operand(left[r], a_vars, "S", "mb", "kb");
+        Operand b = operand(right[r], b_vars, "T", "kb", "nb");
+        out << "        " << step << "(" << a.ptr << ", " << a.ld << ", " << b.ptr << ", " << b.ld
+            << ", " << name << ".data, " << name << ".ld, mb, kb, nb, levels - 1);\n";
+        out << "    }\n";
+        m_vars.push_back({name + ".data", name + ".ld"});
+    }
+
+    out << "\n    // Result blocks\n";
+    m_vars = emit_temporaries(out, m_vars, output_temps, "SM", "mb", "nb");
+    for (int i = 0; i < s.m; ++i) {
+        for (int j = 0; j < s.n; ++j) {
+            out << "    combine(mb, nb, C + " << i << " * mb * ldc + " << j << " * nb, ldc, "
+                << terms(outputs[i * s.n + j], m_vars) << ");\n";
+        }
+    }
+    out << "}\n\n";
+    return counts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <catalog> <output.cpp>\n";
+        return 1;
+    }
+
+    try {
+        std::vector<std::string> emit;
+        std::map<std::string, Scheme> schemes = parse_catalog(argv[1], emit);
+
+        std::ostringstream body;
+        std::ostringstream table;
+        for (const std::string& name : emit) {
+            auto it = schemes.find(name);
+            if (it == schemes.end()) throw std::runtime_error("emit: unknown scheme " + name);
+            const Scheme& s = it->second;
+            Counts counts = emit_scheme(body, s);
+            table << "    {\"" << s.name << "\", " << s.m << ", " << s.k << ", " << s.n << ", " << s.rank
+                  << ", " << counts.additions << ", " << counts.cse_additions << ", " << s.name << "_step},\n";
+        }
+
+        std::ofstream out(argv[2]);
+        out << "// Generated by tools/bilinear_gen from " << argv[1] << "; do not edit.\n\n"
+            << "#include \"bilinear.hpp\"\n\n"
+            << "namespace matmul {\n"
+            << "namespace bilinear {\n"
+            << "namespace detail {\n\n"
+            << body.str()
+            << "const GeneratedScheme generated_schemes[] = {\n" << table.str() << "};\n\n"
+            << "const int generated_scheme_count = " << emit.size() << ";\n\n"
+            << "} // namespace detail\n"
+            << "} // namespace bilinear\n"
+            << "} // namespace matmul\n";
+        if (!out) throw std::runtime_error(std::string("cannot write ") + argv[2]);
+    } catch (const std::exception& e) {
+        std::cerr << "bilinear_gen: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}